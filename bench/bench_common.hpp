@@ -0,0 +1,78 @@
+#pragma once
+
+#include "simdsp/dispatch.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+/*
+ * Helpers shared by the benchmarks.
+ */
+
+/*
+ * The sample rate "realtime voices" are measured against.
+ */
+static const double REALTIME_SAMPLE_RATE = 48000.0;
+
+/*
+ * Report samples/second (items_per_second), time per sample, and how many instances of whatever is being benchmarked
+ * one core could run in realtime at REALTIME_SAMPLE_RATE, given that each iteration handles frames frames of channels
+ * channels.
+ *
+ * time_per_sample is in seconds, which the console shows with an SI prefix (e.g. 2.1ns).
+ */
+inline void setRealtimeCounters(benchmark::State &state, unsigned int frames, unsigned int channels) {
+  double samples = (double)frames * channels;
+  state.SetItemsProcessed(state.iterations() * (int64_t)frames * channels);
+  state.counters["time_per_sample"] =
+      benchmark::Counter(samples, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+  state.counters["realtime_voices"] =
+      benchmark::Counter((double)frames / REALTIME_SAMPLE_RATE, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/*
+ * The dispatch variants this machine can run, narrowest first.
+ */
+inline std::vector<simdsp::DispatchVariant> getRunnableDispatchVariants() {
+  std::vector<simdsp::DispatchVariant> ret;
+  for (auto variant : {simdsp::DispatchVariant::GENERIC, simdsp::DispatchVariant::X86_SSE2,
+                       simdsp::DispatchVariant::X86_AVX, simdsp::DispatchVariant::X86_AVX2,
+                       simdsp::DispatchVariant::X86_AVX512F, simdsp::DispatchVariant::AARCH64_NEON,
+                       simdsp::DispatchVariant::AARCH64_SVE}) {
+    if (simdsp::isDispatchVariantRunnable(variant)) {
+      ret.push_back(variant);
+    }
+  }
+  return ret;
+}
+
+/*
+ * Uniform noise in [-1, 1], so that nothing is benchmarked on zeros (or denormals).
+ */
+inline std::vector<float> makeNoise(size_t len, unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> ret(len);
+  for (auto &x : ret) {
+    x = dist(rng);
+  }
+  return ret;
+}
+
+/*
+ * Noise with an exponential decay to -60 dB over the impulse, interleaved with the given number of channels.  Roughly
+ * what a reverb tail looks like, and keeps the output bounded.
+ */
+inline std::vector<float> makeImpulse(unsigned int impulse_len, unsigned int channels) {
+  std::vector<float> ret = makeNoise((size_t)impulse_len * channels, impulse_len);
+  for (unsigned int i = 0; i < impulse_len; i++) {
+    float gain = (float)exp(-6.9 * (double)i / (double)impulse_len) / sqrtf((float)impulse_len);
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      ret[(size_t)i * channels + ch] *= gain;
+    }
+  }
+  return ret;
+}
@@ -0,0 +1,73 @@
+#include "bench_common.hpp"
+
+#include "simdsp/filters/biquad_filter_bank.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+/*
+ * Biquad banks over lane counts from one mono filter (which can't vectorize, and is the baseline for what a serial
+ * implementation costs per lane) to a mixer's worth of voices.  Names look like
+ * biquad_bank/x86_avx2/lanes:64/sections:4/interpolating:1.
+ */
+
+static const unsigned int BIQUAD_BLOCK_SIZE = 256;
+static const unsigned int LANE_COUNTS[] = {1, 2, 8, 16, 64, 256};
+static const unsigned int SECTION_COUNTS[] = {1, 4};
+
+static void runBiquadBenchmark(benchmark::State &state, simdsp::DispatchVariant variant, unsigned int lanes,
+                               unsigned int sections, bool interpolating) {
+  simdsp::forceDispatchVariant(variant);
+
+  simdsp::BiquadFilterBank bank(lanes, sections);
+  // Two designs to alternate between, so that interpolating blocks always have somewhere to go.
+  simdsp::BiquadCoefficients designs[2] = {
+      simdsp::designBiquad(simdsp::BiquadType::LOWPASS, REALTIME_SAMPLE_RATE, 2000.0, 0.707),
+      simdsp::designBiquad(simdsp::BiquadType::LOWPASS, REALTIME_SAMPLE_RATE, 3000.0, 0.707),
+  };
+  for (unsigned int lane = 0; lane < lanes; lane++) {
+    for (unsigned int s = 0; s < sections; s++) {
+      bank.setCoefficients(lane, s, designs[0], false);
+    }
+  }
+
+  std::vector<float> input = makeNoise((size_t)BIQUAD_BLOCK_SIZE * lanes, lanes), output(input.size());
+  unsigned int which = 0;
+  for (auto _ : state) {
+    if (interpolating) {
+      which ^= 1;
+      for (unsigned int lane = 0; lane < lanes; lane++) {
+        for (unsigned int s = 0; s < sections; s++) {
+          bank.setCoefficients(lane, s, designs[which]);
+        }
+      }
+    }
+    bank.process(&input[0], &output[0], BIQUAD_BLOCK_SIZE);
+    benchmark::ClobberMemory();
+  }
+
+  setRealtimeCounters(state, BIQUAD_BLOCK_SIZE, lanes);
+  simdsp::resetDispatchVariant();
+}
+
+static bool registerBiquadBenchmarks() {
+  for (auto variant : getRunnableDispatchVariants()) {
+    for (unsigned int lanes : LANE_COUNTS) {
+      for (unsigned int sections : SECTION_COUNTS) {
+        for (bool interpolating : {false, true}) {
+          std::string name = std::string("biquad_bank/") + simdsp::dispatchVariantToString(variant) +
+                             "/lanes:" + std::to_string(lanes) + "/sections:" + std::to_string(sections) +
+                             "/interpolating:" + std::to_string((int)interpolating);
+          benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+            runBiquadBenchmark(state, variant, lanes, sections, interpolating);
+          });
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static bool biquad_benchmarks_registered = registerBiquadBenchmarks();
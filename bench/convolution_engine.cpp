@@ -1,15 +1,154 @@
+#include "bench_common.hpp"
+
+#include "simdsp/convolution/convolution_worker.hpp"
 #include "simdsp/convolution/generic_block_convolution.hpp"
+#include "simdsp/convolution/non_uniform_partitioned_convolution.hpp"
+#include "simdsp/convolution/streaming_convolution.hpp"
+#include "simdsp/convolution/tiled_block_convolution.hpp"
+#include "simdsp/convolution/uniform_partitioned_convolution.hpp"
 
 #include <benchmark/benchmark.h>
 
-static void bm_genericBlockConvolver(benchmark::State &state) {
-  alignas(64) float input_array[32] = {0.0};
-  alignas(64) float impulse[16] = {0.0};
-  alignas(16) float output[17];
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * The convolution benchmark matrix: every engine over a range of impulse lengths, block sizes, channel counts, and
+ * every dispatch variant the machine can run.  Names look like
+ * uniform/x86_avx2/impulse_len:48000/block_size:256/channels:2, so use --benchmark_filter to pick out a slice.
+ *
+ * Each engine only gets the impulse lengths it's actually meant for; running direct convolution over 192k taps tells
+ * us nothing except that it's slow.
+ */
+
+static const unsigned int BLOCK_SIZES[] = {32, 128, 512, 2048};
+static const unsigned int CHANNEL_COUNTS[] = {1, 2, 4, 8};
+
+struct ConvolutionShape {
+  unsigned int impulse_len, block_size, channels;
+};
+
+/*
+ * Given the shape and an interleaved impulse, build an engine and return a function which runs one block through it.
+ */
+using EngineFactory = std::function<std::function<void(const float *, float *)>(ConvolutionShape, const float *)>;
+
+static void runConvolutionBenchmark(benchmark::State &state, simdsp::DispatchVariant variant, ConvolutionShape shape,
+                                    const EngineFactory &factory) {
+  simdsp::forceDispatchVariant(variant);
+
+  std::vector<float> impulse = makeImpulse(shape.impulse_len, shape.channels);
+  std::vector<float> input = makeNoise((size_t)shape.block_size * shape.channels, shape.block_size);
+  std::vector<float> output(input.size(), 0.0f);
+  auto process = factory(shape, &impulse[0]);
 
   for (auto _ : state) {
-    simdsp::genericBlockConvolver(input_array + 15, 32 - 15, 1, impulse, 16, output);
+    process(&input[0], &output[0]);
+    benchmark::ClobberMemory();
+  }
+
+  setRealtimeCounters(state, shape.block_size, shape.channels);
+  simdsp::resetDispatchVariant();
+}
+
+static void registerMatrix(const char *engine, std::vector<unsigned int> impulse_lens,
+                           std::vector<simdsp::DispatchVariant> variants, EngineFactory factory) {
+  for (auto variant : variants) {
+    for (unsigned int impulse_len : impulse_lens) {
+      for (unsigned int block_size : BLOCK_SIZES) {
+        for (unsigned int channels : CHANNEL_COUNTS) {
+          std::string name = std::string(engine) + "/" + simdsp::dispatchVariantToString(variant) +
+                             "/impulse_len:" + std::to_string(impulse_len) +
+                             "/block_size:" + std::to_string(block_size) + "/channels:" + std::to_string(channels);
+          ConvolutionShape shape{impulse_len, block_size, channels};
+          benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+            runConvolutionBenchmark(state, variant, shape, factory);
+          });
+        }
+      }
+    }
   }
 }
 
-BENCHMARK(bm_genericBlockConvolver);
+/*
+ * Input history for the raw direct kernels.  The contents never change, which doesn't matter for timing.
+ */
+struct DirectEngine {
+  DirectEngine(ConvolutionShape _shape, const float *impulse)
+      : shape(_shape), history(makeNoise((size_t)(shape.impulse_len - 1 + shape.block_size) * shape.channels, 1)),
+        reversed(impulse, impulse + (size_t)shape.impulse_len * shape.channels) {}
+
+  float *current() { return &history[(size_t)(shape.impulse_len - 1) * shape.channels]; }
+
+  ConvolutionShape shape;
+  std::vector<float> history, reversed;
+};
+
+/*
+ * The convolver must go before the worker it's attached to, which member order guarantees.
+ */
+struct WorkerEngine {
+  simdsp::ConvolutionWorker worker;
+  std::unique_ptr<simdsp::NonUniformPartitionedConvolver> conv;
+};
+
+static bool registerConvolutionBenchmarks() {
+  auto variants = getRunnableDispatchVariants();
+
+  registerMatrix("streaming", {16, 64, 256, 1024}, variants, [](ConvolutionShape shape, const float *impulse) {
+    auto conv = std::make_shared<simdsp::StreamingConvolver>(shape.channels, impulse, shape.impulse_len,
+                                                             shape.block_size);
+    unsigned int frames = shape.block_size;
+    return [conv, frames](const float *input, float *output) { conv->process(input, frames, output); };
+  });
+
+  // The raw kernels, over the range where the tiled one should overtake the generic one.  The impulse isn't reversed,
+  // which doesn't matter for timing.
+  registerMatrix("direct_generic", {256, 1024, 2048, 4096, 8192}, variants,
+                 [](ConvolutionShape shape, const float *impulse) {
+                   auto engine = std::make_shared<DirectEngine>(shape, impulse);
+                   return [engine](const float *, float *output) {
+                     simdsp::genericBlockConvolver(engine->current(), engine->shape.block_size, engine->shape.channels,
+                                                   &engine->reversed[0], engine->shape.impulse_len, output);
+                   };
+                 });
+
+  registerMatrix("direct_tiled", {256, 1024, 2048, 4096, 8192}, variants,
+                 [](ConvolutionShape shape, const float *impulse) {
+                   auto engine = std::make_shared<DirectEngine>(shape, impulse);
+                   return [engine](const float *, float *output) {
+                     simdsp::tiledBlockConvolver(engine->current(), engine->shape.block_size, engine->shape.channels,
+                                                 &engine->reversed[0], engine->shape.impulse_len, output);
+                   };
+                 });
+
+  registerMatrix("uniform", {256, 1024, 4096, 16384, 48000, 192000}, variants,
+                 [](ConvolutionShape shape, const float *impulse) {
+                   auto conv = std::make_shared<simdsp::UniformPartitionedConvolver>(shape.block_size, shape.channels,
+                                                                                     impulse, shape.impulse_len);
+                   return [conv](const float *input, float *output) { conv->process(input, output); };
+                 });
+
+  registerMatrix("non_uniform", {1024, 4096, 16384, 48000, 192000}, variants,
+                 [](ConvolutionShape shape, const float *impulse) {
+                   auto conv = std::make_shared<simdsp::NonUniformPartitionedConvolver>(
+                       shape.block_size, shape.channels, impulse, shape.impulse_len);
+                   return [conv](const float *input, float *output) { conv->process(input, output); };
+                 });
+
+  // Only the audio thread's side is measured; the worker's time isn't counted.  The variant matters much less here
+  // than the worker keeping up, so only the automatic choice is run.
+  registerMatrix("non_uniform_worker", {48000, 192000}, {simdsp::getDispatchVariant()},
+                 [](ConvolutionShape shape, const float *impulse) {
+                   auto engine = std::make_shared<WorkerEngine>();
+                   engine->conv = std::make_unique<simdsp::NonUniformPartitionedConvolver>(
+                       shape.block_size, shape.channels, impulse, shape.impulse_len, 0, &engine->worker);
+                   return [engine](const float *input, float *output) { engine->conv->process(input, output); };
+                 });
+
+  return true;
+}
+
+static bool convolution_benchmarks_registered = registerConvolutionBenchmarks();
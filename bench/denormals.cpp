@@ -0,0 +1,117 @@
+#include "bench_common.hpp"
+
+#include "simdsp/convolution/streaming_convolution.hpp"
+#include "simdsp/denormals.hpp"
+#include "simdsp/filters/biquad_filter_bank.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <math.h>
+#include <string>
+#include <vector>
+
+/*
+ * The cost of denormals, and of not having them: a filter bank and a convolver fed the tail of a sound as it decays
+ * from just above the denormal range to well inside it, with and without a DenormalGuard.  Every block is the same
+ * tail, so that the filter state stays down there too.  Names look like
+ * denormals/x86_avx2/workload:convolution/flush:1.
+ */
+
+static const unsigned int TAIL_BLOCK_SIZE = 256;
+static const unsigned int TAIL_CHANNELS = 2;
+static const unsigned int TAIL_IMPULSE_LEN = 256;
+static const unsigned int TAIL_BIQUAD_SECTIONS = 4;
+
+enum class TailWorkload {
+  BIQUAD,
+  CONVOLUTION,
+};
+
+static const char *getWorkloadName(TailWorkload workload) {
+  switch (workload) {
+  case TailWorkload::BIQUAD:
+    return "biquad";
+  case TailWorkload::CONVOLUTION:
+    return "convolution";
+  }
+  return "unknown";
+}
+
+/*
+ * Noise under an exponential decay from 1e-36 to about 1e-42, crossing into denormals (below about 1.2e-38) a third of
+ * the way through.
+ */
+static std::vector<float> makeDecayingTail() {
+  std::vector<float> ret = makeNoise((size_t)TAIL_BLOCK_SIZE * TAIL_CHANNELS, 0);
+  for (unsigned int i = 0; i < TAIL_BLOCK_SIZE; i++) {
+    float envelope = 1e-36f * expf(-(float)i * 0.05f);
+    for (unsigned int ch = 0; ch < TAIL_CHANNELS; ch++) {
+      ret[i * TAIL_CHANNELS + ch] *= envelope;
+    }
+  }
+  return ret;
+}
+
+static void runDenormalBenchmark(benchmark::State &state, simdsp::DispatchVariant variant, TailWorkload workload,
+                                 bool flush) {
+  simdsp::forceDispatchVariant(variant);
+
+  std::vector<float> input = makeDecayingTail(), output(input.size());
+
+  simdsp::BiquadFilterBank bank(TAIL_CHANNELS, TAIL_BIQUAD_SECTIONS);
+  simdsp::BiquadCoefficients lowpass =
+      simdsp::designBiquad(simdsp::BiquadType::LOWPASS, REALTIME_SAMPLE_RATE, 1000.0, 0.707);
+  for (unsigned int lane = 0; lane < TAIL_CHANNELS; lane++) {
+    for (unsigned int s = 0; s < TAIL_BIQUAD_SECTIONS; s++) {
+      bank.setCoefficients(lane, s, lowpass, false);
+    }
+  }
+
+  // A room: noise decaying by 60 dB over the impulse.
+  std::vector<float> impulse = makeNoise((size_t)TAIL_IMPULSE_LEN * TAIL_CHANNELS, 1);
+  for (unsigned int i = 0; i < TAIL_IMPULSE_LEN; i++) {
+    float envelope = expf(-6.9f * (float)i / TAIL_IMPULSE_LEN);
+    for (unsigned int ch = 0; ch < TAIL_CHANNELS; ch++) {
+      impulse[i * TAIL_CHANNELS + ch] *= envelope;
+    }
+  }
+  simdsp::StreamingConvolver convolver(TAIL_CHANNELS, &impulse[0], TAIL_IMPULSE_LEN, TAIL_BLOCK_SIZE);
+
+  auto run = [&]() {
+    if (workload == TailWorkload::BIQUAD) {
+      bank.process(&input[0], &output[0], TAIL_BLOCK_SIZE);
+    } else {
+      convolver.process(&input[0], TAIL_BLOCK_SIZE, &output[0], simdsp::OutputMode{false});
+    }
+  };
+
+  for (auto _ : state) {
+    if (flush) {
+      simdsp::DenormalGuard guard;
+      run();
+    } else {
+      run();
+    }
+    benchmark::ClobberMemory();
+  }
+
+  setRealtimeCounters(state, TAIL_BLOCK_SIZE, TAIL_CHANNELS);
+  simdsp::resetDispatchVariant();
+}
+
+static bool registerDenormalBenchmarks() {
+  for (auto variant : getRunnableDispatchVariants()) {
+    for (TailWorkload workload : {TailWorkload::BIQUAD, TailWorkload::CONVOLUTION}) {
+      for (bool flush : {false, true}) {
+        std::string name = std::string("denormals/") + simdsp::dispatchVariantToString(variant) +
+                           "/workload:" + getWorkloadName(workload) + "/flush:" + std::to_string((int)flush);
+        benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+          runDenormalBenchmark(state, variant, workload, flush);
+        });
+      }
+    }
+  }
+  return true;
+}
+
+static bool denormal_benchmarks_registered = registerDenormalBenchmarks();
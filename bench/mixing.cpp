@@ -0,0 +1,129 @@
+#include "bench_common.hpp"
+
+#include "simdsp/mixing/mixing.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+/*
+ * The mixing kernels over the channel counts a bus sees.  Counters are per frame of input.  Names look like
+ * mixing/x86_avx2/op:gain_ramp_add/channels:2, or mixing/x86_avx2/op:matrix_ramp/shape:2x6 for matrices.
+ */
+
+static const unsigned int MIXING_BLOCK_SIZE = 512;
+static const unsigned int CHANNEL_COUNTS[] = {1, 2, 6, 8};
+
+struct MatrixShape {
+  unsigned int input_channels, output_channels;
+};
+
+static const MatrixShape MATRIX_SHAPES[] = {{1, 2}, {2, 2}, {2, 6}, {8, 2}};
+
+enum class MixingOp {
+  GAIN_RAMP_ADD,
+  INTERLEAVE,
+  DEINTERLEAVE,
+};
+
+static const char *getOpName(MixingOp op) {
+  switch (op) {
+  case MixingOp::GAIN_RAMP_ADD:
+    return "gain_ramp_add";
+  case MixingOp::INTERLEAVE:
+    return "interleave";
+  case MixingOp::DEINTERLEAVE:
+    return "deinterleave";
+  }
+  return "unknown";
+}
+
+static void runMixingBenchmark(benchmark::State &state, simdsp::DispatchVariant variant, MixingOp op,
+                               unsigned int channels) {
+  simdsp::forceDispatchVariant(variant);
+
+  std::vector<float> input = makeNoise((size_t)MIXING_BLOCK_SIZE * channels, channels), output(input.size());
+  std::vector<std::vector<float>> planar(channels, std::vector<float>(MIXING_BLOCK_SIZE));
+  std::vector<const float *> sources;
+  std::vector<float *> destinations;
+  for (auto &p : planar) {
+    sources.push_back(p.data());
+    destinations.push_back(p.data());
+  }
+
+  bool up = false;
+  for (auto _ : state) {
+    switch (op) {
+    case MixingOp::GAIN_RAMP_ADD:
+      up = !up;
+      simdsp::mixGainRamp(&input[0], &output[0], MIXING_BLOCK_SIZE, channels, up ? 0.5f : 1.0f, up ? 1.0f : 0.5f,
+                          true);
+      break;
+    case MixingOp::INTERLEAVE:
+      simdsp::interleaveChannels(sources.data(), channels, MIXING_BLOCK_SIZE, &output[0]);
+      break;
+    case MixingOp::DEINTERLEAVE:
+      simdsp::deinterleaveChannels(&input[0], channels, MIXING_BLOCK_SIZE, destinations.data());
+      break;
+    }
+    benchmark::ClobberMemory();
+  }
+
+  setRealtimeCounters(state, MIXING_BLOCK_SIZE, channels);
+  simdsp::resetDispatchVariant();
+}
+
+static void runMatrixBenchmark(benchmark::State &state, simdsp::DispatchVariant variant, MatrixShape shape,
+                               bool ramp) {
+  simdsp::forceDispatchVariant(variant);
+
+  std::vector<float> input = makeNoise((size_t)MIXING_BLOCK_SIZE * shape.input_channels, shape.input_channels);
+  std::vector<float> output((size_t)MIXING_BLOCK_SIZE * shape.output_channels);
+  std::vector<float> from = makeNoise(shape.input_channels * shape.output_channels, 1);
+  std::vector<float> to = makeNoise(shape.input_channels * shape.output_channels, 2);
+
+  for (auto _ : state) {
+    if (ramp) {
+      simdsp::mixMatrixRamp(&input[0], shape.input_channels, &output[0], shape.output_channels, MIXING_BLOCK_SIZE,
+                            &from[0], &to[0], true);
+      from.swap(to);
+    } else {
+      simdsp::mixMatrix(&input[0], shape.input_channels, &output[0], shape.output_channels, MIXING_BLOCK_SIZE,
+                        &from[0], true);
+    }
+    benchmark::ClobberMemory();
+  }
+
+  setRealtimeCounters(state, MIXING_BLOCK_SIZE, shape.input_channels);
+  simdsp::resetDispatchVariant();
+}
+
+static bool registerMixingBenchmarks() {
+  for (auto variant : getRunnableDispatchVariants()) {
+    std::string prefix = std::string("mixing/") + simdsp::dispatchVariantToString(variant);
+
+    for (MixingOp op : {MixingOp::GAIN_RAMP_ADD, MixingOp::INTERLEAVE, MixingOp::DEINTERLEAVE}) {
+      for (unsigned int channels : CHANNEL_COUNTS) {
+        std::string name = prefix + "/op:" + getOpName(op) + "/channels:" + std::to_string(channels);
+        benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+          runMixingBenchmark(state, variant, op, channels);
+        });
+      }
+    }
+
+    for (const MatrixShape &shape : MATRIX_SHAPES) {
+      for (bool ramp : {false, true}) {
+        std::string name = prefix + "/op:" + (ramp ? "matrix_ramp_add" : "matrix_add") +
+                           "/shape:" + std::to_string(shape.input_channels) + "x" +
+                           std::to_string(shape.output_channels);
+        benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+          runMatrixBenchmark(state, variant, shape, ramp);
+        });
+      }
+    }
+  }
+  return true;
+}
+
+static bool mixing_benchmarks_registered = registerMixingBenchmarks();
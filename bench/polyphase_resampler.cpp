@@ -0,0 +1,74 @@
+#include "bench_common.hpp"
+
+#include "simdsp/resampling/polyphase_resampler.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+/*
+ * Polyphase resampling at the usual rate pairs, plus a variable resampler, whose phases are interpolated per output
+ * frame.  Counters are per input frame.  Names look like resampler/x86_avx2/channels:2/conversion:44100_48000/taps:32.
+ */
+
+static const unsigned int RESAMPLER_BLOCK_SIZE = 512;
+
+struct Conversion {
+  const char *name;
+  unsigned int input_rate, output_rate;
+  bool variable;
+};
+
+static const Conversion CONVERSIONS[] = {
+    {"44100_48000", 44100, 48000, false},
+    {"48000_44100", 48000, 44100, false},
+    {"variable", 48000, 48000, true},
+};
+
+static const simdsp::ResamplerQuality QUALITIES[] = {simdsp::ResamplerQuality::LOW, simdsp::ResamplerQuality::MEDIUM,
+                                                     simdsp::ResamplerQuality::HIGH};
+
+static void runResamplerBenchmark(benchmark::State &state, simdsp::DispatchVariant variant, unsigned int channels,
+                                  Conversion conversion, simdsp::ResamplerQuality quality) {
+  simdsp::forceDispatchVariant(variant);
+
+  simdsp::PolyphaseResampler resampler(channels, conversion.input_rate, conversion.output_rate, quality,
+                                       conversion.variable);
+  if (conversion.variable) {
+    // Drift correction territory: close to 1, but not on a phase.
+    resampler.setRatio(1.0013);
+  }
+
+  std::vector<float> input = makeNoise((size_t)RESAMPLER_BLOCK_SIZE * channels, channels);
+  // Room for more than one block's worth, since the bound depends on what's buffered.
+  std::vector<float> output((size_t)resampler.getMaxOutputFrames(RESAMPLER_BLOCK_SIZE * 2) * channels);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(resampler.process(&input[0], RESAMPLER_BLOCK_SIZE, &output[0]));
+    benchmark::ClobberMemory();
+  }
+
+  setRealtimeCounters(state, RESAMPLER_BLOCK_SIZE, channels);
+  simdsp::resetDispatchVariant();
+}
+
+static bool registerResamplerBenchmarks() {
+  for (auto variant : getRunnableDispatchVariants()) {
+    for (unsigned int channels : {1u, 2u}) {
+      for (const Conversion &conversion : CONVERSIONS) {
+        for (auto quality : QUALITIES) {
+          unsigned int taps = 16u << (unsigned int)quality;
+          std::string name = std::string("resampler/") + simdsp::dispatchVariantToString(variant) +
+                             "/channels:" + std::to_string(channels) + "/conversion:" + conversion.name +
+                             "/taps:" + std::to_string(taps);
+          benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+            runResamplerBenchmark(state, variant, channels, conversion, quality);
+          });
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static bool resampler_benchmarks_registered = registerResamplerBenchmarks();
@@ -0,0 +1,105 @@
+#include "bench_common.hpp"
+
+#include "simdsp/mixing/sample_format.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+/*
+ * The sample format conversions at a device boundary: planar float to interleaved integers and back.  Counters are per
+ * sample.  Names look like sample_format/x86_avx2/format:int24/op:encode_dither/channels:2.
+ */
+
+static const unsigned int CONVERSION_BLOCK_SIZE = 512;
+static const unsigned int CHANNEL_COUNTS[] = {1, 2, 6, 8};
+
+enum class ConversionOp {
+  ENCODE,
+  ENCODE_DITHER,
+  DECODE,
+};
+
+static const char *getOpName(ConversionOp op) {
+  switch (op) {
+  case ConversionOp::ENCODE:
+    return "encode";
+  case ConversionOp::ENCODE_DITHER:
+    return "encode_dither";
+  case ConversionOp::DECODE:
+    return "decode";
+  }
+  return "unknown";
+}
+
+static const char *getFormatName(simdsp::SampleFormat format) {
+  switch (format) {
+  case simdsp::SampleFormat::INT16:
+    return "int16";
+  case simdsp::SampleFormat::INT24_PACKED:
+    return "int24";
+  case simdsp::SampleFormat::INT32:
+    return "int32";
+  }
+  return "unknown";
+}
+
+static void runConversionBenchmark(benchmark::State &state, simdsp::DispatchVariant variant,
+                                   simdsp::SampleFormat format, ConversionOp op, unsigned int channels) {
+  simdsp::forceDispatchVariant(variant);
+
+  std::vector<std::vector<float>> planar;
+  std::vector<const float *> sources;
+  std::vector<float *> destinations;
+  for (unsigned int ch = 0; ch < channels; ch++) {
+    planar.push_back(makeNoise(CONVERSION_BLOCK_SIZE, ch));
+    sources.push_back(planar.back().data());
+    destinations.push_back(planar.back().data());
+  }
+  std::vector<unsigned char> interleaved((size_t)CONVERSION_BLOCK_SIZE * channels *
+                                         simdsp::getSampleFormatBytes(format));
+  simdsp::interleaveFloatToSamples(sources.data(), channels, CONVERSION_BLOCK_SIZE, format, interleaved.data());
+  simdsp::SampleDither dither;
+
+  for (auto _ : state) {
+    switch (op) {
+    case ConversionOp::ENCODE:
+      simdsp::interleaveFloatToSamples(sources.data(), channels, CONVERSION_BLOCK_SIZE, format, interleaved.data());
+      break;
+    case ConversionOp::ENCODE_DITHER:
+      simdsp::interleaveFloatToSamples(sources.data(), channels, CONVERSION_BLOCK_SIZE, format, interleaved.data(),
+                                       &dither);
+      break;
+    case ConversionOp::DECODE:
+      simdsp::deinterleaveSamplesToFloat(interleaved.data(), channels, CONVERSION_BLOCK_SIZE, format,
+                                         destinations.data());
+      break;
+    }
+    benchmark::ClobberMemory();
+  }
+
+  setRealtimeCounters(state, CONVERSION_BLOCK_SIZE, channels);
+  simdsp::resetDispatchVariant();
+}
+
+static bool registerSampleFormatBenchmarks() {
+  for (auto variant : getRunnableDispatchVariants()) {
+    for (auto format : {simdsp::SampleFormat::INT16, simdsp::SampleFormat::INT24_PACKED, simdsp::SampleFormat::INT32}) {
+      std::string prefix = std::string("sample_format/") + simdsp::dispatchVariantToString(variant) +
+                           "/format:" + getFormatName(format);
+
+      for (ConversionOp op : {ConversionOp::ENCODE, ConversionOp::ENCODE_DITHER, ConversionOp::DECODE}) {
+        for (unsigned int channels : CHANNEL_COUNTS) {
+          std::string name = prefix + "/op:" + getOpName(op) + "/channels:" + std::to_string(channels);
+          benchmark::RegisterBenchmark(name.c_str(), [=](benchmark::State &state) {
+            runConversionBenchmark(state, variant, format, op, channels);
+          });
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static bool sample_format_benchmarks_registered = registerSampleFormatBenchmarks();
@@ -1,7 +1,26 @@
 #include "simdsp/system_info.hpp"
 
+#include "simdsp/dispatch.hpp"
+
 #include <benchmark/benchmark.h>
 
+#include <stdlib.h>
+
+/*
+ * Put the machine description in the context of every run, so that results from different machines can be compared.
+ */
+static bool registerSystemInfoContext() {
+  simdsp::SystemInfo info = simdsp::getSystemInfo();
+  char *json = simdsp::convertSystemInfoToJson(&info);
+  benchmark::AddCustomContext("simdsp_system_info", json);
+  free(json);
+
+  benchmark::AddCustomContext("simdsp_dispatch_variant", simdsp::dispatchVariantToString(simdsp::getDispatchVariant()));
+  return true;
+}
+
+static bool system_info_context_registered = registerSystemInfoContext();
+
 static void bm_getSystemInfo(benchmark::State &state) {
   for (auto _ : state) {
     benchmark::DoNotOptimize(simdsp::getSystemInfo());
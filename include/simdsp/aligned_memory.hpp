@@ -0,0 +1,179 @@
+#pragma once
+
+#include <new>
+#include <stddef.h>
+#include <utility>
+
+namespace simdsp {
+
+/**
+ * The simdsp alignment convention.
+ *
+ * A buffer follows the convention if:
+ *
+ * - It starts on a getSimdAlignment() boundary.
+ * - Its length is padded up to a multiple of getSimdAlignment() bytes, and the padding may be read (and, for buffers
+ *   simdsp owns, written) by kernels.  Padding is zero when the buffer is allocated.
+ *
+ * Kernels which are handed such buffers can therefore run full-width vector loads and stores over the padded length
+ * without a scalar epilogue, and internally simdsp rounds the lengths it passes to kernels up to the padded length
+ * where it can.
+ *
+ * The alignment comes from the widest vector ISA getSystemInfo() reports: 64 bytes with AVX-512, 32 with AVX, the
+ * vector length with SVE wider than 128 bits, 16 otherwise.  It never exceeds MAX_SIMD_ALIGNMENT, which is what to
+ * use with alignas for static storage.
+ *
+ * The helpers here are for vanilla code only: they are header templates, and dispatched code must not include them
+ * (see src/dispatched/dispatched_functions.hpp).
+ */
+static constexpr size_t MAX_SIMD_ALIGNMENT = 64;
+
+/**
+ * Alignment in bytes of the convention on this machine.  Cheap after the first call.
+ */
+size_t getSimdAlignment();
+
+/**
+ * Round count elements of element_size bytes up to the padded length of the convention, in elements.
+ *
+ * element_size must divide getSimdAlignment().
+ */
+size_t padToSimdAlignment(size_t count, size_t element_size);
+
+template <typename T> size_t padToSimdAlignment(size_t count) { return padToSimdAlignment(count, sizeof(T)); }
+
+/**
+ * Allocate zeroed memory following the convention, or free it.  bytes is padded internally.  alignedAllocate returns
+ * nullptr if out of memory.
+ */
+void *alignedAllocate(size_t bytes);
+void alignedFree(void *ptr);
+
+/**
+ * A non-owning view of count elements following the convention.  padded_count elements may be accessed.
+ */
+template <typename T> struct AlignedSpan {
+  T *data = nullptr;
+  size_t count = 0, padded_count = 0;
+
+  T &operator[](size_t i) const { return data[i]; }
+  T *begin() const { return data; }
+  T *end() const { return data + count; }
+  bool empty() const { return count == 0; }
+};
+
+/**
+ * An owning, zero-initialized buffer of trivially copyable T following the convention.
+ *
+ * Like a std::vector with only the parts simdsp needs: resizing discards the contents, and it moves but doesn't copy.
+ * Swapping two buffers never allocates, which is what lets convolvers swap state on the audio thread.
+ */
+template <typename T> class AlignedBuffer {
+public:
+  AlignedBuffer() = default;
+  explicit AlignedBuffer(size_t count) { resize(count); }
+  ~AlignedBuffer() { alignedFree(storage); }
+
+  AlignedBuffer(const AlignedBuffer &) = delete;
+  AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+  AlignedBuffer(AlignedBuffer &&other) noexcept { swap(other); }
+  AlignedBuffer &operator=(AlignedBuffer &&other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  void swap(AlignedBuffer &other) noexcept {
+    std::swap(storage, other.storage);
+    std::swap(count, other.count);
+    std::swap(padded_count, other.padded_count);
+  }
+
+  /**
+   * Reallocate to count zeroed elements.  The old contents are lost.  Throws std::bad_alloc if out of memory, as the
+   * std::vector this stands in for would, leaving the buffer empty.
+   */
+  void resize(size_t new_count) {
+    alignedFree(storage);
+    storage = nullptr;
+    count = 0;
+    padded_count = 0;
+
+    size_t new_padded_count = padToSimdAlignment<T>(new_count);
+    if (new_padded_count != 0) {
+      storage = (T *)alignedAllocate(new_padded_count * sizeof(T));
+      if (storage == nullptr) {
+        throw std::bad_alloc();
+      }
+    }
+    count = new_count;
+    padded_count = new_padded_count;
+  }
+
+  T *data() { return storage; }
+  const T *data() const { return storage; }
+  size_t size() const { return count; }
+  size_t paddedSize() const { return padded_count; }
+  bool empty() const { return count == 0; }
+
+  T &operator[](size_t i) { return storage[i]; }
+  const T &operator[](size_t i) const { return storage[i]; }
+
+  T *begin() { return storage; }
+  T *end() { return storage + count; }
+  const T *begin() const { return storage; }
+  const T *end() const { return storage + count; }
+
+  operator AlignedSpan<T>() { return AlignedSpan<T>{storage, count, padded_count}; }
+
+private:
+  T *storage = nullptr;
+  size_t count = 0, padded_count = 0;
+};
+
+template <typename T> void swap(AlignedBuffer<T> &a, AlignedBuffer<T> &b) noexcept { a.swap(b); }
+
+/**
+ * A bump allocator over one up-front allocation, for scratch memory on the audio thread.
+ *
+ * Every allocation follows the convention and is zeroed.  Allocation and rewinding are a handful of arithmetic
+ * operations: no locks, no system calls, and nothing which can block.  When the arena runs out, allocate returns an
+ * empty span rather than growing, so size arenas for the worst case up front.
+ *
+ * Not thread safe; give each thread its own.
+ */
+class AlignedArena {
+public:
+  explicit AlignedArena(size_t capacity_bytes);
+  ~AlignedArena();
+
+  AlignedArena(const AlignedArena &) = delete;
+  AlignedArena &operator=(const AlignedArena &) = delete;
+
+  template <typename T> AlignedSpan<T> allocate(size_t count) {
+    size_t padded = padToSimdAlignment<T>(count);
+    T *ptr = (T *)allocateBytes(padded * sizeof(T));
+    if (ptr == nullptr) {
+      return AlignedSpan<T>{};
+    }
+    return AlignedSpan<T>{ptr, count, padded};
+  }
+
+  /**
+   * getMark and rewind free everything allocated since the mark, for scoped scratch.  reset frees everything.
+   */
+  size_t getMark() const { return used; }
+  void rewind(size_t mark);
+  void reset() { rewind(0); }
+
+  size_t getCapacity() const { return capacity; }
+  size_t getUsed() const { return used; }
+
+private:
+  void *allocateBytes(size_t bytes);
+
+  unsigned char *memory;
+  size_t capacity, used = 0;
+};
+
+} // namespace simdsp
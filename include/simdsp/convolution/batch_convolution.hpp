@@ -0,0 +1,40 @@
+#pragma once
+
+#include "simdsp/convolution/output_mode.hpp"
+
+namespace simdsp {
+
+/**
+ * One convolution in a batch.  The pointers have the same meaning and requirements as the arguments of the same names
+ * to genericBlockConvolver: input points at the current frame with impulse_len - 1 frames of history before it,
+ * impulse is reversed, and output is written under mode, so that each voice of a batch can have its own gain.
+ */
+struct BatchConvolutionJob {
+  float *input;
+  float *impulse;
+  float *output;
+  OutputMode mode = OutputMode();
+};
+
+/**
+ * Number of floats of workspace batchBlockConvolver needs for the given shape.
+ */
+unsigned int getBatchBlockConvolverWorkspaceSize(unsigned int input_len, unsigned int impulse_len);
+
+/**
+ * Run many small direct convolutions of the same shape at once.
+ *
+ * genericBlockConvolver vectorizes over channels, which for mono or stereo sources leaves most of a vector idle.  This
+ * instead treats every (job, channel) pair as a lane, transposes groups of lanes into workspace so that each vector
+ * holds the same sample of different voices, convolves them all at full width, and scatters the results back.  The
+ * transposes are O(input_len + impulse_len) per lane against O(input_len * impulse_len) for the convolution, so this
+ * pays off as soon as impulses are more than a handful of taps.
+ *
+ * All jobs must share channels, input_len, and impulse_len, and channels and impulse_len must be at least 1.  Jobs may
+ * not overlap their outputs with each other's inputs.  workspace must be at least getBatchBlockConvolverWorkspaceSize
+ * floats.
+ */
+void batchBlockConvolver(const BatchConvolutionJob *jobs, unsigned int job_count, unsigned int channels,
+                         unsigned int input_len, unsigned int impulse_len, float *workspace);
+
+} // namespace simdsp
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace simdsp {
+
+struct BackgroundTaskQueue;
+
+/**
+ * A background thread which convolvers can push their expensive, non-urgent work to.
+ *
+ * Pass one to a convolver which supports it (e.g. NonUniformPartitionedConvolver) and that convolver will hand work
+ * whose results aren't needed for a few blocks to this thread.  The audio thread never waits on the worker's locks or
+ * allocates to do so: work goes over a lock-free single-producer single-consumer queue per convolver, and results come
+ * back through a per-task atomic state.  The one exception is waking a sleeping worker, which is a syscall (see wake).
+ * If the worker hasn't started a task by the time its results are needed, the audio thread takes it back and runs it
+ * inline, so a slow worker costs time on the audio thread but never produces wrong output.
+ *
+ * This keeps tail work off the audio thread on average, not in the worst case: if the worker is part way through a
+ * task when its results are needed, the audio thread spins until the worker finishes it.
+ *
+ * One worker may serve any number of convolvers.  All of them must be destroyed before the worker is.
+ */
+class ConvolutionWorker {
+public:
+  ConvolutionWorker();
+  ~ConvolutionWorker();
+
+  ConvolutionWorker(const ConvolutionWorker &) = delete;
+  ConvolutionWorker &operator=(const ConvolutionWorker &) = delete;
+
+  /*
+   * Used by convolvers.  attach and detach lock, so they belong in construction and destruction; once detach returns
+   * the worker will never touch the queue or its tasks again.
+   *
+   * wake is called from the audio thread.  It doesn't block on anything the worker holds, but when the worker is asleep
+   * it notifies a condition variable, which takes that condition variable's internal lock and is usually a futex
+   * syscall.  It only does so once per time the worker goes to sleep, and does nothing while the worker is busy.
+   */
+  void attach(BackgroundTaskQueue *queue);
+  void detach(BackgroundTaskQueue *queue);
+  void wake();
+
+private:
+  void workerThread();
+
+  // Protects queues, and is held by the worker thread while it's running tasks.
+  std::mutex queues_lock;
+  std::vector<BackgroundTaskQueue *> queues;
+
+  std::mutex wake_lock;
+  std::condition_variable wake_cond;
+  // Set by the worker while it waits on wake_cond, and cleared by whichever of it and wake gets there first.
+  std::atomic<bool> sleeping{false};
+  std::atomic<bool> stopping{false};
+
+  std::thread thread;
+};
+
+} // namespace simdsp
@@ -1,22 +1,30 @@
 #pragma once
 
+#include "simdsp/convolution/output_mode.hpp"
+
 namespace simdsp {
 
 /**
  * A simple, generic, block convolver which executes in O(n^2).
  *
- * Under the hood this is implemented with a basic libsimdpp dispatch on the straightforward C++ code.  Used as a
- * benchmark/reference implementation/"we don't have anything better we can do so time to fall back to the one that
- * always works".
+ * Under the hood this is the straightforward C++ code, compiled once per instruction set and dispatched at runtime (see
+ * simdsp/dispatch.hpp).  Used as a benchmark/reference implementation/"we don't have anything better we can do so time
+ * to fall back to the one that always works".
  *
- * The impulse pointer must be aligned with the simdsp convention, and contain the *reversed* impulse.  The input
- * pointer must point at the "current" sample, and it must be valid to access the frame at input[-impulse_len + 1]
+ * The impulse pointer must follow the simdsp alignment convention (see simdsp/aligned_memory.hpp), and contain the
+ * *reversed* impulse.  The input pointer must point at the "current" sample, and it must be valid to access the frame
+ * at input[-impulse_len + 1]
  *
  * The channels of both the input and impulse must match.
  *
- * If add is true, then the output is added to the destination. Otherwise, the output replaces the destination.  Under
- * the hood this is done as a branch which converts to a set of template functions, not a branch on every iteration.
+ * 1, 2, 4, and 8 channels, and within those impulses of 32, 64, 128, and 256 taps, go to kernels with the shape fixed
+ * at compile time, which vectorize across whole frames instead of across the channels of one frame.  Everything else
+ * takes the fully runtime path.  The choice is made per call and costs a couple of predictable branches.
+ *
+ * mode chooses between adding to and replacing the output, and the gain or gain ramp to apply on the way (see
+ * simdsp/convolution/output_mode.hpp).  Under the hood this is done as a branch which converts to a set of template
+ * functions, not a branch on every iteration.  The default adds at unity gain.
  */
 void genericBlockConvolver(float *input, unsigned int input_len, unsigned int input_channels, float *impulse,
-                           unsigned int impulse_len, float *output);
+                           unsigned int impulse_len, float *output, const OutputMode &mode = OutputMode());
 } // namespace simdsp
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+
+namespace simdsp {
+
+/**
+ * Impulse spectra exactly as UniformPartitionedConvolver uses them, so that it can use them without transforming or
+ * copying anything.
+ *
+ * For each channel and then each of partition_count partitions, one spectrum of block_size + 1 bins, prescaled by
+ * 1 / (2 * block_size), split into re and im.  Consecutive spectra are spectrum_stride floats apart and the padding is
+ * zero.  Both arrays follow the simdsp alignment convention on every machine: spectrum_stride is padded to
+ * MAX_SIMD_ALIGNMENT, not just the current machine's alignment, which is what makes files of these portable between
+ * ISAs.
+ *
+ * This is a view.  Whatever owns the memory (usually an ImpulseSpectraFile) must outlive everything using it.
+ */
+struct ImpulseSpectra {
+  unsigned int block_size = 0, channels = 0, partition_count = 0, spectrum_stride = 0;
+  unsigned int impulse_len = 0;
+  const float *re = nullptr, *im = nullptr;
+};
+
+/**
+ * The spectrum_stride ImpulseSpectra uses for a given block size.
+ */
+unsigned int getImpulseSpectraStride(unsigned int block_size);
+
+/**
+ * Transform impulse_count interleaved impulses, all with the given channel count, and write them to path as an impulse
+ * spectra file, for example to precompute an HRTF dataset once at build or install time.
+ *
+ * block_size is as for UniformPartitionedConvolver.  The file is written next to path and renamed into place, so
+ * processes which already have the old file mapped keep seeing the old contents.  Returns false if the file can't be
+ * written.
+ */
+bool saveImpulseSpectra(const char *path, unsigned int block_size, unsigned int channels, unsigned int impulse_count,
+                        const float *const *impulses, const unsigned int *impulse_lens);
+
+/**
+ * A memory-mapped impulse spectra file.
+ *
+ * The file is a small header and index followed by the spectra, each aligned to MAX_SIMD_ALIGNMENT within the file (see
+ * src/convolution/impulse_spectra.cpp for the layout).  Since the mapping is read-only and shared, every process
+ * mapping the same file uses the same page cache copy, and opening a file costs nothing per impulse until the impulse
+ * is used.
+ *
+ * The format is versioned, and files are in the byte order of the machine which wrote them.  Files from another version
+ * or byte order, or which fail validation, are refused rather than misread.
+ *
+ * Thread safe: everything after open is a read of immutable memory.
+ */
+class ImpulseSpectraFile {
+public:
+  /**
+   * Map and validate path.  Returns nullptr on failure.
+   */
+  static std::unique_ptr<ImpulseSpectraFile> open(const char *path);
+  ~ImpulseSpectraFile();
+
+  ImpulseSpectraFile(const ImpulseSpectraFile &) = delete;
+  ImpulseSpectraFile &operator=(const ImpulseSpectraFile &) = delete;
+
+  unsigned int getCount() const { return count; }
+  unsigned int getBlockSize() const { return block_size; }
+  unsigned int getChannels() const { return channels; }
+
+  /**
+   * The spectra of impulse index, pointing into the mapping.
+   */
+  ImpulseSpectra getSpectra(unsigned int index) const;
+
+private:
+  ImpulseSpectraFile() = default;
+
+  const unsigned char *mapping = nullptr;
+  size_t mapping_len = 0, index_offset = 0;
+  // Only meaningful on Windows, where unmapping needs the mapping object as well as the view.
+  void *mapping_handle = nullptr;
+  unsigned int count = 0, block_size = 0, channels = 0, spectrum_stride = 0;
+};
+
+} // namespace simdsp
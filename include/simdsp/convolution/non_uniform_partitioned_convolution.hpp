@@ -0,0 +1,122 @@
+#pragma once
+
+#include "simdsp/aligned_memory.hpp"
+#include "simdsp/convolution/streaming_convolution.hpp"
+#include "simdsp/convolution/uniform_partitioned_convolution.hpp"
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace simdsp {
+
+class ConvolutionWorker;
+struct BackgroundTaskQueue;
+
+/**
+ * One run of equally sized partitions in a non-uniform layout.
+ *
+ * Covers impulse frames [offset, offset + partition_size * partition_count).
+ */
+struct PartitionSegment {
+  unsigned int offset;
+  unsigned int partition_size;
+  unsigned int partition_count;
+};
+
+/**
+ * Work out the partition layout NonUniformPartitionedConvolver uses for a given block size and impulse length.
+ *
+ * The first block_size frames of the impulse are always handled directly and are not part of the returned layout.
+ * After that, partition sizes double from block_size, with two partitions per size, until max_partition_size; whatever
+ * is left goes into partitions of max_partition_size.  Every segment starts at an offset at least as large as its
+ * partition size, which is what makes the whole thing zero-latency.
+ *
+ * If max_partition_size is 0, it's picked from the impulse length, capped by getConvolutionTuning().  Otherwise it's
+ * rounded down to a power of two no smaller than block_size.
+ */
+std::vector<PartitionSegment> computeNonUniformPartitionLayout(unsigned int block_size, unsigned int impulse_len,
+                                                               unsigned int max_partition_size = 0);
+
+/**
+ * A zero-latency convolver for long impulses.
+ *
+ * The head of the impulse (the first block_size frames) runs through the direct genericBlockConvolver kernel (via a
+ * StreamingConvolver, which owns the history), so the output for a block depends on that block's input immediately.
+ * The tail runs through uniformly partitioned FFT segments of increasing size (Gardner's scheme), each of which is fed
+ * once it has accumulated a full partition of input and whose results are written into an output ring ahead of time.
+ * See computeNonUniformPartitionLayout.
+ *
+ * By default the larger segments do their work on the block which completes their input, so the cost of individual
+ * calls is not constant even though the average per block is close to a uniform engine with block_size partitions.  If
+ * a ConvolutionWorker is given, every segment whose output isn't needed until at least one block after its input
+ * completes is instead computed on the worker, and the audio thread only does the head and the first segment.  Results
+ * which aren't ready when they're needed are computed inline (or waited for, if the worker is part way through them)
+ * and counted; see getLateResultCount.
+ *
+ * Impulses shorter than the FFT crossover for the block size (see ConvolutionTuning) are cheaper to convolve directly,
+ * and go entirely through the head with an empty layout.  When not given, max_partition_size is also capped by the
+ * tuning.
+ *
+ * block_size must be a power of two.  The impulse is in natural order and, like the input, is interleaved with the
+ * given number of channels.
+ *
+ * Not thread safe.  After construction, process does not allocate.
+ */
+class NonUniformPartitionedConvolver {
+public:
+  NonUniformPartitionedConvolver(unsigned int block_size, unsigned int channels, const float *impulse,
+                                 unsigned int impulse_len, unsigned int max_partition_size = 0,
+                                 ConvolutionWorker *worker = nullptr);
+  ~NonUniformPartitionedConvolver();
+
+  /**
+   * Convolve block_size frames of input, writing the result to output as mode says.
+   */
+  void process(const float *input, float *output, const OutputMode &mode = OutputMode());
+
+  /**
+   * Forget all history.  If using a worker, this waits for any work in flight.
+   */
+  void reset();
+
+  unsigned int getBlockSize() const { return block_size; }
+  unsigned int getChannels() const { return channels; }
+  const std::vector<PartitionSegment> &getLayout() const { return layout; }
+
+  /**
+   * How many segment results were handed to the worker, and how many of those weren't ready when the audio thread
+   * needed them, including those which the audio thread ran itself because the worker's queue was full.  Safe to read
+   * from any thread.
+   */
+  uint64_t getBackgroundResultCount() const { return background_results.load(std::memory_order_relaxed); }
+  uint64_t getLateResultCount() const { return late_results.load(std::memory_order_relaxed); }
+
+private:
+  struct Segment;
+
+  void feedSegment(Segment &segment, const float *input);
+  void collectSegment(Segment &segment);
+  void addToRing(const float *segment_output, unsigned int start, unsigned int frames);
+
+  unsigned int block_size, channels;
+  StreamingConvolver head;
+  std::vector<PartitionSegment> layout;
+  std::vector<std::unique_ptr<Segment>> segments;
+
+  ConvolutionWorker *worker;
+  std::unique_ptr<BackgroundTaskQueue> task_queue;
+  std::atomic<uint64_t> background_results{0}, late_results{0};
+
+  // Tail output which is computed ahead of time.  A power of two number of frames, indexed by absolute frame mod its
+  // length.
+  AlignedBuffer<float> output_ring;
+  unsigned int ring_frames;
+  unsigned int ring_position = 0;
+
+  // A partition's worth of segment output before it's added into the ring.
+  AlignedBuffer<float> segment_output;
+};
+
+} // namespace simdsp
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace simdsp {
+
+/**
+ * How a convolver writes its result.
+ *
+ * The result is scaled by a gain ramping linearly from gain_start to gain_end over the call, by the same convention as
+ * simdsp/mixing/mixing.hpp: frame i of frames is at gain_start + (gain_end - gain_start) * (i + 1) / frames.  Then it
+ * is added to the output if add is true, and otherwise replaces it.
+ *
+ * This is fused into the kernels, so convolving a source and mixing it into a bus at some gain needs no zeroing, no
+ * scratch buffer, and no separate gain pass.  In the direct kernels a constant gain is folded into the impulse
+ * coefficients and costs nothing, and a ramp costs a multiply per output frame per group of taps.
+ *
+ * The default adds at unity gain.
+ */
+struct OutputMode {
+  bool add = true;
+  float gain_start = 1.0f, gain_end = 1.0f;
+};
+
+} // namespace simdsp
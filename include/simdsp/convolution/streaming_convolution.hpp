@@ -0,0 +1,67 @@
+#pragma once
+
+#include "simdsp/aligned_memory.hpp"
+#include "simdsp/convolution/output_mode.hpp"
+#include "simdsp/convolution/tiled_block_convolution.hpp"
+
+namespace simdsp {
+
+/**
+ * A direct-form convolver which owns its input history.
+ *
+ * genericBlockConvolver needs impulse_len - 1 frames of history in front of every block, which otherwise means keeping
+ * a history buffer and sliding it along every block.  This keeps a mirrored ring instead: every frame is written twice,
+ * capacity frames apart, so the history plus the current block is always one contiguous run of memory which can be
+ * handed straight to the kernel.  The only copy per call is the new input itself.
+ *
+ * Calls may be of any number of frames.  Calls larger than max_block_size are split internally, so max_block_size only
+ * trades memory for the number of kernel invocations.
+ *
+ * The impulse is in its natural order (not reversed) and, like the input, is interleaved with the given number of
+ * channels.
+ *
+ * Impulses too big for L1 go through tiledBlockConvolver, smaller ones through genericBlockConvolver.  The threshold
+ * comes from getConvolutionTuning() at construction.
+ *
+ * Not thread safe.  After construction, nothing allocates.
+ */
+class StreamingConvolver {
+public:
+  StreamingConvolver(unsigned int channels, const float *impulse, unsigned int impulse_len,
+                     unsigned int max_block_size = 256);
+
+  /**
+   * Convolve frames frames of input, writing the result to output as mode says.  A gain ramp spans all frames frames,
+   * however the call is split internally.
+   */
+  void process(const float *input, unsigned int frames, float *output, const OutputMode &mode = OutputMode());
+
+  /**
+   * Forget all history, as if the convolver had just been constructed.
+   */
+  void reset();
+
+  unsigned int getChannels() const { return channels; }
+  unsigned int getImpulseLength() const { return impulse_len; }
+
+private:
+  void processChunk(const float *input, unsigned int frames, float *output, const OutputMode &mode);
+
+  unsigned int channels, impulse_len, max_block_size;
+  // Frames in the ring.  At least impulse_len - 1 + max_block_size.
+  unsigned int capacity;
+  // Where the next frame goes, in [0, capacity).
+  unsigned int write_position = 0;
+
+  // Whether to use tiledBlockConvolver, and with what tiles.
+  bool tiled;
+  DirectConvolutionTiling tiling;
+
+  // The reversed impulse, interleaved.
+  AlignedBuffer<float> reversed_impulse;
+
+  // 2 * capacity frames.  Frame i is always equal to frame i + capacity.
+  AlignedBuffer<float> ring;
+};
+
+} // namespace simdsp
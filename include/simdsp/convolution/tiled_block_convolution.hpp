@@ -0,0 +1,40 @@
+#pragma once
+
+#include "simdsp/convolution/output_mode.hpp"
+
+namespace simdsp {
+
+/**
+ * Tile sizes for tiledBlockConvolver.
+ *
+ * tile_taps is how many taps of the impulse are applied to a tile of output before moving on to the next taps, and
+ * tile_frames how many frames of output make up that tile.  Both must be nonzero.
+ */
+struct DirectConvolutionTiling {
+  unsigned int tile_taps, tile_frames;
+};
+
+/**
+ * Tile sizes derived from the cache sizes getSystemInfo() reports: one tile of output plus the input under it fits in
+ * half of L1d, and one tile of taps plus the input it slides over in half of L2.
+ */
+DirectConvolutionTiling getDefaultDirectConvolutionTiling(unsigned int channels);
+
+/**
+ * A cache- and register-tiled version of genericBlockConvolver, with the same arguments and the same requirements on
+ * them, including the output mode.
+ *
+ * genericBlockConvolver walks the whole impulse for every output frame, so once the impulse no longer fits in L1 it is
+ * streamed from L2 or further once per frame.  This instead applies an L2-sized tile of taps to one L1-sized tile of
+ * output at a time, several taps per pass with their coefficients in registers, so that every output frame is loaded
+ * and stored once per group of taps and the input under the tile is reused from L1.
+ * It pays off for impulses of roughly a thousand taps and up, which is also about where the FFT engines start to win,
+ * so it mostly matters for the range where neither is clearly better.
+ *
+ * If tiling is null, getDefaultDirectConvolutionTiling(input_channels) is used.
+ */
+void tiledBlockConvolver(float *input, unsigned int input_len, unsigned int input_channels, float *impulse,
+                         unsigned int impulse_len, float *output, const DirectConvolutionTiling *tiling = nullptr,
+                         const OutputMode &mode = OutputMode());
+
+} // namespace simdsp
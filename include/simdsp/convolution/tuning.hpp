@@ -0,0 +1,82 @@
+#pragma once
+
+namespace simdsp {
+
+/**
+ * Block sizes the direct/FFT crossover is tuned for: powers of two from CONVOLUTION_TUNING_MIN_BLOCK_SIZE, one entry
+ * per doubling.  Other block sizes use the nearest entry.
+ */
+static const unsigned int CONVOLUTION_TUNING_MIN_BLOCK_SIZE = 32;
+static const unsigned int CONVOLUTION_TUNING_BLOCK_SIZES = 7;
+
+/**
+ * Channel counts the direct/tiled crossover is tuned for: 1, 2, 4, and 8, which are the counts the direct kernels
+ * specialize, one entry per doubling.  Other counts use the largest entry not above them.
+ */
+static const unsigned int CONVOLUTION_TUNING_CHANNEL_COUNTS = 4;
+
+/**
+ * The machine-dependent thresholds the convolution engines choose strategies by.
+ *
+ * - tiled_min_impulse_len: per channel count, the impulse length from which StreamingConvolver uses
+ *   tiledBlockConvolver instead of genericBlockConvolver.  Indexed by log2(channels).
+ * - max_partition_size: the largest partition NonUniformPartitionedConvolver uses when not told otherwise.
+ * - fft_min_impulse_len: per block size, the impulse length from which NonUniformPartitionedConvolver runs its tail
+ *   through FFT segments.  Below it, the whole impulse is convolved directly.  Indexed by log2(block_size /
+ *   CONVOLUTION_TUNING_MIN_BLOCK_SIZE).
+ */
+struct ConvolutionTuning {
+  unsigned int tiled_min_impulse_len[CONVOLUTION_TUNING_CHANNEL_COUNTS];
+  unsigned int max_partition_size;
+  unsigned int fft_min_impulse_len[CONVOLUTION_TUNING_BLOCK_SIZES];
+};
+
+/**
+ * Thresholds from static heuristics and the cache sizes in getSystemInfo(), without measuring anything.  This is what
+ * is in effect until setConvolutionTuning is called.
+ */
+ConvolutionTuning getDefaultConvolutionTuning();
+
+/**
+ * Measure the engines against each other on this machine and return the resulting thresholds.
+ *
+ * This takes on the order of seconds, so it belongs in deployment (see utilities/tune_convolution.cpp) or behind
+ * initializeConvolutionTuning, not on a hot path.  It doesn't change the tuning in effect.
+ */
+ConvolutionTuning runConvolutionTuning();
+
+/**
+ * Save tuning to path, keyed by the convertSystemInfoToJson fingerprint of this machine and the dispatch cap in effect
+ * (see setMaxDispatchVariant), or load it back.
+ *
+ * Loading fails (returning false and leaving out alone) if the file is missing, malformed, from another version of the
+ * format, or was tuned on a machine with a different fingerprint or under a different cap.
+ */
+bool saveConvolutionTuning(const char *path, const ConvolutionTuning &tuning);
+bool loadConvolutionTuning(const char *path, ConvolutionTuning *out);
+
+/**
+ * The tuning in effect for engines constructed from now on.  Engines constructed earlier keep what they chose.
+ * Thread safe.
+ */
+void setConvolutionTuning(const ConvolutionTuning &tuning);
+ConvolutionTuning getConvolutionTuning();
+
+/**
+ * The one-call startup path: load the tuning from path if it's there and matches this machine, otherwise run the
+ * tuner and try to save the result there.  Either way, the result is put into effect and returned.
+ */
+ConvolutionTuning initializeConvolutionTuning(const char *path);
+
+/**
+ * The crossover for a given block size, from the largest tuned block size not above it (or the smallest, for tiny
+ * blocks).  0 means the tail always goes through FFT segments.
+ */
+unsigned int getFftCrossover(const ConvolutionTuning &tuning, unsigned int block_size);
+
+/**
+ * The tiled crossover for a given channel count, from the largest tuned count not above it.
+ */
+unsigned int getTiledCrossover(const ConvolutionTuning &tuning, unsigned int channels);
+
+} // namespace simdsp
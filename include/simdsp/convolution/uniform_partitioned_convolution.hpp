@@ -0,0 +1,123 @@
+#pragma once
+
+#include "simdsp/aligned_memory.hpp"
+#include "simdsp/convolution/impulse_spectra.hpp"
+#include "simdsp/convolution/output_mode.hpp"
+#include "simdsp/fft.hpp"
+
+#include <memory>
+
+namespace simdsp {
+
+/**
+ * A uniformly partitioned overlap-save convolver, for impulses which are far too long for genericBlockConvolver.
+ *
+ * The impulse is split into partitions of block_size samples, each of which is transformed once at construction.
+ * Every call to process then does one forward FFT per channel, a complex multiply-accumulate of the last
+ * partition_count input spectra (the frequency-domain delay line) against the partitions, and one inverse FFT per
+ * channel.  The cost per sample is therefore O(log(block_size) + impulse_len / block_size) rather than O(impulse_len).
+ *
+ * Output for a block is produced by the call which receives that block, so there is no latency beyond the caller's
+ * own blocking.
+ *
+ * block_size must be of the form 2^a 3^b 5^c, so that the FFT size (twice that) is supported by RealFft.  The FFT plan
+ * comes from getRealFft, so convolvers with the same block size share twiddle tables.
+ *
+ * Unlike genericBlockConvolver, the impulse is in its natural order (not reversed).  Both the input and impulse are
+ * interleaved, and their channel counts must match.
+ *
+ * The impulse may be replaced with setImpulse, which crossfades from the old impulse to the new one over the next
+ * block.  Both share the same input spectra, so a crossfading block costs one forward FFT, two complex MACs, and two
+ * inverse FFTs rather than two full convolutions.
+ *
+ * Impulses may also come already transformed, as ImpulseSpectra (usually from an ImpulseSpectraFile).  Those are used
+ * in place rather than copied, so they must outlive the convolver, or at least stay alive until replaced by a
+ * setImpulse which has been followed by a call to process or reset.
+ *
+ * Not thread safe.  After construction, process does not allocate.
+ */
+class UniformPartitionedConvolver {
+public:
+  UniformPartitionedConvolver(unsigned int block_size, unsigned int channels, const float *impulse,
+                              unsigned int impulse_len);
+  explicit UniformPartitionedConvolver(const ImpulseSpectra &spectra);
+  ~UniformPartitionedConvolver();
+
+  /**
+   * Convolve block_size frames of input, writing the result to output as mode says.
+   */
+  void process(const float *input, float *output, const OutputMode &mode = OutputMode());
+
+  /**
+   * Replace the impulse, crossfading linearly from the old one to the new one over the next call to process.
+   *
+   * The new impulse has the same channel count and may not be longer than partition_count * block_size frames.  If this
+   * is called more than once between calls to process, the last impulse wins and the crossfade is still from the
+   * impulse which was last audible.
+   *
+   * This transforms the new impulse, so it costs partition_count forward FFTs per channel.  The first call allocates
+   * a second set of spectra; after that, nothing does.
+   */
+  void setImpulse(const float *impulse, unsigned int impulse_len);
+
+  /**
+   * Replace the impulse with precomputed spectra, crossfading as above.  The spectra must have the same block size and
+   * channel count, and no more partitions.  Nothing is transformed, copied, or allocated, so unlike the other overload
+   * this is cheap enough to call from the audio thread.
+   */
+  void setImpulse(const ImpulseSpectra &spectra);
+
+  /**
+   * Forget all history, as if the convolver had just been constructed.  A pending impulse update is applied without a
+   * crossfade.
+   */
+  void reset();
+
+  unsigned int getBlockSize() const { return block_size; }
+  unsigned int getChannels() const { return channels; }
+  unsigned int getPartitionCount() const { return partition_count; }
+
+private:
+  /*
+   * Everything but the impulse.
+   */
+  void allocateState();
+  /*
+   * Transform the impulse into channels * partition_count prescaled spectra.
+   */
+  void transformImpulse(const float *impulse, unsigned int impulse_len, float *out_re, float *out_im);
+  void applyPendingImpulse();
+
+  unsigned int block_size, channels, partition_count;
+  // Distance between consecutive spectra in the arrays below, as getImpulseSpectraStride, so that precomputed spectra
+  // can be used as is.
+  unsigned int spectrum_stride;
+  // How much of each spectrum the kernels run over: block_size + 1 bins, padded per the simdsp alignment convention on
+  // this machine.  Never more than spectrum_stride.
+  unsigned int spectrum_work_len;
+  // Slot of the frequency-domain delay line which the next block's spectrum goes into.
+  unsigned int fdl_position = 0;
+
+  std::shared_ptr<const RealFft> fft;
+
+  // channels * 2 * block_size: the previous and current block of each channel.
+  AlignedBuffer<float> history;
+  // channels * partition_count spectra each.  Impulse spectra are prescaled by 1 / fft size.  The impulse in use is
+  // whatever current_re and current_im point at, which is either impulse_re and impulse_im or someone else's
+  // ImpulseSpectra.
+  AlignedBuffer<float> impulse_re, impulse_im, fdl_re, fdl_im;
+  const float *current_re = nullptr, *current_im = nullptr;
+  // Precomputed spectra may be shorter than partition_count.
+  unsigned int current_partitions;
+  // One spectrum, one fft-sized time-domain block, and the FFT's workspace.
+  AlignedBuffer<float> acc_re, acc_im, time_block, workspace;
+
+  // The impulse being crossfaded to, and the second spectrum and block needed to do it.  Empty until the first call to
+  // setImpulse, and the spectra stay empty if only precomputed spectra are ever set.
+  bool impulse_pending = false;
+  const float *pending_re = nullptr, *pending_im = nullptr;
+  unsigned int pending_partitions = 0;
+  AlignedBuffer<float> pending_impulse_re, pending_impulse_im, pending_acc_re, pending_acc_im, pending_time_block;
+};
+
+} // namespace simdsp
@@ -0,0 +1,82 @@
+#pragma once
+
+namespace simdsp {
+
+/**
+ * The variants of the dispatched code which simdsp knows how to build.
+ *
+ * Everything in src/dispatched is compiled once per variant which makes sense for the target architecture, then the
+ * widest variant the CPU supports is selected at runtime the first time any dispatched function is called.  Which
+ * variants actually exist in a given binary depends on the architecture the library was built for: GENERIC is always
+ * present and is whatever the compiler's baseline is.
+ *
+ * AARCH64_SVE is vector-length agnostic, and is only picked automatically where SVE vectors are wider than NEON's 128
+ * bits; at 128 bits NEON code is as fast or faster.  It can still be forced.
+ *
+ * Static builds (the SIMDSP_STATIC_DISPATCH CMake option) are the exception: they contain only the variant the compiler
+ * targets (SIMDSP_BASELINE_VARIANT, from simdsp/feature_macros.hpp), called directly, and the thinnest entry points are
+ * inline.  Nothing there consults the CPU, and forcing or capping can't switch to another variant.  getSystemInfo()
+ * works as usual.
+ */
+enum class DispatchVariant { GENERIC, X86_SSE2, X86_AVX, X86_AVX2, X86_AVX512F, AARCH64_NEON, AARCH64_SVE };
+
+const char *dispatchVariantToString(DispatchVariant variant);
+
+/**
+ * Return the variant which dispatched functions are using.
+ *
+ * If dispatch hasn't been resolved yet, this resolves it.  After that, the answer only changes if someone calls
+ * forceDispatchVariant.
+ */
+DispatchVariant getDispatchVariant();
+
+/**
+ * Return whether the given variant was compiled into this build of simdsp.  Says nothing about whether the CPU can run
+ * it.
+ */
+bool isDispatchVariantCompiled(DispatchVariant variant);
+
+/**
+ * Return whether the given variant is compiled in and the CPU can run it.
+ */
+bool isDispatchVariantRunnable(DispatchVariant variant);
+
+/**
+ * Switch every dispatched function over to the given variant, for benchmarking and testing the variants against each
+ * other.  Returns false and changes nothing if the variant isn't runnable.  resetDispatchVariant goes back to the
+ * automatic choice.
+ *
+ * Safe to call at any time from any thread: calls already in progress finish on the variant they started with.
+ */
+bool forceDispatchVariant(DispatchVariant variant);
+void resetDispatchVariant();
+
+/**
+ * Cap the variants simdsp may use, as if the CPU supported nothing wider than the given one: for reproducing on a new
+ * machine what runs on an older one, or benchmarking variants side by side.
+ *
+ * Variants are capped within their architecture (e.g. a cap of X86_AVX2 rules out X86_AVX512F and nothing else).
+ * Capped variants stop being runnable: automatic dispatch skips them, isDispatchVariantRunnable says no, and
+ * forceDispatchVariant refuses them.  GENERIC is never capped, so a cap for the wrong architecture leaves only it.
+ *
+ * The initial cap comes from the SIMDSP_MAX_ISA environment variable, read the first time anything dispatches, which
+ * takes the names parseDispatchVariant does: e.g. SIMDSP_MAX_ISA=avx2.  Values which don't parse are ignored.
+ *
+ * Setting the cap re-resolves dispatch, dropping any forced variant.  resetMaxDispatchVariant goes back to
+ * SIMDSP_MAX_ISA, or to no cap at all.
+ */
+void setMaxDispatchVariant(DispatchVariant variant);
+void resetMaxDispatchVariant();
+
+/**
+ * Get the cap in effect, returning false if there isn't one.
+ */
+bool getMaxDispatchVariant(DispatchVariant *out);
+
+/**
+ * Parse the name of a variant: what dispatchVariantToString returns, with or without the architecture prefix, in any
+ * case.  So "x86_avx2", "avx2", and "AVX2" are all X86_AVX2.  Returns false if the name isn't a variant.
+ */
+bool parseDispatchVariant(const char *name, DispatchVariant *out);
+
+} // namespace simdsp
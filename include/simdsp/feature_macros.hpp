@@ -30,3 +30,42 @@
 #if (defined(SIMDSP_IS_X86) + defined(SIMDSP_IS_AARCH64)) != 1
 #error Unable to unambiguously determine architecture.
 #endif
+
+/*
+ * The widest DispatchVariant (see simdsp/dispatch.hpp) which the compiler flags of the current compilation unit already
+ * guarantee, e.g. X86_AVX2 under -march=x86-64-v3:
+ *
+ * - SIMDSP_BASELINE_VARIANT: the DispatchVariant enumerator.
+ * - SIMDSP_BASELINE_ARCH_NAMESPACE: the namespace dispatched code for that variant is built in.
+ *
+ * This is what a static build (SIMDSP_STATIC_DISPATCH) is made of, so code including simdsp headers in such a build
+ * must use the same flags as the library.  MSVC has no __FMA__, but its /arch:AVX2 implies FMA.
+ */
+#if defined(SIMDSP_IS_X86)
+#if defined(__AVX512F__) && defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define SIMDSP_BASELINE_VARIANT X86_AVX512F
+#define SIMDSP_BASELINE_ARCH_NAMESPACE arch_avx512f
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define SIMDSP_BASELINE_VARIANT X86_AVX2
+#define SIMDSP_BASELINE_ARCH_NAMESPACE arch_avx2
+#elif defined(__AVX__)
+#define SIMDSP_BASELINE_VARIANT X86_AVX
+#define SIMDSP_BASELINE_ARCH_NAMESPACE arch_avx
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMDSP_BASELINE_VARIANT X86_SSE2
+#define SIMDSP_BASELINE_ARCH_NAMESPACE arch_sse2
+#endif
+#elif defined(SIMDSP_IS_AARCH64)
+#if defined(__ARM_FEATURE_SVE)
+#define SIMDSP_BASELINE_VARIANT AARCH64_SVE
+#define SIMDSP_BASELINE_ARCH_NAMESPACE arch_sve
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define SIMDSP_BASELINE_VARIANT AARCH64_NEON
+#define SIMDSP_BASELINE_ARCH_NAMESPACE arch_neon
+#endif
+#endif
+
+#if !defined(SIMDSP_BASELINE_VARIANT)
+#define SIMDSP_BASELINE_VARIANT GENERIC
+#define SIMDSP_BASELINE_ARCH_NAMESPACE arch_generic
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace simdsp {
+
+class ComplexFft;
+
+/**
+ * How a transform is laid out in memory.
+ *
+ * IN_CACHE runs mixed-radix Stockham passes over the whole array, which is the fastest thing to do as long as the array
+ * fits in cache.  SIX_STEP splits a transform of size n1 * n2 into column transforms done a cache-sized block at a
+ * time, a twiddle multiply, row transforms, and a transpose, so that no pass streams the whole array from memory.
+ *
+ * AUTOMATIC picks based on the cache sizes reported by getSystemInfo().
+ */
+enum class FftAlgorithm { AUTOMATIC, IN_CACHE, SIX_STEP };
+
+/**
+ * Whether RealFft supports the given size: an even number whose half is of the form 2^a 3^b 5^c.
+ */
+bool isRealFftSizeSupported(unsigned int size);
+
+/**
+ * The smallest supported size which is at least the given size.
+ */
+unsigned int getNextRealFftSize(unsigned int size);
+
+/**
+ * A plan for a real FFT of a fixed size.
+ *
+ * Spectra are split complex: size / 2 + 1 real parts and as many imaginary parts, in separate arrays.  The inverse is
+ * unnormalized, so forward followed by inverse scales by size.
+ *
+ * Plans are immutable after construction.  All scratch memory comes from the caller, so one plan may be used from any
+ * number of threads at once.  Prefer getRealFft, which shares plans (and their twiddle tables) between everyone
+ * asking for the same size.
+ *
+ * The butterflies are radix 2, 3, 4, 5, and 8, and go through runtime dispatch.  They are plain loops compiled once per
+ * dispatch variant, which rely on the compiler to vectorize them rather than on intrinsics.
+ */
+class RealFft {
+public:
+  RealFft(unsigned int size, FftAlgorithm algorithm = FftAlgorithm::AUTOMATIC);
+  ~RealFft();
+
+  unsigned int getSize() const { return size; }
+  unsigned int getBinCount() const { return size / 2 + 1; }
+
+  /**
+   * The algorithm actually in use.  Never AUTOMATIC.
+   */
+  FftAlgorithm getAlgorithm() const;
+
+  /**
+   * Number of floats of workspace which forward and inverse need.
+   */
+  unsigned int getWorkspaceSize() const;
+
+  /**
+   * Transform size real samples into getBinCount() complex bins.
+   */
+  void forward(const float *input, float *out_re, float *out_im, float *workspace) const;
+
+  /**
+   * Transform getBinCount() complex bins into size real samples, scaled by size.  The imaginary parts of bin 0 and the
+   * last bin are ignored.
+   */
+  void inverse(const float *in_re, const float *in_im, float *output, float *workspace) const;
+
+private:
+  unsigned int size;
+  std::unique_ptr<ComplexFft> complex_fft;
+  // exp(-2 pi i k / size) for k in 0..size / 2, for packing and unpacking the real transform.
+  std::vector<float> real_tw_re, real_tw_im;
+};
+
+/**
+ * Get a shared plan for the given size, creating it if necessary.
+ *
+ * Thread safe.  Plans live until the process exits, so this is intended to be called when setting things up, not from
+ * an audio thread.
+ */
+std::shared_ptr<const RealFft> getRealFft(unsigned int size);
+
+} // namespace simdsp
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "simdsp/aligned_memory.hpp"
+
+namespace simdsp {
+
+/**
+ * Coefficients of one biquad section, normalized so that a0 is 1:
+ *
+ * y[n] = b0 x[n] + b1 x[n - 1] + b2 x[n - 2] - a1 y[n - 1] - a2 y[n - 2]
+ *
+ * The default is the identity.
+ */
+struct BiquadCoefficients {
+  float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+};
+
+/**
+ * Filter shapes from the RBJ audio EQ cookbook.
+ */
+enum class BiquadType {
+  LOWPASS,
+  HIGHPASS,
+  // Constant 0 dB peak gain.
+  BANDPASS,
+  NOTCH,
+  ALLPASS,
+  PEAKING,
+  LOW_SHELF,
+  HIGH_SHELF,
+};
+
+/**
+ * Design a section.  frequency is in Hz and must be below sample_rate / 2.  gain_db is only used by PEAKING and the
+ * shelves; for the shelves, q is the cookbook's Q rather than its shelf slope.
+ *
+ * Done in double precision, since the poles of low, sharp filters are very close to the unit circle.
+ */
+BiquadCoefficients designBiquad(BiquadType type, double sample_rate, double frequency, double q, double gain_db = 0.0);
+
+/**
+ * A bank of independent cascaded biquad filters, one per lane, run in parallel across SIMD lanes.
+ *
+ * A single biquad is a serial recurrence and doesn't vectorize, but lanes of a bank (channels of one source, or voices
+ * of a mixer) are independent, so one vector instruction can advance many of them by a frame.  Input and output are
+ * interleaved with one channel per lane, which is the layout the rest of simdsp uses.
+ *
+ * Every lane has the same number of sections, run in order; a lane which needs fewer can leave the rest as the
+ * identity.  Sections are transposed direct form II.  Under the hood, each section runs over the block as a whole in
+ * groups of lanes whose coefficients and state stay in registers, through runtime dispatch (see simdsp/dispatch.hpp).
+ *
+ * Coefficient changes are interpolated linearly, per frame, over the next call to process, so that moving a cutoff
+ * doesn't click.  Short blocks make for smoother sweeps.  Pass interpolate = false to jump instead, for example when
+ * setting a lane up for a new voice.  Blocks without pending changes take a cheaper path.
+ *
+ * Not thread safe.  After construction, nothing allocates.
+ */
+class BiquadFilterBank {
+public:
+  BiquadFilterBank(unsigned int lanes, unsigned int sections);
+
+  /**
+   * Filter frames frames.  Output replaces whatever is in output, and may be the same pointer as input.
+   */
+  void process(const float *input, float *output, unsigned int frames);
+
+  void setCoefficients(unsigned int lane, unsigned int section, const BiquadCoefficients &coefficients,
+                       bool interpolate = true);
+
+  /**
+   * The coefficients the lane is at or heading towards.
+   */
+  BiquadCoefficients getCoefficients(unsigned int lane, unsigned int section) const;
+
+  /**
+   * Zero the state of one lane, or of all of them.  Coefficients are left alone, but pending interpolation finishes
+   * immediately.
+   */
+  void resetLane(unsigned int lane);
+  void reset();
+
+  unsigned int getLanes() const { return lanes; }
+  unsigned int getSections() const { return sections; }
+
+private:
+  float *getCoefficientArray(AlignedBuffer<float> &buffer, unsigned int section, unsigned int which) {
+    return &buffer[((size_t)section * 5 + which) * lane_stride];
+  }
+  void finishInterpolation();
+
+  unsigned int lanes, sections;
+  // Lanes padded per the simdsp alignment convention.
+  unsigned int lane_stride;
+
+  // For each section, b0, b1, b2, a1, and a2 of every lane, lane_stride apart.  coefficients is where the lanes are;
+  // targets where they're going.
+  AlignedBuffer<float> coefficients, targets;
+  // The same layout, (target - current) / frames, rebuilt for each interpolated block.
+  AlignedBuffer<float> deltas;
+  // For each section, z1 and z2 of every lane.
+  AlignedBuffer<float> state;
+  bool interpolation_pending = false;
+};
+
+} // namespace simdsp
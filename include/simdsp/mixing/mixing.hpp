@@ -0,0 +1,111 @@
+#pragma once
+
+#include "simdsp/feature_macros.hpp"
+
+namespace simdsp {
+
+/*
+ * Gains, matrix mixes, and layout conversions: the loops which glue the rest of simdsp together.
+ *
+ * All of these are compiled once per instruction set and dispatched at runtime (see simdsp/dispatch.hpp), or in static
+ * builds are inline and call the one instruction set directly.  1, 2, 4, and 8 channels go to kernels with the shape
+ * fixed at compile time; other counts take a runtime path.
+ *
+ * Buffers are interleaved unless said otherwise.  None of these have alignment requirements, though aligned buffers
+ * are faster.
+ *
+ * If add is true, the result is added to the destination, and otherwise it replaces the destination.  Under the hood
+ * this is a branch which converts to a set of template functions, not a branch per sample, so mixing a source into a
+ * bus is one read of each and one write of the bus, without zeroing or scratch buffers.
+ *
+ * Ramps follow the convention of the convolution crossfades: frame i of a block of frames frames is at
+ * start + (end - start) * (i + 1) / frames, so the last frame is at end and the next block, at end, continues without a
+ * step.
+ */
+
+/**
+ * output = input * gain.  input and output may be the same pointer.
+ */
+void mixGain(const float *input, float *output, unsigned int frames, unsigned int channels, float gain, bool add);
+
+/**
+ * As mixGain, with a gain ramping from gain_start to gain_end over the block, the same for every channel.  A ramp
+ * with gain_start == gain_end costs the same as mixGain.
+ */
+void mixGainRamp(const float *input, float *output, unsigned int frames, unsigned int channels, float gain_start,
+                 float gain_end, bool add);
+
+/**
+ * Mix input_channels channels into output_channels channels: output channel o of each frame is the sum over input
+ * channels i of input channel i times matrix[o * input_channels + i].  For example, a pan is a 1 x 2 matrix and an
+ * upmix to 5.1 a 2 x 6 one.  input and output must not overlap.
+ */
+void mixMatrix(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+               unsigned int frames, const float *matrix, bool add);
+
+/**
+ * As mixMatrix, with every coefficient ramping from from_matrix to to_matrix over the block, for moving pans without
+ * zipper noise.
+ */
+void mixMatrixRamp(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+                   unsigned int frames, const float *from_matrix, const float *to_matrix, bool add);
+
+/**
+ * Convert channels planar buffers of frames samples each to one interleaved buffer, and back.  For example, to feed
+ * planar sources to the convolvers, which take interleaved input.
+ */
+void interleaveChannels(const float *const *planar, unsigned int channels, unsigned int frames, float *output);
+void deinterleaveChannels(const float *input, unsigned int channels, unsigned int frames, float *const *planar);
+
+} // namespace simdsp
+
+#if SIMDSP_STATIC_DISPATCH
+
+namespace simdsp {
+
+/*
+ * The kernels behind the above, as src/dispatched declares them.  Static builds call them directly, so the wrappers
+ * cost nothing and, with link-time optimization, the kernels can be inlined into the caller's loop.
+ */
+namespace SIMDSP_BASELINE_ARCH_NAMESPACE {
+void mixGainRamp(const float *input, float *output, unsigned int frames, unsigned int channels, float gain_start,
+                 float gain_end, bool add);
+void mixMatrix(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+               unsigned int frames, const float *from_matrix, const float *to_matrix, bool add);
+void interleaveChannels(const float *const *planar, unsigned int channels, unsigned int frames, float *output);
+void deinterleaveChannels(const float *input, unsigned int channels, unsigned int frames, float *const *planar);
+} // namespace SIMDSP_BASELINE_ARCH_NAMESPACE
+
+inline void mixGain(const float *input, float *output, unsigned int frames, unsigned int channels, float gain,
+                    bool add) {
+  SIMDSP_BASELINE_ARCH_NAMESPACE::mixGainRamp(input, output, frames, channels, gain, gain, add);
+}
+
+inline void mixGainRamp(const float *input, float *output, unsigned int frames, unsigned int channels, float gain_start,
+                        float gain_end, bool add) {
+  SIMDSP_BASELINE_ARCH_NAMESPACE::mixGainRamp(input, output, frames, channels, gain_start, gain_end, add);
+}
+
+inline void mixMatrix(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+                      unsigned int frames, const float *matrix, bool add) {
+  SIMDSP_BASELINE_ARCH_NAMESPACE::mixMatrix(input, input_channels, output, output_channels, frames, matrix, nullptr,
+                                            add);
+}
+
+inline void mixMatrixRamp(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+                          unsigned int frames, const float *from_matrix, const float *to_matrix, bool add) {
+  SIMDSP_BASELINE_ARCH_NAMESPACE::mixMatrix(input, input_channels, output, output_channels, frames, from_matrix,
+                                            to_matrix, add);
+}
+
+inline void interleaveChannels(const float *const *planar, unsigned int channels, unsigned int frames, float *output) {
+  SIMDSP_BASELINE_ARCH_NAMESPACE::interleaveChannels(planar, channels, frames, output);
+}
+
+inline void deinterleaveChannels(const float *input, unsigned int channels, unsigned int frames, float *const *planar) {
+  SIMDSP_BASELINE_ARCH_NAMESPACE::deinterleaveChannels(input, channels, frames, planar);
+}
+
+} // namespace simdsp
+
+#endif
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "simdsp/feature_macros.hpp"
+
+#include <stdint.h>
+
+namespace simdsp {
+
+/*
+ * Conversion between float samples and the integer formats devices and files use.
+ *
+ * Like the rest of simdsp/mixing, these are compiled once per instruction set and dispatched at runtime (or called
+ * directly in static builds), with 1, 2, 4, and 8 channels fixed at compile time.  The interleaving variants convert
+ * and change layout in the same pass, so planar float buffers go to and from interleaved integer buffers without an
+ * intermediate float copy.
+ *
+ * Full scale is 2^(bits - 1) in both directions: the most negative integer converts to -1.0, and floats are scaled by
+ * the same amount, rounded to nearest, and clamped, so 1.0 and anything above it becomes the most positive integer.
+ * INT32 is the exception, since float can't represent its extremes: it is clamped to +/-(2^31 - 128).  NaN converts
+ * to full scale with its sign.
+ */
+
+enum class SampleFormat {
+  INT16,
+  // 3 bytes per sample, little-endian, as in WAV files and the devices which use it.
+  INT24_PACKED,
+  INT32,
+};
+
+/**
+ * Bytes per sample of format.
+ */
+unsigned int getSampleFormatBytes(SampleFormat format);
+
+static const unsigned int SAMPLE_DITHER_LANES = 16;
+
+/**
+ * State for triangular (TPDF) dither of 1 LSB peak, added before rounding so that quantization error is noise
+ * independent of the signal rather than distortion following it.
+ *
+ * The generator is a xorshift per lane, wide enough for the widest vectors, so producing the noise vectorizes like
+ * everything else; each 32-bit output is split into the two uniform halves whose sum is triangular.  Dither is only
+ * applied to INT16 and INT24_PACKED: float doesn't have the precision to dither INT32.
+ *
+ * Use one per stream, since the state advances with every sample converted.  Plain data, so it can be copied to fork a
+ * stream.
+ */
+struct SampleDither {
+  explicit SampleDither(uint64_t seed = 0);
+
+  uint32_t state[SAMPLE_DITHER_LANES];
+};
+
+/**
+ * Convert samples samples, with any layout, between float and format.  dither may be nullptr to round without it.
+ */
+void convertFloatToSamples(const float *input, unsigned int samples, SampleFormat format, void *output,
+                           SampleDither *dither = nullptr);
+void convertSamplesToFloat(const void *input, unsigned int samples, SampleFormat format, float *output);
+
+/**
+ * Convert channels planar float buffers of frames samples each to one interleaved buffer in format, and back.
+ */
+void interleaveFloatToSamples(const float *const *planar, unsigned int channels, unsigned int frames,
+                              SampleFormat format, void *output, SampleDither *dither = nullptr);
+void deinterleaveSamplesToFloat(const void *input, unsigned int channels, unsigned int frames, SampleFormat format,
+                                float *const *planar);
+
+} // namespace simdsp
+
+#if SIMDSP_STATIC_DISPATCH
+
+namespace simdsp {
+
+/*
+ * As in simdsp/mixing/mixing.hpp: the kernels, which static builds call directly.
+ */
+namespace SIMDSP_BASELINE_ARCH_NAMESPACE {
+void encodeSamples(const float *const *planar, unsigned int channels, unsigned int frames, SampleFormat format,
+                   void *output, uint32_t *dither);
+void decodeSamples(const void *input, unsigned int channels, unsigned int frames, SampleFormat format,
+                   float *const *planar);
+} // namespace SIMDSP_BASELINE_ARCH_NAMESPACE
+
+inline void convertFloatToSamples(const float *input, unsigned int samples, SampleFormat format, void *output,
+                                  SampleDither *dither) {
+  // Any layout is one channel as far as the kernels are concerned.
+  SIMDSP_BASELINE_ARCH_NAMESPACE::encodeSamples(&input, 1, samples, format, output, dither ? dither->state : nullptr);
+}
+
+inline void convertSamplesToFloat(const void *input, unsigned int samples, SampleFormat format, float *output) {
+  SIMDSP_BASELINE_ARCH_NAMESPACE::decodeSamples(input, 1, samples, format, &output);
+}
+
+inline void interleaveFloatToSamples(const float *const *planar, unsigned int channels, unsigned int frames,
+                                     SampleFormat format, void *output, SampleDither *dither) {
+  SIMDSP_BASELINE_ARCH_NAMESPACE::encodeSamples(planar, channels, frames, format, output,
+                                                dither ? dither->state : nullptr);
+}
+
+inline void deinterleaveSamplesToFloat(const void *input, unsigned int channels, unsigned int frames,
+                                       SampleFormat format, float *const *planar) {
+  SIMDSP_BASELINE_ARCH_NAMESPACE::decodeSamples(input, channels, frames, format, planar);
+}
+
+} // namespace simdsp
+
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "simdsp/aligned_memory.hpp"
+
+#include <memory>
+#include <stdint.h>
+
+namespace simdsp {
+
+struct PolyphaseTable;
+
+/**
+ * Taps per phase of the resampling filter: more taps give a sharper transition band and better stopband rejection, at
+ * a proportional cost.
+ */
+enum class ResamplerQuality {
+  // 16 taps.
+  LOW,
+  // 32 taps.
+  MEDIUM,
+  // 64 taps.
+  HIGH,
+};
+
+/**
+ * A streaming polyphase windowed-sinc resampler.
+ *
+ * The filter is a Kaiser-windowed sinc, cut off below the lower of the two Nyquist frequencies, split into phases.
+ * Each output frame is one dot product of the input around it against the phase for its fractional position, run
+ * through runtime dispatch (see simdsp/dispatch.hpp) with the same channel specializations as the direct convolution
+ * kernels.
+ *
+ * There are two modes:
+ *
+ * - Rational (the default): the ratio between the rates is reduced to up / down, and if up is small enough (it is for
+ *   all the usual rates, e.g. 160 / 147 for 44.1 to 48 kHz) there is one phase per distinct fractional position, so
+ *   the conversion is exact up to the filter itself.
+ * - Variable: the ratio can be changed with setRatio at any time, for pitch shifting or drift correction.  Positions
+ *   are tracked in fixed point and the filter is linearly interpolated between a fixed number of phases.  The
+ *   anti-aliasing cutoff still comes from the rates given at construction, so ratios which lower the output rate much
+ *   further alias; construct with the lowest output rate you expect.
+ *
+ * Phase tables are immutable and follow the simdsp alignment convention.  They are shared between every resampler with
+ * the same quality, ratio, and mode, and live until the process exits.
+ *
+ * Input and output are interleaved.  Output frame n is the input signal at time n * input_rate / output_rate, so the
+ * output is time-aligned with the input, but it can only be produced once half the filter's taps past it have arrived:
+ * see getLatency.  Any amount of input may be given to process, which writes however many output frames it can.
+ *
+ * Not thread safe.  After construction, nothing allocates.
+ */
+class PolyphaseResampler {
+public:
+  PolyphaseResampler(unsigned int channels, unsigned int input_rate, unsigned int output_rate,
+                     ResamplerQuality quality = ResamplerQuality::MEDIUM, bool variable = false);
+  ~PolyphaseResampler();
+
+  /**
+   * Consume all of input and write the output frames that are now ready, returning how many there were.  output must
+   * have room for getMaxOutputFrames(input_frames) frames.
+   */
+  unsigned int process(const float *input, unsigned int input_frames, float *output);
+
+  /**
+   * The most frames the next call to process can write for the given number of input frames, at the current ratio.
+   */
+  unsigned int getMaxOutputFrames(unsigned int input_frames) const;
+
+  /**
+   * Change the ratio of output rate to input rate, taking effect from the next output frame.  Only for variable
+   * resamplers, and only accurate to the 32-bit fixed point positions are tracked in.
+   */
+  void setRatio(double ratio);
+
+  /**
+   * How many input frames past the time of an output frame must arrive before it is written.
+   */
+  unsigned int getLatency() const { return taps / 2; }
+
+  /**
+   * Forget all history and start again at time 0.
+   */
+  void reset();
+
+  unsigned int getChannels() const { return channels; }
+  bool isVariable() const { return variable; }
+
+private:
+  /*
+   * Produce every output frame whose taps are all in history, then drop the history no future frame needs.
+   */
+  unsigned int drain(float *output);
+
+  unsigned int channels, taps;
+  bool variable;
+  std::shared_ptr<const PolyphaseTable> table;
+
+  // Positions are frame + frac / frac_denominator, in input frames from the start of history, and advance by
+  // step_frames + step_frac / frac_denominator per output frame.  The denominator is the number of phases for rational
+  // resamplers, and 2^32 for variable ones (or rational ones with too many phases).
+  uint64_t frac_denominator;
+  unsigned int frame = 0;
+  uint64_t frac = 0;
+  unsigned int step_frames;
+  uint64_t step_frac;
+
+  // Interleaved input waiting to be used, history_frames of which are valid.
+  AlignedBuffer<float> history;
+  unsigned int history_frames = 0, history_capacity;
+};
+
+} // namespace simdsp
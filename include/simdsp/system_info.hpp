@@ -34,10 +34,11 @@ struct CpuBit {
 /*
  * These are bitflags.
  *
- * We only concern ourselves with X86 for now.
+ * Unlike the original libsimdpp implementation, we only really concern ourselves with the major ones: SSE2/AVX/AVX2/
+ * AVX-512 on x86, and NEON/SVE on AArch64, plus the few extensions around them which decide what a kernel can use.
  *
- * Unlike the original libsimdpp implementation, we also only really concern ourselves with the major ones:
- * SSE2/AVX/AVX2.
+ * A bit is only set if the OS also saves the registers the feature uses: on x86, the AVX bits need XCR0's ymm state and
+ * the AVX-512 bits also need its opmask and zmm state.  So everything here is safe to execute.
  * */
 class CpuCapabilities {
 public:
@@ -48,7 +49,11 @@ public:
       X86_AVX{"x86_avx", 1 << 6}, X86_AVX2{"x86_avx2", 1 << 7}, X86_FMA3{"x86_fma3", 1 << 8},
       X86_FMA4{"x86_fma4", 1 << 9}, X86_XOP{"x86_xop", 1 << 10}, X86_AVX512F{"x86_avx512f", 1 << 11},
       X86_AVX512BW{"x86_avx512bw", 1 << 12}, X86_AVX512DQ{"x86_avx512dq", 1 << 13},
-      X86_AVX512VL{"x86_avx512vl", 1 << 14};
+      X86_AVX512VL{"x86_avx512vl", 1 << 14}, AARCH64_NEON{"aarch64_neon", 1 << 15},
+      AARCH64_FP16{"aarch64_fp16", 1 << 16}, AARCH64_DOTPROD{"aarch64_dotprod", 1 << 17},
+      AARCH64_SVE{"aarch64_sve", 1 << 18}, AARCH64_SVE2{"aarch64_sve2", 1 << 19}, X86_F16C{"x86_f16c", 1 << 20},
+      X86_AVX512VNNI{"x86_avx512vnni", 1 << 21}, X86_AVX512BF16{"x86_avx512bf16", 1 << 22},
+      X86_AVX512FP16{"x86_avx512fp16", 1 << 23}, X86_AVX_VNNI{"x86_avx_vnni", 1 << 24};
 
   /*
    * these two constants expose a table of all CPU bits except for none for the purposes of iteration.
@@ -94,6 +99,63 @@ struct CpuCaches {
   unsigned int l1i, l1d, l1u, l2i, l2d, l2u, l3i, l3d, l3u;
 };
 
+/*
+ * Most logical CPUs a CpuTopology describes.  Machines with more are described as if they had only the ones the OS
+ * numbers below this.
+ */
+static const unsigned int CPU_TOPOLOGY_MAX_CPUS = 256;
+
+/*
+ * Used in LogicalCpu for a domain which couldn't be determined, e.g. the L3 of a CPU which has none.
+ */
+static const uint16_t CPU_TOPOLOGY_UNKNOWN = 0xffff;
+
+/**
+ * Where one logical CPU (a hardware thread) sits in the machine.
+ *
+ * Everything but os_index is a dense index from 0, in the order the OS numbers CPUs: two CPUs with the same core are
+ * SMT siblings, two with the same l3_domain share an L3, and so on.
+ */
+struct LogicalCpu {
+  /*
+   * The number the OS knows this CPU by, for sched_setaffinity, SetThreadAffinityMask, etc.  Always below
+   * CPU_TOPOLOGY_MAX_CPUS.
+   */
+  uint16_t os_index;
+  uint16_t core, package, numa_node, l2_domain, l3_domain;
+};
+
+/**
+ * The shape of the machine, for placing threads: e.g. one audio worker per physical core, per L3 domain, so that
+ * workers neither share a core's execution units with each other nor pull each other's data across dies.
+ *
+ * On Linux this comes from /sys/devices/system/cpu and /sys/devices/system/node, on both x86 and AArch64.  Elsewhere on
+ * x86, counts come from CPUID leaf 0x1F or 0xB and the cache leaves, and CPUs are assumed to be numbered package by
+ * package with SMT siblings adjacent, which is what Windows and macOS do, and each package to be a NUMA node.
+ * Elsewhere on AArch64 only logical_cores is known, and every CPU is assumed to be its own core.
+ */
+struct CpuTopology {
+  unsigned int logical_cores, physical_cores, packages, numa_nodes;
+
+  /*
+   * The number of distinct L2s and L3s, i.e. the number of groups of CPUs sharing one.  0 if unknown.
+   */
+  unsigned int l2_domains, l3_domains;
+
+  /*
+   * logical_cores of these, sorted by os_index.
+   */
+  LogicalCpu cpus[CPU_TOPOLOGY_MAX_CPUS];
+};
+
+/**
+ * Get the OS indices of the CPUs which share cpus[cpu]'s L2 or L3 cache (level is 2 or 3), including itself, as a mask
+ * of CPU_TOPOLOGY_MAX_CPUS bits: bit i is bit i % 64 of mask[i / 64].  Returns false and clears the mask if the sharing
+ * isn't known.
+ */
+bool getCacheSharingMask(const CpuTopology *topology, unsigned int cpu, unsigned int level,
+                         uint64_t mask[CPU_TOPOLOGY_MAX_CPUS / 64]);
+
 enum class CpuManufacturer { UNKNOWN, INTEL, AMD, APPLE };
 
 enum class CpuArchitecture { AARCH64, X86 };
@@ -106,6 +168,27 @@ struct SystemInfo {
   CpuManufacturer cpu_manufacturer;
   CpuArchitecture cpu_architecture;
   CpuCaches cache_info;
+
+  /*
+   * Whether the CPU can treat denormal inputs as zero, as well as flushing denormal results to zero; see
+   * simdsp/denormals.hpp.  On x86 this is the DAZ bit of MXCSR, which a few early SSE2 parts lack.  On AArch64 it is
+   * always true, since FPCR.FZ does both.
+   */
+  bool daz_supported;
+
+  CpuTopology topology;
+
+  /*
+   * The SVE vector length in bytes, from 16 to 256, or 0 without SVE.  Unlike x86, the ISA doesn't fix it.
+   */
+  unsigned int sve_vector_bytes;
+
+  /*
+   * Whether heavy 512-bit work is known to lower this CPU's clock for a while afterwards (the AVX-512 frequency
+   * licenses of Intel's Skylake-SP to Tiger Lake).  A hint only: automatic dispatch still picks AVX-512 where it can
+   * run, and callers who would rather not can force a narrower variant.
+   */
+  bool avx512_downclocks;
 };
 
 /**
@@ -116,7 +199,8 @@ struct SystemInfo {
 SystemInfo getSystemInfoUncached();
 
 /*
- * Get cached system information.  After the first slow invocation, this function is an atomic load.
+ * Get cached system information.  After the first slow invocation, this function is an atomic load and a copy of a few
+ * kilobytes, most of it the topology; hot paths should keep what they need.
  */
 SystemInfo getSystemInfo();
 
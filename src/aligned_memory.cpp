@@ -0,0 +1,86 @@
+#include "simdsp/aligned_memory.hpp"
+
+#include "simdsp/system_info.hpp"
+
+#include <assert.h>
+#include <new>
+#include <string.h>
+
+namespace simdsp {
+
+static size_t computeSimdAlignment() {
+  SystemInfo info = getSystemInfo();
+
+  if (info.cpu_capabilities & CpuCapabilities::X86_AVX512F) {
+    return 64;
+  }
+  if (info.cpu_capabilities & CpuCapabilities::X86_AVX) {
+    return 32;
+  }
+  if (info.sve_vector_bytes > 16) {
+    return info.sve_vector_bytes < MAX_SIMD_ALIGNMENT ? info.sve_vector_bytes : MAX_SIMD_ALIGNMENT;
+  }
+  // SSE2 and NEON.
+  return 16;
+}
+
+size_t getSimdAlignment() {
+  static const size_t alignment = computeSimdAlignment();
+  return alignment;
+}
+
+size_t padToSimdAlignment(size_t count, size_t element_size) {
+  size_t alignment = getSimdAlignment();
+  assert(element_size != 0 && alignment % element_size == 0);
+  size_t per_vector = alignment / element_size;
+  return (count + per_vector - 1) / per_vector * per_vector;
+}
+
+void *alignedAllocate(size_t bytes) {
+  bytes = padToSimdAlignment(bytes, 1);
+  if (bytes == 0) {
+    bytes = getSimdAlignment();
+  }
+
+  // Always MAX_SIMD_ALIGNMENT, so that alignedFree doesn't need to know which alignment was in effect.
+  void *ret = ::operator new(bytes, std::align_val_t(MAX_SIMD_ALIGNMENT), std::nothrow);
+  if (ret != nullptr) {
+    memset(ret, 0, bytes);
+  }
+  return ret;
+}
+
+void alignedFree(void *ptr) {
+  if (ptr != nullptr) {
+    ::operator delete(ptr, std::align_val_t(MAX_SIMD_ALIGNMENT));
+  }
+}
+
+AlignedArena::AlignedArena(size_t capacity_bytes) {
+  capacity = padToSimdAlignment(capacity_bytes, 1);
+  memory = (unsigned char *)alignedAllocate(capacity);
+  if (memory == nullptr) {
+    capacity = 0;
+  }
+}
+
+AlignedArena::~AlignedArena() { alignedFree(memory); }
+
+void *AlignedArena::allocateBytes(size_t bytes) {
+  // used is always a multiple of the alignment, and so is bytes.
+  if (bytes == 0 || bytes > capacity - used) {
+    return nullptr;
+  }
+
+  unsigned char *ret = memory + used;
+  used += bytes;
+  memset(ret, 0, bytes);
+  return ret;
+}
+
+void AlignedArena::rewind(size_t mark) {
+  assert(mark <= used);
+  used = mark;
+}
+
+} // namespace simdsp
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+ * Work which the audio thread hands to a ConvolutionWorker, and can take back if the worker doesn't get to it in time.
+ */
+
+#include "spsc_queue.hpp"
+
+#include <atomic>
+
+namespace simdsp {
+
+class ConvolutionWorker;
+
+enum : unsigned int {
+  BACKGROUND_TASK_IDLE = 0,
+  BACKGROUND_TASK_QUEUED,
+  BACKGROUND_TASK_RUNNING,
+  BACKGROUND_TASK_DONE,
+  // The audio thread took the task back and ran it itself.  The worker skips these.
+  BACKGROUND_TASK_STOLEN,
+  // The queue was full, so submitTask ran the task inline.  The worker never saw it, but it was still late.
+  BACKGROUND_TASK_OVERFLOWED,
+};
+
+/*
+ * Whatever run touches must not be touched by the audio thread between submitTask and finishTask.
+ *
+ * A task is in the queue at most once.  Stealing leaves its entry behind, and rather than push another, submitTask
+ * lets the worker's eventual pop of that entry pick the new submission up.
+ */
+struct BackgroundTask {
+  std::atomic<unsigned int> state{BACKGROUND_TASK_IDLE};
+  // Set by submitTask when it pushes the task, cleared by the worker when it pops it.
+  std::atomic<bool> in_queue{false};
+  void (*run)(void *userdata) = nullptr;
+  void *userdata = nullptr;
+  // Whether the submitting thread had denormals flushed, which the worker matches (see simdsp/denormals.hpp).  Written
+  // before the task is published, so the queue orders it.
+  bool flush_denormals = false;
+};
+
+/*
+ * The tasks of one owner (e.g. one convolver).  The owner's thread produces, the worker thread consumes.
+ */
+struct BackgroundTaskQueue {
+  explicit BackgroundTaskQueue(unsigned int capacity) : queue(capacity) {}
+
+  SpscQueue<BackgroundTask *> queue;
+  ConvolutionWorker *worker = nullptr;
+};
+
+/*
+ * Hand a task to the worker.  Returns false if the queue is full, in which case the task has been run inline.  The
+ * task must be idle.
+ */
+bool submitTask(BackgroundTaskQueue *queue, BackgroundTask *task);
+
+/*
+ * Called by the worker with each task it pops.
+ */
+void runTaskIfQueued(BackgroundTask *task);
+
+/*
+ * Wait for a submitted task, running it inline if the worker hasn't started it.  Returns true if the task was not
+ * already done or overflowed the queue, i.e. the result was late.  The task is idle again afterwards.
+ *
+ * If the worker is part way through the task, this spins until it finishes: the caller blocks for however long the
+ * rest of the task takes on the worker.
+ */
+bool finishTask(BackgroundTask *task);
+
+} // namespace simdsp
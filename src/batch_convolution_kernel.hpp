@@ -0,0 +1,12 @@
+#pragma once
+
+namespace simdsp {
+
+/*
+ * Lanes per group in the dispatched batchBlockConvolver, which sizes its workspace.  This is a full AVX-512 vector,
+ * and several narrower ones, so that every variant is always working on whole vectors.  Plain data, since this is
+ * included from dispatched code.
+ */
+static const unsigned int BATCH_CONVOLUTION_LANES = 16;
+
+} // namespace simdsp
@@ -0,0 +1,53 @@
+#pragma once
+
+/*
+ * Cache sizes for sizing tiles and choosing algorithms, with fallbacks for when getSystemInfo() can't tell us.  Vanilla
+ * code only.
+ */
+
+#include "simdsp/system_info.hpp"
+
+namespace simdsp {
+
+/*
+ * Assumed cache sizes when getSystemInfo() can't tell us.
+ */
+static const unsigned int DEFAULT_L1D = 32 * 1024;
+static const unsigned int DEFAULT_L2 = 256 * 1024;
+
+inline unsigned int computeL1dSize() {
+  CpuCaches caches = getSystemInfo().cache_info;
+  if (caches.l1d != 0) {
+    return caches.l1d;
+  }
+  if (caches.l1u != 0) {
+    return caches.l1u;
+  }
+  return DEFAULT_L1D;
+}
+
+inline unsigned int computeL2Size() {
+  CpuCaches caches = getSystemInfo().cache_info;
+  if (caches.l2u != 0) {
+    return caches.l2u;
+  }
+  if (caches.l2d != 0) {
+    return caches.l2d;
+  }
+  return DEFAULT_L2;
+}
+
+/*
+ * Cached, since these are asked for per call in places, and getSystemInfo() copies the whole topology.
+ */
+inline unsigned int getL1dSize() {
+  static const unsigned int size = computeL1dSize();
+  return size;
+}
+
+inline unsigned int getL2Size() {
+  static const unsigned int size = computeL2Size();
+  return size;
+}
+
+} // namespace simdsp
@@ -0,0 +1,23 @@
+#include "simdsp/convolution/batch_convolution.hpp"
+
+#include "batch_convolution_kernel.hpp"
+#include "dispatch.hpp"
+
+#include <assert.h>
+
+namespace simdsp {
+
+unsigned int getBatchBlockConvolverWorkspaceSize(unsigned int input_len, unsigned int impulse_len) {
+  assert(impulse_len != 0);
+  // Transposed history plus block, impulse, and output.
+  return BATCH_CONVOLUTION_LANES * ((impulse_len - 1 + input_len) + impulse_len + input_len);
+}
+
+void batchBlockConvolver(const BatchConvolutionJob *jobs, unsigned int job_count, unsigned int channels,
+                         unsigned int input_len, unsigned int impulse_len, float *workspace) {
+  // The kernel reads impulse_len - 1 frames of history, which would wrap.
+  assert(channels != 0 && impulse_len != 0);
+  getDispatchTable()->batchBlockConvolver(jobs, job_count, channels, input_len, impulse_len, workspace);
+}
+
+} // namespace simdsp
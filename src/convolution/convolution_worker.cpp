@@ -0,0 +1,148 @@
+#include "simdsp/convolution/convolution_worker.hpp"
+
+#include "simdsp/denormals.hpp"
+#include "simdsp/feature_macros.hpp"
+
+#include "background_task.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#if SIMDSP_IS_X86
+#include <immintrin.h>
+#elif SIMDSP_IS_AARCH64 && _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace simdsp {
+
+/*
+ * The audio thread wakes the worker without taking wake_lock, and only if it has seen the worker go to sleep, so a
+ * wakeup can occasionally be missed.  This bounds how long that costs.
+ */
+static const std::chrono::microseconds WORKER_POLL_INTERVAL{500};
+
+/*
+ * For spin loops: tells the core we're waiting, which stops a hyperthreaded sibling (possibly the worker) from being
+ * starved and avoids a pipeline flush on the way out of the loop.
+ */
+static inline void pauseCpu() {
+#if SIMDSP_IS_X86
+  _mm_pause();
+#elif _MSC_VER
+  __yield();
+#else
+  __asm__ __volatile__("yield");
+#endif
+}
+
+bool submitTask(BackgroundTaskQueue *queue, BackgroundTask *task) {
+  task->flush_denormals = areDenormalsFlushed();
+  // QUEUED must be at least a release, so that the worker's acquire of it orders everything written for the task before
+  // it.  It and the in_queue operations are sequentially consistent with the worker's, so if the exchange finds an old
+  // entry still in the queue, the worker clears in_queue after that and sees QUEUED when it goes on to the state.
+  task->state.store(BACKGROUND_TASK_QUEUED, std::memory_order_seq_cst);
+  if (task->in_queue.exchange(true, std::memory_order_seq_cst) == false && queue->queue.push(task) == false) {
+    task->in_queue.store(false, std::memory_order_relaxed);
+    task->state.store(BACKGROUND_TASK_OVERFLOWED, std::memory_order_relaxed);
+    task->run(task->userdata);
+    return false;
+  }
+  queue->worker->wake();
+  return true;
+}
+
+void runTaskIfQueued(BackgroundTask *task) {
+  task->in_queue.store(false, std::memory_order_seq_cst);
+  unsigned int expected = BACKGROUND_TASK_QUEUED;
+  if (task->state.compare_exchange_strong(expected, BACKGROUND_TASK_RUNNING, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed) == false) {
+    return;
+  }
+  if (task->flush_denormals) {
+    DenormalGuard guard;
+    task->run(task->userdata);
+  } else {
+    task->run(task->userdata);
+  }
+  task->state.store(BACKGROUND_TASK_DONE, std::memory_order_release);
+}
+
+bool finishTask(BackgroundTask *task) {
+  unsigned int state = task->state.load(std::memory_order_acquire);
+  // The worker having fallen so far behind that the queue filled up is the latest a result can be.
+  bool late = state == BACKGROUND_TASK_OVERFLOWED;
+
+  if (state == BACKGROUND_TASK_QUEUED) {
+    late = true;
+    if (task->state.compare_exchange_strong(state, BACKGROUND_TASK_STOLEN, std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+      task->run(task->userdata);
+      state = BACKGROUND_TASK_STOLEN;
+    }
+  }
+
+  // Either the worker is part way through it, or got to it between the load and the exchange.  All we can do is wait,
+  // and it won't be long since it's already running.
+  while (state == BACKGROUND_TASK_RUNNING || state == BACKGROUND_TASK_QUEUED) {
+    late = true;
+    pauseCpu();
+    state = task->state.load(std::memory_order_acquire);
+  }
+
+  task->state.store(BACKGROUND_TASK_IDLE, std::memory_order_relaxed);
+  return late;
+}
+
+ConvolutionWorker::ConvolutionWorker() : thread([this]() { workerThread(); }) {}
+
+ConvolutionWorker::~ConvolutionWorker() {
+  stopping.store(true, std::memory_order_relaxed);
+  wake_cond.notify_one();
+  thread.join();
+}
+
+void ConvolutionWorker::attach(BackgroundTaskQueue *queue) {
+  std::lock_guard<std::mutex> guard(queues_lock);
+  queue->worker = this;
+  queues.push_back(queue);
+}
+
+void ConvolutionWorker::detach(BackgroundTaskQueue *queue) {
+  std::lock_guard<std::mutex> guard(queues_lock);
+  queues.erase(std::remove(queues.begin(), queues.end(), queue), queues.end());
+}
+
+void ConvolutionWorker::wake() {
+  // notify_one takes the condition variable's internal lock and may make a syscall, so it's only worth it when the
+  // worker is actually waiting, and only once per wait.
+  if (sleeping.exchange(false, std::memory_order_seq_cst)) {
+    wake_cond.notify_one();
+  }
+}
+
+void ConvolutionWorker::workerThread() {
+  while (stopping.load(std::memory_order_relaxed) == false) {
+    bool did_work = false;
+
+    {
+      std::lock_guard<std::mutex> guard(queues_lock);
+      for (BackgroundTaskQueue *queue : queues) {
+        BackgroundTask *task;
+        while (queue->queue.pop(task)) {
+          runTaskIfQueued(task);
+          did_work = true;
+        }
+      }
+    }
+
+    if (did_work == false) {
+      std::unique_lock<std::mutex> guard(wake_lock);
+      sleeping.store(true, std::memory_order_seq_cst);
+      wake_cond.wait_for(guard, WORKER_POLL_INTERVAL);
+      sleeping.store(false, std::memory_order_relaxed);
+    }
+  }
+}
+
+} // namespace simdsp
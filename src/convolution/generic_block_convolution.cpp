@@ -0,0 +1,12 @@
+#include "simdsp/convolution/generic_block_convolution.hpp"
+
+#include "dispatch.hpp"
+
+namespace simdsp {
+
+void genericBlockConvolver(float *input, unsigned int input_len, unsigned int input_channels, float *impulse,
+                           unsigned int impulse_len, float *output, const OutputMode &mode) {
+  getDispatchTable()->genericBlockConvolver(input, input_len, input_channels, impulse, impulse_len, output, &mode);
+}
+
+} // namespace simdsp
@@ -0,0 +1,337 @@
+#include "simdsp/convolution/impulse_spectra.hpp"
+
+#include "simdsp/aligned_memory.hpp"
+#include "simdsp/fft.hpp"
+
+#include "impulse_transform.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace simdsp {
+
+/*
+ * The file layout.  Everything is in the writer's byte order, which byte_order_mark lets readers check.
+ *
+ * - FileHeader, padded to MAX_SIMD_ALIGNMENT bytes.
+ * - count IndexEntry structs, starting at index_offset.
+ * - The spectra.  Every re and im array starts at a multiple of MAX_SIMD_ALIGNMENT from the start of the file, and
+ *   mappings start on a page boundary, so they're aligned in memory too.
+ *
+ * Bump FILE_VERSION on any change to this or to what the spectra mean (their scaling, the partitioning, the stride).
+ */
+static const char FILE_MAGIC[8] = {'S', 'I', 'M', 'D', 'S', 'P', 'I', 'S'};
+static const uint32_t FILE_VERSION = 1;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order_mark;
+  uint32_t block_size;
+  uint32_t channels;
+  uint32_t spectrum_stride;
+  uint32_t count;
+  uint64_t index_offset;
+};
+
+struct IndexEntry {
+  uint32_t impulse_len;
+  uint32_t partition_count;
+  uint64_t re_offset;
+  uint64_t im_offset;
+};
+
+static_assert(sizeof(FileHeader) <= MAX_SIMD_ALIGNMENT, "The header must fit before the first aligned offset");
+
+static uint64_t alignFileOffset(uint64_t offset) {
+  return (offset + MAX_SIMD_ALIGNMENT - 1) / MAX_SIMD_ALIGNMENT * MAX_SIMD_ALIGNMENT;
+}
+
+static unsigned int getPartitionCount(unsigned int block_size, unsigned int impulse_len) {
+  return (impulse_len + block_size - 1) / block_size;
+}
+
+void transformImpulsePartitions(const RealFft &fft, unsigned int channels, unsigned int partition_count,
+                                unsigned int spectrum_stride, const float *impulse, unsigned int impulse_len,
+                                float *out_re, float *out_im, float *time_block, float *workspace) {
+  unsigned int block_size = fft.getSize() / 2;
+  assert(impulse_len <= partition_count * block_size);
+  assert(spectrum_stride >= fft.getBinCount());
+
+  // Each partition is block_size samples of impulse followed by block_size zeros, which is what makes the last
+  // block_size samples of each circular convolution alias-free.
+  float scale = 1.0f / (float)fft.getSize();
+  for (unsigned int ch = 0; ch < channels; ch++) {
+    for (unsigned int p = 0; p < partition_count; p++) {
+      std::fill(time_block, time_block + fft.getSize(), 0.0f);
+      for (unsigned int i = 0; i < block_size; i++) {
+        size_t frame = (size_t)p * block_size + i;
+        if (frame >= impulse_len) {
+          break;
+        }
+        time_block[i] = impulse[frame * channels + ch] * scale;
+      }
+
+      size_t offset = ((size_t)ch * partition_count + p) * spectrum_stride;
+      fft.forward(time_block, out_re + offset, out_im + offset, workspace);
+      // The FFT only writes the bins; the padding is promised to be zero.
+      std::fill(out_re + offset + fft.getBinCount(), out_re + offset + spectrum_stride, 0.0f);
+      std::fill(out_im + offset + fft.getBinCount(), out_im + offset + spectrum_stride, 0.0f);
+    }
+  }
+}
+
+unsigned int getImpulseSpectraStride(unsigned int block_size) {
+  const unsigned int floats_per_alignment = MAX_SIMD_ALIGNMENT / sizeof(float);
+  return (block_size + 1 + floats_per_alignment - 1) / floats_per_alignment * floats_per_alignment;
+}
+
+static bool writeImpulseSpectra(FILE *f, unsigned int block_size, unsigned int channels, unsigned int impulse_count,
+                                const float *const *impulses, const unsigned int *impulse_lens) {
+  unsigned int stride = getImpulseSpectraStride(block_size);
+
+  FileHeader header{};
+  memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+  header.version = FILE_VERSION;
+  header.byte_order_mark = BYTE_ORDER_MARK;
+  header.block_size = block_size;
+  header.channels = channels;
+  header.spectrum_stride = stride;
+  header.count = impulse_count;
+  header.index_offset = MAX_SIMD_ALIGNMENT;
+
+  // Spectrum arrays are a whole number of strides, so once the first is aligned they all are.
+  std::vector<IndexEntry> index(impulse_count);
+  uint64_t offset = alignFileOffset(header.index_offset + sizeof(IndexEntry) * (uint64_t)impulse_count);
+  for (unsigned int i = 0; i < impulse_count; i++) {
+    index[i].impulse_len = impulse_lens[i];
+    index[i].partition_count = getPartitionCount(block_size, impulse_lens[i]);
+    uint64_t array_bytes = (uint64_t)channels * index[i].partition_count * stride * sizeof(float);
+    index[i].re_offset = offset;
+    index[i].im_offset = offset + array_bytes;
+    offset += 2 * array_bytes;
+  }
+
+  static const unsigned char zeros[MAX_SIMD_ALIGNMENT] = {};
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+            fwrite(zeros, header.index_offset - sizeof(header), 1, f) == 1 &&
+            (impulse_count == 0 || fwrite(&index[0], sizeof(IndexEntry), impulse_count, f) == impulse_count);
+  uint64_t index_end = header.index_offset + sizeof(IndexEntry) * (uint64_t)impulse_count;
+  if (ok && alignFileOffset(index_end) != index_end) {
+    ok = fwrite(zeros, alignFileOffset(index_end) - index_end, 1, f) == 1;
+  }
+
+  std::shared_ptr<const RealFft> fft = getRealFft(block_size * 2);
+  AlignedBuffer<float> time_block(fft->getSize()), workspace(fft->getWorkspaceSize()), re, im;
+  for (unsigned int i = 0; ok && i < impulse_count; i++) {
+    size_t array_len = (size_t)channels * index[i].partition_count * stride;
+    re.resize(array_len);
+    im.resize(array_len);
+    transformImpulsePartitions(*fft, channels, index[i].partition_count, stride, impulses[i], impulse_lens[i],
+                               re.data(), im.data(), time_block.data(), workspace.data());
+    ok = fwrite(re.data(), sizeof(float), array_len, f) == array_len &&
+         fwrite(im.data(), sizeof(float), array_len, f) == array_len;
+  }
+
+  return ok;
+}
+
+bool saveImpulseSpectra(const char *path, unsigned int block_size, unsigned int channels, unsigned int impulse_count,
+                        const float *const *impulses, const unsigned int *impulse_lens) {
+  assert(block_size != 0 && isRealFftSizeSupported(block_size * 2));
+  assert(channels != 0);
+  for (unsigned int i = 0; i < impulse_count; i++) {
+    assert(impulse_lens[i] != 0);
+  }
+
+  std::string temp_path = std::string(path) + ".tmp";
+  FILE *f = fopen(temp_path.c_str(), "wb");
+  if (f == nullptr) {
+    return false;
+  }
+
+  bool ok = writeImpulseSpectra(f, block_size, channels, impulse_count, impulses, impulse_lens);
+  ok = fclose(f) == 0 && ok;
+
+#ifdef _WIN32
+  // rename won't replace an existing file on Windows.
+  ok = ok && MoveFileExA(temp_path.c_str(), path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+  ok = ok && rename(temp_path.c_str(), path) == 0;
+#endif
+  if (!ok) {
+    remove(temp_path.c_str());
+  }
+  return ok;
+}
+
+/*
+ * a * b, or false if that doesn't fit in 64 bits.
+ */
+static bool multiplyChecked(uint64_t a, uint64_t b, uint64_t *out) {
+  if (a != 0 && b > UINT64_MAX / a) {
+    return false;
+  }
+  *out = a * b;
+  return true;
+}
+
+/*
+ * Check everything a reader relies on, so that getSpectra never has to.  Only the header and index are touched, so this
+ * doesn't fault in any of the spectra.
+ */
+static bool validateMapping(const unsigned char *mapping, size_t len) {
+  if (len < sizeof(FileHeader)) {
+    return false;
+  }
+
+  FileHeader header;
+  memcpy(&header, mapping, sizeof(header));
+  if (memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION ||
+      header.byte_order_mark != BYTE_ORDER_MARK) {
+    return false;
+  }
+  if (header.block_size == 0 || header.block_size > UINT32_MAX / 2 || !isRealFftSizeSupported(header.block_size * 2) ||
+      header.channels == 0 || header.spectrum_stride != getImpulseSpectraStride(header.block_size)) {
+    return false;
+  }
+  if (header.index_offset % alignof(IndexEntry) != 0 || header.index_offset > len ||
+      (len - header.index_offset) / sizeof(IndexEntry) < header.count) {
+    return false;
+  }
+
+  // Every channel of every entry has at least one spectrum in the file, which bounds channels by the file's size.
+  uint64_t spectrum_bytes = (uint64_t)header.spectrum_stride * sizeof(float);
+  if (header.count != 0 && header.channels > len / spectrum_bytes) {
+    return false;
+  }
+
+  const IndexEntry *index = (const IndexEntry *)(mapping + header.index_offset);
+  for (uint32_t i = 0; i < header.count; i++) {
+    const IndexEntry &entry = index[i];
+    if (entry.impulse_len == 0 || entry.partition_count != getPartitionCount(header.block_size, entry.impulse_len)) {
+      return false;
+    }
+
+    // Header fields are untrusted, so the size of an array mustn't wrap around to something which fits.
+    uint64_t channel_bytes, array_bytes;
+    if (!multiplyChecked(entry.partition_count, spectrum_bytes, &channel_bytes) ||
+        !multiplyChecked(header.channels, channel_bytes, &array_bytes)) {
+      return false;
+    }
+    for (uint64_t offset : {entry.re_offset, entry.im_offset}) {
+      if (offset % MAX_SIMD_ALIGNMENT != 0 || offset > len || len - offset < array_bytes) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+std::unique_ptr<ImpulseSpectraFile> ImpulseSpectraFile::open(const char *path) {
+  std::unique_ptr<ImpulseSpectraFile> file(new ImpulseSpectraFile());
+
+#ifdef _WIN32
+  HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+    CloseHandle(handle);
+    return nullptr;
+  }
+  HANDLE mapping_handle = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(handle);
+  if (mapping_handle == nullptr) {
+    return nullptr;
+  }
+  void *view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    CloseHandle(mapping_handle);
+    return nullptr;
+  }
+  file->mapping = (const unsigned char *)view;
+  file->mapping_len = (size_t)size.QuadPart;
+  file->mapping_handle = mapping_handle;
+#else
+  int fd = ::open(path, O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return nullptr;
+  }
+  void *view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps the file alive.
+  close(fd);
+  if (view == MAP_FAILED) {
+    return nullptr;
+  }
+  file->mapping = (const unsigned char *)view;
+  file->mapping_len = (size_t)st.st_size;
+#endif
+
+  if (!validateMapping(file->mapping, file->mapping_len)) {
+    return nullptr;
+  }
+
+  FileHeader header;
+  memcpy(&header, file->mapping, sizeof(header));
+  file->count = header.count;
+  file->block_size = header.block_size;
+  file->channels = header.channels;
+  file->spectrum_stride = header.spectrum_stride;
+  file->index_offset = (size_t)header.index_offset;
+  return file;
+}
+
+ImpulseSpectraFile::~ImpulseSpectraFile() {
+  if (mapping == nullptr) {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(mapping);
+  CloseHandle((HANDLE)mapping_handle);
+#else
+  munmap((void *)mapping, mapping_len);
+#endif
+}
+
+ImpulseSpectra ImpulseSpectraFile::getSpectra(unsigned int index) const {
+  assert(index < count);
+
+  const IndexEntry &entry = ((const IndexEntry *)(mapping + index_offset))[index];
+
+  ImpulseSpectra ret;
+  ret.block_size = block_size;
+  ret.channels = channels;
+  ret.partition_count = entry.partition_count;
+  ret.spectrum_stride = spectrum_stride;
+  ret.impulse_len = entry.impulse_len;
+  ret.re = (const float *)(mapping + entry.re_offset);
+  ret.im = (const float *)(mapping + entry.im_offset);
+  return ret;
+}
+
+} // namespace simdsp
@@ -0,0 +1,243 @@
+#include "simdsp/convolution/non_uniform_partitioned_convolution.hpp"
+
+#include "background_task.hpp"
+#include "dispatch.hpp"
+#include "simdsp/convolution/convolution_worker.hpp"
+#include "simdsp/convolution/tuning.hpp"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace simdsp {
+
+static unsigned int roundDownToPowerOfTwo(unsigned int x) {
+  unsigned int ret = 1;
+  while (ret * 2 <= x && ret * 2 != 0) {
+    ret *= 2;
+  }
+  return ret;
+}
+
+/*
+ * How much of the impulse the direct head takes: one block normally, or all of it if the impulse is below the tuned
+ * FFT crossover for this block size.
+ */
+static unsigned int getHeadLength(unsigned int block_size, unsigned int impulse_len) {
+  if (impulse_len < getFftCrossover(getConvolutionTuning(), block_size)) {
+    return impulse_len;
+  }
+  return std::min(impulse_len, block_size);
+}
+
+std::vector<PartitionSegment> computeNonUniformPartitionLayout(unsigned int block_size, unsigned int impulse_len,
+                                                               unsigned int max_partition_size) {
+  std::vector<PartitionSegment> layout;
+
+  if (max_partition_size == 0) {
+    // Roughly balances the per-sample cost of the FFTs (grows with log(size)) against the complex MACs (grows with
+    // impulse_len / size) for the final segment.  The cap is where the FFTs stop fitting in cache and the bursts on the
+    // blocks which complete a partition get long, which is machine-dependent.
+    max_partition_size = std::min(impulse_len / 8, getConvolutionTuning().max_partition_size);
+  }
+  max_partition_size = std::max(roundDownToPowerOfTwo(std::max(max_partition_size, 1u)), block_size);
+
+  unsigned int offset = block_size, size = block_size;
+  while (offset < impulse_len) {
+    unsigned int remaining = impulse_len - offset;
+    unsigned int needed = (remaining + size - 1) / size;
+
+    if (size >= max_partition_size || needed <= 2) {
+      layout.push_back(PartitionSegment{offset, size, needed});
+      break;
+    }
+
+    layout.push_back(PartitionSegment{offset, size, 2});
+    offset += 2 * size;
+    size *= 2;
+  }
+
+  return layout;
+}
+
+struct NonUniformPartitionedConvolver::Segment {
+  PartitionSegment shape;
+  std::unique_ptr<UniformPartitionedConvolver> engine;
+  // partition_size interleaved frames of input waiting to be transformed, and how many of them are filled.
+  AlignedBuffer<float> pending_input;
+  unsigned int pending_frames = 0;
+
+  // Everything below is only used if the segment runs on the worker.
+  bool background = false;
+  // Blocks between a partition's input completing and its output first being needed.  Always less than the number of
+  // blocks per partition, so there's never more than one partition of a segment in flight.
+  unsigned int slack_blocks = 0;
+  BackgroundTask task;
+  bool in_flight = false;
+  unsigned int blocks_until_needed = 0;
+  unsigned int job_ring_start = 0;
+  // The input the worker is transforming, swapped with pending_input on submission, and where it puts the result.
+  AlignedBuffer<float> job_input, job_output;
+};
+
+NonUniformPartitionedConvolver::NonUniformPartitionedConvolver(unsigned int _block_size, unsigned int _channels,
+                                                               const float *impulse, unsigned int impulse_len,
+                                                               unsigned int max_partition_size,
+                                                               ConvolutionWorker *_worker)
+    : block_size(_block_size), channels(_channels),
+      head(_channels, impulse, getHeadLength(_block_size, impulse_len), _block_size), worker(_worker) {
+  assert(block_size != 0 && (block_size & (block_size - 1)) == 0);
+  assert(channels != 0 && impulse_len != 0);
+
+  // If the head took everything, there's no tail.
+  if (head.getImpulseLength() < impulse_len) {
+    layout = computeNonUniformPartitionLayout(block_size, impulse_len, max_partition_size);
+  }
+
+  unsigned int furthest = block_size, largest = block_size, background_count = 0;
+  for (const PartitionSegment &shape : layout) {
+    auto seg = std::make_unique<Segment>();
+
+    // The last segment may run past the end of the impulse.
+    unsigned int seg_len = std::min(shape.partition_size * shape.partition_count, impulse_len - shape.offset);
+    seg->shape = shape;
+    seg->engine = std::make_unique<UniformPartitionedConvolver>(
+        shape.partition_size, channels, impulse + (size_t)shape.offset * channels, seg_len);
+    seg->pending_input.resize((size_t)shape.partition_size * channels);
+
+    unsigned int period = shape.partition_size / block_size;
+    seg->slack_blocks = std::min((shape.offset - shape.partition_size) / block_size, period - 1);
+    // With no slack the result is needed on the same call which submits it, so the worker can't help.
+    if (worker != nullptr && seg->slack_blocks != 0) {
+      seg->background = true;
+      seg->job_input.resize(seg->pending_input.size());
+      seg->job_output.resize(seg->pending_input.size());
+      seg->task.userdata = seg.get();
+      seg->task.run = [](void *userdata) {
+        auto *s = (Segment *)userdata;
+        std::fill(s->job_output.begin(), s->job_output.end(), 0.0f);
+        s->engine->process(&s->job_input[0], &s->job_output[0]);
+      };
+      background_count++;
+    }
+
+    furthest = std::max(furthest, shape.offset + shape.partition_size);
+    largest = std::max(largest, shape.partition_size);
+    segments.push_back(std::move(seg));
+  }
+
+  // Results are written up to offset frames past the end of the current block, and the current block is still being
+  // read.
+  ring_frames = roundDownToPowerOfTwo(furthest + block_size);
+  if (ring_frames < furthest + block_size) {
+    ring_frames *= 2;
+  }
+  output_ring.resize((size_t)ring_frames * channels);
+  segment_output.resize((size_t)largest * channels);
+
+  if (background_count != 0) {
+    unsigned int capacity = roundDownToPowerOfTwo(background_count);
+    if (capacity < background_count) {
+      capacity *= 2;
+    }
+    task_queue = std::make_unique<BackgroundTaskQueue>(capacity);
+    worker->attach(task_queue.get());
+  }
+}
+
+NonUniformPartitionedConvolver::~NonUniformPartitionedConvolver() {
+  // Once detached the worker is guaranteed not to be touching any of our tasks.
+  if (task_queue) {
+    worker->detach(task_queue.get());
+  }
+}
+
+void NonUniformPartitionedConvolver::reset() {
+  for (auto &seg : segments) {
+    if (seg->in_flight) {
+      finishTask(&seg->task);
+      seg->in_flight = false;
+    }
+  }
+
+  head.reset();
+  std::fill(output_ring.begin(), output_ring.end(), 0.0f);
+  ring_position = 0;
+  for (auto &seg : segments) {
+    seg->engine->reset();
+    seg->pending_frames = 0;
+  }
+}
+
+void NonUniformPartitionedConvolver::addToRing(const float *src, unsigned int start, unsigned int frames) {
+  for (unsigned int i = 0; i < frames; i++) {
+    float *dest = &output_ring[(size_t)((start + i) & (ring_frames - 1)) * channels];
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      dest[ch] += src[(size_t)i * channels + ch];
+    }
+  }
+}
+
+void NonUniformPartitionedConvolver::collectSegment(Segment &seg) {
+  bool late = finishTask(&seg.task);
+  background_results.fetch_add(1, std::memory_order_relaxed);
+  if (late) {
+    late_results.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  addToRing(&seg.job_output[0], seg.job_ring_start, seg.shape.partition_size);
+  seg.in_flight = false;
+}
+
+void NonUniformPartitionedConvolver::feedSegment(Segment &seg, const float *input) {
+  unsigned int size = seg.shape.partition_size;
+
+  std::copy(input, input + (size_t)block_size * channels, &seg.pending_input[(size_t)seg.pending_frames * channels]);
+  seg.pending_frames += block_size;
+  if (seg.pending_frames < size) {
+    return;
+  }
+  seg.pending_frames = 0;
+
+  // The pending input started at (end of the current block) - size, and the segment's output is delayed by its offset.
+  // Since offset >= size, everything lands at or after the start of the next block.
+  unsigned int start = ring_position + block_size - size + seg.shape.offset;
+
+  if (seg.background) {
+    assert(!seg.in_flight);
+    std::swap(seg.pending_input, seg.job_input);
+    seg.job_ring_start = start;
+    // The first frame of output is needed slack_blocks blocks after the next one.
+    seg.blocks_until_needed = seg.slack_blocks + 1;
+    seg.in_flight = true;
+    submitTask(task_queue.get(), &seg.task);
+    return;
+  }
+
+  std::fill(segment_output.begin(), segment_output.begin() + (size_t)size * channels, 0.0f);
+  seg.engine->process(&seg.pending_input[0], &segment_output[0]);
+  addToRing(&segment_output[0], start, size);
+}
+
+void NonUniformPartitionedConvolver::process(const float *input, float *output, const OutputMode &mode) {
+  // The head writes the output as asked, and the tail is then mixed in on top at the same gains.
+  head.process(input, block_size, output, mode);
+
+  for (auto &seg : segments) {
+    if (seg->in_flight && --seg->blocks_until_needed == 0) {
+      collectSegment(*seg);
+    }
+  }
+
+  // ring_frames is a multiple of block_size, so the current block never wraps.
+  float *ring_block = &output_ring[(size_t)ring_position * channels];
+  getDispatchTable()->mixGainRamp(ring_block, output, block_size, channels, mode.gain_start, mode.gain_end, true);
+  std::fill(ring_block, ring_block + (size_t)block_size * channels, 0.0f);
+
+  for (auto &seg : segments) {
+    feedSegment(*seg, input);
+  }
+
+  ring_position = (ring_position + block_size) & (ring_frames - 1);
+}
+
+} // namespace simdsp
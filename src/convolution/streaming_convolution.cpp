@@ -0,0 +1,87 @@
+#include "simdsp/convolution/streaming_convolution.hpp"
+
+#include "dispatch.hpp"
+#include "simdsp/convolution/tuning.hpp"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace simdsp {
+
+StreamingConvolver::StreamingConvolver(unsigned int _channels, const float *impulse, unsigned int _impulse_len,
+                                       unsigned int _max_block_size)
+    : channels(_channels), impulse_len(_impulse_len), max_block_size(_max_block_size) {
+  assert(channels != 0 && impulse_len != 0 && max_block_size != 0);
+
+  reversed_impulse.resize((size_t)impulse_len * channels);
+  for (unsigned int i = 0; i < impulse_len; i++) {
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      reversed_impulse[(size_t)(impulse_len - 1 - i) * channels + ch] = impulse[(size_t)i * channels + ch];
+    }
+  }
+
+  capacity = impulse_len - 1 + max_block_size;
+  ring.resize((size_t)2 * capacity * channels);
+
+  // By default once the impulse is big enough that the generic kernel would stream it from past L1 for every frame.
+  tiling = getDefaultDirectConvolutionTiling(channels);
+  tiled = impulse_len >= getTiledCrossover(getConvolutionTuning(), channels);
+}
+
+void StreamingConvolver::reset() {
+  std::fill(ring.begin(), ring.end(), 0.0f);
+  write_position = 0;
+}
+
+void StreamingConvolver::processChunk(const float *input, unsigned int frames, float *output,
+                                      const OutputMode &mode) {
+  // Write the chunk into both halves, in at most two runs since it may wrap.
+  unsigned int first = std::min(frames, capacity - write_position);
+  size_t first_len = (size_t)first * channels, rest_len = (size_t)(frames - first) * channels;
+  float *lower = ring.data() + (size_t)write_position * channels;
+  std::copy(input, input + first_len, lower);
+  std::copy(input, input + first_len, lower + (size_t)capacity * channels);
+  std::copy(input + first_len, input + first_len + rest_len, ring.data());
+  std::copy(input + first_len, input + first_len + rest_len, ring.data() + (size_t)capacity * channels);
+
+  // The window the kernel reads is [write_position - (impulse_len - 1), write_position + frames).  It's at most
+  // capacity frames long, so it lies entirely in one of the two copies: the lower one if it doesn't start before the
+  // ring, otherwise the same frames capacity further on.
+  unsigned int start = write_position;
+  if (start < impulse_len - 1) {
+    start += capacity;
+  }
+  const DispatchTable *table = getDispatchTable();
+  float *current = ring.data() + (size_t)start * channels;
+  if (tiled) {
+    table->tiledBlockConvolver(current, frames, channels, reversed_impulse.data(), impulse_len, output,
+                               tiling.tile_taps, tiling.tile_frames, &mode);
+  } else {
+    table->genericBlockConvolver(current, frames, channels, reversed_impulse.data(), impulse_len, output, &mode);
+  }
+
+  write_position += frames;
+  if (write_position >= capacity) {
+    write_position -= capacity;
+  }
+}
+
+void StreamingConvolver::process(const float *input, unsigned int frames, float *output, const OutputMode &mode) {
+  // Each chunk gets the piece of the ramp over its frames, so that the ramp is the same however the call is split.
+  float gain_per_frame = frames == 0 ? 0.0f : (mode.gain_end - mode.gain_start) / (float)frames;
+  OutputMode chunk_mode = mode;
+  unsigned int done = 0;
+
+  while (done < frames) {
+    unsigned int chunk = std::min(frames - done, max_block_size);
+    chunk_mode.gain_start = mode.gain_start + gain_per_frame * (float)done;
+    chunk_mode.gain_end =
+        done + chunk == frames ? mode.gain_end : mode.gain_start + gain_per_frame * (float)(done + chunk);
+    processChunk(input, chunk, output, chunk_mode);
+    input += (size_t)chunk * channels;
+    output += (size_t)chunk * channels;
+    done += chunk;
+  }
+}
+
+} // namespace simdsp
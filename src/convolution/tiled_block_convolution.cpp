@@ -0,0 +1,43 @@
+#include "simdsp/convolution/tiled_block_convolution.hpp"
+
+#include "cache_sizes.hpp"
+#include "dispatch.hpp"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace simdsp {
+
+/*
+ * Floor on both tile sizes, so that the dispatched kernel's inner loops always have some length to vectorize.
+ */
+static const unsigned int MIN_TILE = 16;
+
+DirectConvolutionTiling getDefaultDirectConvolutionTiling(unsigned int channels) {
+  assert(channels != 0);
+  unsigned int frame_bytes = (unsigned int)sizeof(float) * channels;
+
+  // An output tile and the input under it, which is slightly bigger, in half of L1.
+  unsigned int tile_frames = std::max(getL1dSize() / 4 / frame_bytes / MIN_TILE * MIN_TILE, MIN_TILE);
+  // A tap tile and the input it slides over in half of L2.
+  unsigned int tile_taps = std::max(getL2Size() / 4 / frame_bytes, MIN_TILE);
+
+  return DirectConvolutionTiling{tile_taps, tile_frames};
+}
+
+void tiledBlockConvolver(float *input, unsigned int input_len, unsigned int input_channels, float *impulse,
+                         unsigned int impulse_len, float *output, const DirectConvolutionTiling *tiling,
+                         const OutputMode &mode) {
+  DirectConvolutionTiling tiles;
+  if (tiling != nullptr) {
+    tiles = *tiling;
+  } else {
+    tiles = getDefaultDirectConvolutionTiling(input_channels);
+  }
+  assert(tiles.tile_taps != 0 && tiles.tile_frames != 0);
+
+  getDispatchTable()->tiledBlockConvolver(input, input_len, input_channels, impulse, impulse_len, output,
+                                          tiles.tile_taps, tiles.tile_frames, &mode);
+}
+
+} // namespace simdsp
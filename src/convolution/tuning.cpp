@@ -0,0 +1,338 @@
+#include "simdsp/convolution/tuning.hpp"
+
+#include "simdsp/convolution/generic_block_convolution.hpp"
+#include "simdsp/convolution/non_uniform_partitioned_convolution.hpp"
+#include "simdsp/convolution/streaming_convolution.hpp"
+#include "simdsp/convolution/tiled_block_convolution.hpp"
+#include "simdsp/dispatch.hpp"
+#include "simdsp/system_info.hpp"
+
+#include "cache_sizes.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits.h>
+#include <mutex>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace simdsp {
+
+static const char TUNING_FILE_MAGIC[] = "simdsp-convolution-tuning";
+/* Bump whenever the meaning or set of fields changes, so that old files are re-tuned rather than misread. */
+static const unsigned int TUNING_FILE_VERSION = 2;
+
+static const unsigned int DEFAULT_MAX_PARTITION_SIZE = 8192;
+
+/*
+ * The longest impulse the tiled and FFT crossover searches go to.  If direct convolution is still winning here, the
+ * crossover is recorded as twice this: past it FFT wins on anything, and nobody wants direct convolution of an
+ * arbitrarily long impulse because a measurement was noisy.
+ */
+static const unsigned int MAX_SEARCHED_IMPULSE_LEN = 16384;
+
+/*
+ * Every measurement pushes at least this many frames through, and keeps the best of TIMING_REPEATS runs.
+ */
+static const unsigned int TIMING_FRAMES = 16384;
+static const unsigned int TIMING_REPEATS = 3;
+
+/*
+ * A faster candidate has to win by this factor before it's preferred, so that noise doesn't flip close calls.
+ */
+static const double TIMING_MARGIN = 0.95;
+
+static std::mutex tuning_lock;
+static bool tuning_set = false;
+static ConvolutionTuning current_tuning;
+
+/*
+ * Lets the tuner try thresholds on the engines it constructs without touching what the rest of the process sees.
+ */
+static thread_local const ConvolutionTuning *tuning_override = nullptr;
+
+ConvolutionTuning getDefaultConvolutionTuning() {
+  ConvolutionTuning tuning;
+  // Once the impulse takes up half of L1.
+  for (unsigned int i = 0; i < CONVOLUTION_TUNING_CHANNEL_COUNTS; i++) {
+    tuning.tiled_min_impulse_len[i] = (getL1dSize() / 2 / (unsigned int)sizeof(float)) >> i;
+  }
+  tuning.max_partition_size = DEFAULT_MAX_PARTITION_SIZE;
+  for (unsigned int i = 0; i < CONVOLUTION_TUNING_BLOCK_SIZES; i++) {
+    tuning.fft_min_impulse_len[i] = 0;
+  }
+  return tuning;
+}
+
+void setConvolutionTuning(const ConvolutionTuning &tuning) {
+  std::lock_guard<std::mutex> guard(tuning_lock);
+  current_tuning = tuning;
+  tuning_set = true;
+}
+
+ConvolutionTuning getConvolutionTuning() {
+  if (tuning_override != nullptr) {
+    return *tuning_override;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(tuning_lock);
+    if (tuning_set) {
+      return current_tuning;
+    }
+  }
+  return getDefaultConvolutionTuning();
+}
+
+/*
+ * Which of count entries, for values min, 2 * min, 4 * min, ..., covers value: the largest not above it, or the first.
+ */
+static unsigned int getDoublingIndex(unsigned int value, unsigned int min, unsigned int count) {
+  unsigned int index = 0;
+  while (index + 1 < count && (min << (index + 1)) <= value) {
+    index++;
+  }
+  return index;
+}
+
+unsigned int getFftCrossover(const ConvolutionTuning &tuning, unsigned int block_size) {
+  return tuning.fft_min_impulse_len[getDoublingIndex(block_size, CONVOLUTION_TUNING_MIN_BLOCK_SIZE,
+                                                     CONVOLUTION_TUNING_BLOCK_SIZES)];
+}
+
+unsigned int getTiledCrossover(const ConvolutionTuning &tuning, unsigned int channels) {
+  return tuning.tiled_min_impulse_len[getDoublingIndex(channels, 1, CONVOLUTION_TUNING_CHANNEL_COUNTS)];
+}
+
+/*
+ * Seconds per call of fn: the best of TIMING_REPEATS runs of calls calls, after one call to warm up.  The minimum is
+ * the least noisy estimate of what the code itself costs.
+ */
+template <typename F> static double timeCalls(F &&fn, unsigned int calls) {
+  fn();
+
+  double best = 1e30;
+  for (unsigned int r = 0; r < TIMING_REPEATS; r++) {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < calls; i++) {
+      fn();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best / calls;
+}
+
+static std::vector<float> makeTuningNoise(size_t len, unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> ret(len);
+  for (auto &x : ret) {
+    x = dist(rng);
+  }
+  return ret;
+}
+
+/*
+ * The smallest impulse for which the tiled kernel beats the generic one on 256-frame blocks of channels channels.
+ * Measured per channel count, since the generic kernel's specializations make it scale differently from the tiled one.
+ */
+static unsigned int tuneTiledCrossover(unsigned int channels) {
+  const unsigned int block_size = 256;
+  std::vector<float> output((size_t)block_size * channels);
+
+  for (unsigned int impulse_len = 32; impulse_len <= MAX_SEARCHED_IMPULSE_LEN; impulse_len *= 2) {
+    std::vector<float> history = makeTuningNoise((size_t)(impulse_len - 1 + block_size) * channels, 1);
+    std::vector<float> impulse = makeTuningNoise((size_t)impulse_len * channels, 2);
+    float *current = &history[(size_t)(impulse_len - 1) * channels];
+    unsigned int calls = std::max(TIMING_FRAMES / block_size / channels, 1u);
+
+    double generic = timeCalls(
+        [&]() { genericBlockConvolver(current, block_size, channels, &impulse[0], impulse_len, &output[0]); }, calls);
+    double tiled = timeCalls(
+        [&]() { tiledBlockConvolver(current, block_size, channels, &impulse[0], impulse_len, &output[0]); }, calls);
+    if (tiled < generic * TIMING_MARGIN) {
+      return impulse_len;
+    }
+  }
+
+  return UINT_MAX;
+}
+
+/*
+ * The smallest mono impulse for which the FFT tail beats convolving the whole impulse directly.  Expects the tuning
+ * override to be forcing the FFT tail.
+ */
+static unsigned int tuneFftCrossover(unsigned int block_size) {
+  std::vector<float> input = makeTuningNoise(block_size, 3), output(block_size);
+  unsigned int calls = std::max(TIMING_FRAMES / block_size, 1u);
+
+  for (unsigned int impulse_len = block_size * 2; impulse_len <= MAX_SEARCHED_IMPULSE_LEN; impulse_len *= 2) {
+    std::vector<float> impulse = makeTuningNoise(impulse_len, 4);
+
+    StreamingConvolver direct(1, &impulse[0], impulse_len, block_size);
+    NonUniformPartitionedConvolver fft(block_size, 1, &impulse[0], impulse_len);
+
+    double direct_time = timeCalls([&]() { direct.process(&input[0], block_size, &output[0]); }, calls);
+    double fft_time = timeCalls([&]() { fft.process(&input[0], &output[0]); }, calls);
+    if (fft_time < direct_time * TIMING_MARGIN) {
+      return impulse_len;
+    }
+  }
+
+  return MAX_SEARCHED_IMPULSE_LEN * 2;
+}
+
+/*
+ * The fastest largest partition for a long impulse on 256-frame blocks.  Each candidate runs for at least two periods
+ * of its largest partition, so the bursts when big partitions complete are averaged in.
+ */
+static unsigned int tuneMaxPartitionSize() {
+  const unsigned int block_size = 256, impulse_len = 65536;
+  std::vector<float> impulse = makeTuningNoise(impulse_len, 5);
+  std::vector<float> input = makeTuningNoise(block_size, 6), output(block_size);
+
+  unsigned int best_size = DEFAULT_MAX_PARTITION_SIZE;
+  double best_time = 1e30;
+  for (unsigned int size = 1024; size <= 32768; size *= 2) {
+    NonUniformPartitionedConvolver conv(block_size, 1, &impulse[0], impulse_len, size);
+    unsigned int calls = std::max(TIMING_FRAMES, 2 * size) / block_size;
+    double time = timeCalls([&]() { conv.process(&input[0], &output[0]); }, calls);
+    if (time < best_time * TIMING_MARGIN) {
+      best_time = time;
+      best_size = size;
+    }
+  }
+
+  return best_size;
+}
+
+ConvolutionTuning runConvolutionTuning() {
+  ConvolutionTuning tuning = getDefaultConvolutionTuning();
+
+  for (unsigned int i = 0; i < CONVOLUTION_TUNING_CHANNEL_COUNTS; i++) {
+    tuning.tiled_min_impulse_len[i] = tuneTiledCrossover(1u << i);
+  }
+
+  // Everything below constructs engines which should see the thresholds tuned so far, with the FFT tail forced on.
+  const ConvolutionTuning *previous_override = tuning_override;
+  tuning_override = &tuning;
+
+  tuning.max_partition_size = tuneMaxPartitionSize();
+  for (unsigned int i = 0; i < CONVOLUTION_TUNING_BLOCK_SIZES; i++) {
+    tuning.fft_min_impulse_len[i] = 0;
+  }
+  unsigned int crossovers[CONVOLUTION_TUNING_BLOCK_SIZES];
+  for (unsigned int i = 0; i < CONVOLUTION_TUNING_BLOCK_SIZES; i++) {
+    crossovers[i] = tuneFftCrossover(CONVOLUTION_TUNING_MIN_BLOCK_SIZE << i);
+  }
+
+  tuning_override = previous_override;
+  std::copy(crossovers, crossovers + CONVOLUTION_TUNING_BLOCK_SIZES, tuning.fft_min_impulse_len);
+  return tuning;
+}
+
+/*
+ * The machine, and the cap on dispatch (e.g. from SIMDSP_MAX_ISA), which changes which kernels the timings were of.
+ */
+static std::string getFingerprint() {
+  SystemInfo info = getSystemInfo();
+  char *json = convertSystemInfoToJson(&info);
+  std::string ret = json;
+  free(json);
+
+  DispatchVariant cap;
+  ret += " max_isa ";
+  ret += getMaxDispatchVariant(&cap) ? dispatchVariantToString(cap) : "none";
+  return ret;
+}
+
+bool saveConvolutionTuning(const char *path, const ConvolutionTuning &tuning) {
+  FILE *f = fopen(path, "w");
+  if (f == nullptr) {
+    return false;
+  }
+
+  fprintf(f, "%s %u\n", TUNING_FILE_MAGIC, TUNING_FILE_VERSION);
+  fprintf(f, "fingerprint %s\n", getFingerprint().c_str());
+  for (unsigned int i = 0; i < CONVOLUTION_TUNING_CHANNEL_COUNTS; i++) {
+    fprintf(f, "tiled_min_impulse_len %u %u\n", 1u << i, tuning.tiled_min_impulse_len[i]);
+  }
+  fprintf(f, "max_partition_size %u\n", tuning.max_partition_size);
+  for (unsigned int i = 0; i < CONVOLUTION_TUNING_BLOCK_SIZES; i++) {
+    fprintf(f, "fft_min_impulse_len %u %u\n", CONVOLUTION_TUNING_MIN_BLOCK_SIZE << i, tuning.fft_min_impulse_len[i]);
+  }
+
+  bool ok = ferror(f) == 0;
+  ok = fclose(f) == 0 && ok;
+  return ok;
+}
+
+/*
+ * Read one line without the newline.  Returns false at end of file.
+ */
+static bool readLine(FILE *f, std::string &line) {
+  line.clear();
+  int c;
+  while ((c = fgetc(f)) != EOF && c != '\n') {
+    line.push_back((char)c);
+  }
+  return c != EOF || line.empty() == false;
+}
+
+bool loadConvolutionTuning(const char *path, ConvolutionTuning *out) {
+  FILE *f = fopen(path, "r");
+  if (f == nullptr) {
+    return false;
+  }
+
+  ConvolutionTuning tuning;
+  std::string line, expected_fingerprint = std::string("fingerprint ") + getFingerprint();
+  char magic[sizeof(TUNING_FILE_MAGIC) + 1];
+  unsigned int version = 0, channels = 0, block_size = 0, seen_channels = 0, seen_blocks = 0;
+  bool ok = true;
+
+  // Fixed order: header, fingerprint, then the fields as saveConvolutionTuning writes them.
+  ok = ok && readLine(f, line) && sscanf(line.c_str(), "%26s %u", magic, &version) == 2 &&
+       strcmp(magic, TUNING_FILE_MAGIC) == 0 && version == TUNING_FILE_VERSION;
+  ok = ok && readLine(f, line) && line == expected_fingerprint;
+  for (unsigned int i = 0; ok && i < CONVOLUTION_TUNING_CHANNEL_COUNTS; i++) {
+    ok = readLine(f, line) &&
+         sscanf(line.c_str(), "tiled_min_impulse_len %u %u", &channels, &tuning.tiled_min_impulse_len[i]) == 2 &&
+         channels == 1u << i;
+    seen_channels += ok;
+  }
+  ok = ok && readLine(f, line) && sscanf(line.c_str(), "max_partition_size %u", &tuning.max_partition_size) == 1;
+  for (unsigned int i = 0; ok && i < CONVOLUTION_TUNING_BLOCK_SIZES; i++) {
+    ok = readLine(f, line) &&
+         sscanf(line.c_str(), "fft_min_impulse_len %u %u", &block_size, &tuning.fft_min_impulse_len[i]) == 2 &&
+         block_size == CONVOLUTION_TUNING_MIN_BLOCK_SIZE << i;
+    seen_blocks += ok;
+  }
+  fclose(f);
+
+  if (ok == false || seen_channels != CONVOLUTION_TUNING_CHANNEL_COUNTS ||
+      seen_blocks != CONVOLUTION_TUNING_BLOCK_SIZES || tuning.max_partition_size == 0) {
+    return false;
+  }
+  *out = tuning;
+  return true;
+}
+
+ConvolutionTuning initializeConvolutionTuning(const char *path) {
+  ConvolutionTuning tuning;
+  if (loadConvolutionTuning(path, &tuning) == false) {
+    tuning = runConvolutionTuning();
+    // A read-only location just means tuning again next time.
+    saveConvolutionTuning(path, tuning);
+  }
+
+  setConvolutionTuning(tuning);
+  return tuning;
+}
+
+} // namespace simdsp
@@ -0,0 +1,185 @@
+#include "simdsp/convolution/uniform_partitioned_convolution.hpp"
+
+#include "simdsp/fft.hpp"
+
+#include "dispatch.hpp"
+#include "impulse_transform.hpp"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace simdsp {
+
+UniformPartitionedConvolver::UniformPartitionedConvolver(unsigned int _block_size, unsigned int _channels,
+                                                         const float *impulse, unsigned int impulse_len)
+    : block_size(_block_size), channels(_channels) {
+  assert(channels != 0);
+  assert(impulse_len != 0);
+
+  partition_count = (impulse_len + block_size - 1) / block_size;
+  allocateState();
+
+  size_t spectra_len = (size_t)channels * partition_count * spectrum_stride;
+  impulse_re.resize(spectra_len);
+  impulse_im.resize(spectra_len);
+  transformImpulse(impulse, impulse_len, &impulse_re[0], &impulse_im[0]);
+  current_re = &impulse_re[0];
+  current_im = &impulse_im[0];
+  current_partitions = partition_count;
+}
+
+UniformPartitionedConvolver::UniformPartitionedConvolver(const ImpulseSpectra &spectra)
+    : block_size(spectra.block_size), channels(spectra.channels), partition_count(spectra.partition_count) {
+  assert(channels != 0);
+  assert(partition_count != 0);
+
+  allocateState();
+  assert(spectra.spectrum_stride == spectrum_stride);
+  current_re = spectra.re;
+  current_im = spectra.im;
+  current_partitions = partition_count;
+}
+
+UniformPartitionedConvolver::~UniformPartitionedConvolver() {}
+
+void UniformPartitionedConvolver::allocateState() {
+  unsigned int fft_size = block_size * 2;
+  assert(isRealFftSizeSupported(fft_size));
+  fft = getRealFft(fft_size);
+
+  spectrum_stride = getImpulseSpectraStride(block_size);
+  spectrum_work_len = (unsigned int)padToSimdAlignment<float>(fft->getBinCount());
+  assert(spectrum_work_len <= spectrum_stride);
+
+  size_t spectra_len = (size_t)channels * partition_count * spectrum_stride;
+  history.resize((size_t)channels * fft_size);
+  fdl_re.resize(spectra_len);
+  fdl_im.resize(spectra_len);
+  acc_re.resize(spectrum_stride);
+  acc_im.resize(spectrum_stride);
+  time_block.resize(fft_size);
+  workspace.resize(fft->getWorkspaceSize());
+
+  // Small enough to always have, and it keeps setImpulse with precomputed spectra allocation-free.
+  pending_acc_re.resize(spectrum_stride);
+  pending_acc_im.resize(spectrum_stride);
+  pending_time_block.resize(fft_size);
+}
+
+void UniformPartitionedConvolver::transformImpulse(const float *impulse, unsigned int impulse_len, float *out_re,
+                                                   float *out_im) {
+  transformImpulsePartitions(*fft, channels, partition_count, spectrum_stride, impulse, impulse_len, out_re, out_im,
+                             &time_block[0], &workspace[0]);
+}
+
+void UniformPartitionedConvolver::setImpulse(const float *impulse, unsigned int impulse_len) {
+  if (pending_impulse_re.empty()) {
+    size_t spectra_len = (size_t)channels * partition_count * spectrum_stride;
+    pending_impulse_re.resize(spectra_len);
+    pending_impulse_im.resize(spectra_len);
+  }
+
+  transformImpulse(impulse, impulse_len, &pending_impulse_re[0], &pending_impulse_im[0]);
+  pending_re = &pending_impulse_re[0];
+  pending_im = &pending_impulse_im[0];
+  pending_partitions = partition_count;
+  impulse_pending = true;
+}
+
+void UniformPartitionedConvolver::setImpulse(const ImpulseSpectra &spectra) {
+  assert(spectra.block_size == block_size && spectra.channels == channels);
+  assert(spectra.spectrum_stride == spectrum_stride);
+  assert(spectra.partition_count != 0 && spectra.partition_count <= partition_count);
+
+  pending_re = spectra.re;
+  pending_im = spectra.im;
+  pending_partitions = spectra.partition_count;
+  impulse_pending = true;
+}
+
+void UniformPartitionedConvolver::applyPendingImpulse() {
+  // Swapping buffers doesn't allocate or move their contents, so pointers into them stay valid.  If the pending impulse
+  // was precomputed, this just parks the old spectra where the next transformed impulse will go.
+  std::swap(impulse_re, pending_impulse_re);
+  std::swap(impulse_im, pending_impulse_im);
+  current_re = pending_re;
+  current_im = pending_im;
+  current_partitions = pending_partitions;
+  impulse_pending = false;
+}
+
+void UniformPartitionedConvolver::reset() {
+  std::fill(history.begin(), history.end(), 0.0f);
+  std::fill(fdl_re.begin(), fdl_re.end(), 0.0f);
+  std::fill(fdl_im.begin(), fdl_im.end(), 0.0f);
+  fdl_position = 0;
+  if (impulse_pending) {
+    applyPendingImpulse();
+  }
+}
+
+void UniformPartitionedConvolver::process(const float *input, float *output, const OutputMode &mode) {
+  const DispatchTable *table = getDispatchTable();
+
+  for (unsigned int ch = 0; ch < channels; ch++) {
+    float *hist = &history[(size_t)ch * 2 * block_size];
+    std::copy(hist + block_size, hist + 2 * block_size, hist);
+    for (unsigned int i = 0; i < block_size; i++) {
+      hist[block_size + i] = input[(size_t)i * channels + ch];
+    }
+
+    size_t channel_offset = (size_t)ch * partition_count * spectrum_stride;
+    float *x_re = &fdl_re[channel_offset], *x_im = &fdl_im[channel_offset];
+    // Precomputed spectra may have fewer partitions, and so a smaller distance between channels.
+    const float *h_re = current_re + (size_t)ch * current_partitions * spectrum_stride;
+    const float *h_im = current_im + (size_t)ch * current_partitions * spectrum_stride;
+    const float *pending_h_re = nullptr, *pending_h_im = nullptr;
+    unsigned int active_partitions = current_partitions;
+    if (impulse_pending) {
+      pending_h_re = pending_re + (size_t)ch * pending_partitions * spectrum_stride;
+      pending_h_im = pending_im + (size_t)ch * pending_partitions * spectrum_stride;
+      active_partitions = std::max(active_partitions, pending_partitions);
+    }
+
+    fft->forward(hist, x_re + (size_t)fdl_position * spectrum_stride, x_im + (size_t)fdl_position * spectrum_stride,
+                 &workspace[0]);
+
+    std::fill(acc_re.begin(), acc_re.end(), 0.0f);
+    std::fill(acc_im.begin(), acc_im.end(), 0.0f);
+    if (impulse_pending) {
+      std::fill(pending_acc_re.begin(), pending_acc_re.end(), 0.0f);
+      std::fill(pending_acc_im.begin(), pending_acc_im.end(), 0.0f);
+    }
+
+    // Partition p multiplies the spectrum from p blocks ago.  The padding past the last bin is zero in every spectrum,
+    // so the kernels run over the whole padded length and never hit their remainder loops.
+    unsigned int slot = fdl_position;
+    for (unsigned int p = 0; p < active_partitions; p++) {
+      size_t x_off = (size_t)slot * spectrum_stride, h_off = (size_t)p * spectrum_stride;
+      if (p < current_partitions) {
+        table->complexMultiplyAccumulate(x_re + x_off, x_im + x_off, h_re + h_off, h_im + h_off, &acc_re[0],
+                                         &acc_im[0], spectrum_work_len);
+      }
+      if (impulse_pending && p < pending_partitions) {
+        table->complexMultiplyAccumulate(x_re + x_off, x_im + x_off, pending_h_re + h_off, pending_h_im + h_off,
+                                         &pending_acc_re[0], &pending_acc_im[0], spectrum_work_len);
+      }
+      slot = slot == 0 ? partition_count - 1 : slot - 1;
+    }
+
+    fft->inverse(&acc_re[0], &acc_im[0], &time_block[0], &workspace[0]);
+    const float *crossfade_to = nullptr;
+    if (impulse_pending) {
+      fft->inverse(&pending_acc_re[0], &pending_acc_im[0], &pending_time_block[0], &workspace[0]);
+      crossfade_to = &pending_time_block[block_size];
+    }
+    table->writeBlockOutput(&time_block[block_size], crossfade_to, output + ch, block_size, channels, &mode);
+  }
+
+  if (impulse_pending) {
+    applyPendingImpulse();
+  }
+  fdl_position = fdl_position + 1 == partition_count ? 0 : fdl_position + 1;
+}
+
+} // namespace simdsp
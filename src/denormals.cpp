@@ -0,0 +1,103 @@
+#include "simdsp/denormals.hpp"
+
+#include "simdsp/feature_macros.hpp"
+#include "simdsp/system_info.hpp"
+
+#if _MSC_VER
+#include <float.h>
+#endif
+
+namespace simdsp {
+
+/*
+ * The floating point control state as a plain integer, which is all the guard needs to save and restore it.  MSVC
+ * doesn't have inline assembly on x64 or ARM64, but its CRT exposes exactly the bits we want.
+ */
+#if _MSC_VER
+
+static uint64_t readControlState() {
+  unsigned int state = 0;
+  _controlfp_s(&state, 0, 0);
+  return state;
+}
+
+static void writeControlState(uint64_t state) {
+  unsigned int ignored;
+  _controlfp_s(&ignored, (unsigned int)state, _MCW_DN);
+}
+
+static uint64_t getFlushedState(uint64_t state) { return (state & ~(uint64_t)_MCW_DN) | _DN_FLUSH; }
+
+static bool isFlushed(uint64_t state) { return (state & _MCW_DN) == _DN_FLUSH; }
+
+#elif SIMDSP_IS_X86
+
+static const uint64_t MXCSR_DAZ = 1u << 6, MXCSR_FTZ = 1u << 15;
+
+/*
+ * MXCSR doesn't exist without SSE, which only matters for 32-bit builds.  These are cached because getSystemInfo()
+ * copies the whole topology, which is more than a guard at the top of every audio callback should pay.
+ */
+static bool haveMxcsr() {
+  static const bool have = (getSystemInfo().cpu_capabilities & CpuCapabilities::X86_SSE2) != 0;
+  return have;
+}
+
+static bool haveDaz() {
+  static const bool have = getSystemInfo().daz_supported;
+  return have;
+}
+
+static uint64_t readControlState() {
+  if (haveMxcsr() == false) {
+    return 0;
+  }
+  uint32_t mxcsr;
+  __asm__ __volatile__("stmxcsr %0" : "=m"(mxcsr));
+  return mxcsr;
+}
+
+static void writeControlState(uint64_t state) {
+  if (haveMxcsr() == false) {
+    return;
+  }
+  uint32_t mxcsr = (uint32_t)state;
+  __asm__ __volatile__("ldmxcsr %0" : : "m"(mxcsr));
+}
+
+static uint64_t getFlushedState(uint64_t state) {
+  // Setting DAZ on a CPU without it faults.
+  return state | MXCSR_FTZ | (haveDaz() ? MXCSR_DAZ : 0);
+}
+
+static bool isFlushed(uint64_t state) { return (state & MXCSR_FTZ) != 0; }
+
+#elif SIMDSP_IS_AARCH64
+
+static const uint64_t FPCR_FZ = 1u << 24;
+
+static uint64_t readControlState() {
+  uint64_t fpcr;
+  __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+  return fpcr;
+}
+
+static void writeControlState(uint64_t state) { __asm__ __volatile__("msr fpcr, %0" : : "r"(state)); }
+
+static uint64_t getFlushedState(uint64_t state) { return state | FPCR_FZ; }
+
+static bool isFlushed(uint64_t state) { return (state & FPCR_FZ) != 0; }
+
+#else
+#error Unable to control denormals on this architecture.
+#endif
+
+DenormalGuard::DenormalGuard() : saved_state(readControlState()) {
+  writeControlState(getFlushedState(saved_state));
+}
+
+DenormalGuard::~DenormalGuard() { writeControlState(saved_state); }
+
+bool areDenormalsFlushed() { return isFlushed(readControlState()); }
+
+} // namespace simdsp
@@ -0,0 +1,313 @@
+#include "simdsp/dispatch.hpp"
+#include "simdsp/feature_macros.hpp"
+#include "simdsp/system_info.hpp"
+
+#include "dispatch.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace simdsp {
+
+#if SIMDSP_STATIC_DISPATCH
+
+/*
+ * Static builds have the variant the compiler targets and nothing else.  The table is all the dispatch there is.
+ */
+static const DispatchTable *getCompiledTable(DispatchVariant variant) {
+  return variant == DispatchVariant::SIMDSP_BASELINE_VARIANT ? getDispatchTable() : nullptr;
+}
+
+#else
+
+/*
+ * Each compiled variant exports getDispatchTable in its own namespace.  Which ones exist is decided by CMake, which
+ * tells us via SIMDSP_HAVE_DISPATCH_<VARIANT>.
+ */
+#define DECLARE_VARIANT(NS)                                                                                            \
+  namespace NS {                                                                                                       \
+  const DispatchTable *getDispatchTable();                                                                             \
+  }
+
+DECLARE_VARIANT(arch_generic)
+#if SIMDSP_HAVE_DISPATCH_X86_SSE2
+DECLARE_VARIANT(arch_sse2)
+#endif
+#if SIMDSP_HAVE_DISPATCH_X86_AVX
+DECLARE_VARIANT(arch_avx)
+#endif
+#if SIMDSP_HAVE_DISPATCH_X86_AVX2
+DECLARE_VARIANT(arch_avx2)
+#endif
+#if SIMDSP_HAVE_DISPATCH_X86_AVX512F
+DECLARE_VARIANT(arch_avx512f)
+#endif
+#if SIMDSP_HAVE_DISPATCH_AARCH64_NEON
+DECLARE_VARIANT(arch_neon)
+#endif
+#if SIMDSP_HAVE_DISPATCH_AARCH64_SVE
+DECLARE_VARIANT(arch_sve)
+#endif
+
+#undef DECLARE_VARIANT
+
+/*
+ * Returns null if the variant wasn't compiled in.
+ */
+static const DispatchTable *getCompiledTable(DispatchVariant variant) {
+  switch (variant) {
+  case DispatchVariant::GENERIC:
+    return arch_generic::getDispatchTable();
+#if SIMDSP_HAVE_DISPATCH_X86_SSE2
+  case DispatchVariant::X86_SSE2:
+    return arch_sse2::getDispatchTable();
+#endif
+#if SIMDSP_HAVE_DISPATCH_X86_AVX
+  case DispatchVariant::X86_AVX:
+    return arch_avx::getDispatchTable();
+#endif
+#if SIMDSP_HAVE_DISPATCH_X86_AVX2
+  case DispatchVariant::X86_AVX2:
+    return arch_avx2::getDispatchTable();
+#endif
+#if SIMDSP_HAVE_DISPATCH_X86_AVX512F
+  case DispatchVariant::X86_AVX512F:
+    return arch_avx512f::getDispatchTable();
+#endif
+#if SIMDSP_HAVE_DISPATCH_AARCH64_NEON
+  case DispatchVariant::AARCH64_NEON:
+    return arch_neon::getDispatchTable();
+#endif
+#if SIMDSP_HAVE_DISPATCH_AARCH64_SVE
+  case DispatchVariant::AARCH64_SVE:
+    return arch_sve::getDispatchTable();
+#endif
+  default:
+    return nullptr;
+  }
+}
+
+#endif
+
+std::atomic<const DispatchTable *> dispatch_table_cache{nullptr};
+
+const char *dispatchVariantToString(DispatchVariant variant) {
+  switch (variant) {
+  case DispatchVariant::GENERIC:
+    return "generic";
+  case DispatchVariant::X86_SSE2:
+    return "x86_sse2";
+  case DispatchVariant::X86_AVX:
+    return "x86_avx";
+  case DispatchVariant::X86_AVX2:
+    return "x86_avx2";
+  case DispatchVariant::X86_AVX512F:
+    return "x86_avx512f";
+  case DispatchVariant::AARCH64_NEON:
+    return "aarch64_neon";
+  case DispatchVariant::AARCH64_SVE:
+    return "aarch64_sve";
+  }
+
+  return "unknown";
+}
+
+bool isDispatchVariantCompiled(DispatchVariant variant) { return getCompiledTable(variant) != nullptr; }
+
+/*
+ * Can the CPU described by caps run the given variant?
+ *
+ * The compiler flags for a variant imply everything below it (e.g. -mavx2 turns on AVX and all the SSE levels), so
+ * the checks here must cover everything the flags in CMakeLists.txt let the compiler use.
+ */
+static bool canRunVariant(DispatchVariant variant, CpuCapabilities caps) {
+  switch (variant) {
+  case DispatchVariant::GENERIC:
+    return true;
+  case DispatchVariant::X86_SSE2:
+    return (caps & CpuCapabilities::X86_SSE2) != 0;
+  case DispatchVariant::X86_AVX:
+    return (caps & CpuCapabilities::X86_AVX) != 0;
+  case DispatchVariant::X86_AVX2:
+    return (caps & CpuCapabilities::X86_AVX2) != 0 && (caps & CpuCapabilities::X86_FMA3) != 0;
+  case DispatchVariant::X86_AVX512F:
+    return (caps & CpuCapabilities::X86_AVX512F) != 0 && (caps & CpuCapabilities::X86_AVX2) != 0 &&
+           (caps & CpuCapabilities::X86_FMA3) != 0;
+  case DispatchVariant::AARCH64_NEON:
+    // AdvSIMD is mandatory on AArch64.
+    return true;
+  case DispatchVariant::AARCH64_SVE:
+    return (caps & CpuCapabilities::AARCH64_SVE) != 0;
+  }
+
+  return false;
+}
+
+/*
+ * Widest first.  The first variant which is both compiled in and runnable wins.
+ */
+static const DispatchVariant PREFERENCE_ORDER[] = {
+    DispatchVariant::X86_AVX512F, DispatchVariant::X86_AVX2,    DispatchVariant::X86_AVX,
+    DispatchVariant::X86_SSE2,    DispatchVariant::AARCH64_SVE, DispatchVariant::AARCH64_NEON,
+    DispatchVariant::GENERIC,
+};
+
+/*
+ * Where a variant sits among those of its architecture, for caps: families are 1 for x86 and 2 for AArch64, and wider
+ * variants have higher ranks.  GENERIC is family 0, below everything.
+ */
+static void getVariantFamilyAndRank(DispatchVariant variant, int *family, int *rank) {
+  switch (variant) {
+  case DispatchVariant::GENERIC:
+    *family = 0;
+    *rank = 0;
+    return;
+  case DispatchVariant::X86_SSE2:
+  case DispatchVariant::X86_AVX:
+  case DispatchVariant::X86_AVX2:
+  case DispatchVariant::X86_AVX512F:
+    *family = 1;
+    *rank = (int)variant - (int)DispatchVariant::X86_SSE2 + 1;
+    return;
+  case DispatchVariant::AARCH64_NEON:
+  case DispatchVariant::AARCH64_SVE:
+    *family = 2;
+    *rank = (int)variant - (int)DispatchVariant::AARCH64_NEON + 1;
+    return;
+  }
+
+  *family = -1;
+  *rank = 0;
+}
+
+bool parseDispatchVariant(const char *name, DispatchVariant *out) {
+  auto equalsIgnoringCase = [](const char *a, const char *b) {
+    for (; *a != '\0' && *b != '\0'; a++, b++) {
+      char ca = *a >= 'A' && *a <= 'Z' ? (char)(*a - 'A' + 'a') : *a;
+      if (ca != *b) {
+        return false;
+      }
+    }
+    return *a == *b;
+  };
+
+  for (DispatchVariant variant : PREFERENCE_ORDER) {
+    const char *full = dispatchVariantToString(variant);
+    const char *prefix_end = strchr(full, '_');
+    if (equalsIgnoringCase(name, full) || (prefix_end != nullptr && equalsIgnoringCase(name, prefix_end + 1))) {
+      *out = variant;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+ * The cap is a DispatchVariant, or one of these.  Until someone sets it, it comes from the environment.
+ */
+enum : int {
+  MAX_VARIANT_NONE = -1,
+  MAX_VARIANT_FROM_ENVIRONMENT = -2,
+};
+
+static std::atomic<int> max_variant{MAX_VARIANT_FROM_ENVIRONMENT};
+
+static int getEnvironmentMaxVariant() {
+  static const int from_environment = []() {
+    const char *value = getenv("SIMDSP_MAX_ISA");
+    DispatchVariant variant;
+    if (value == nullptr || parseDispatchVariant(value, &variant) == false) {
+      return (int)MAX_VARIANT_NONE;
+    }
+    return (int)variant;
+  }();
+  return from_environment;
+}
+
+static int loadMaxVariant() {
+  int cap = max_variant.load(std::memory_order_relaxed);
+  return cap == MAX_VARIANT_FROM_ENVIRONMENT ? getEnvironmentMaxVariant() : cap;
+}
+
+static bool isWithinMaxVariant(DispatchVariant variant) {
+  int cap = loadMaxVariant();
+  if (cap == MAX_VARIANT_NONE || variant == DispatchVariant::GENERIC) {
+    return true;
+  }
+
+  int family, rank, cap_family, cap_rank;
+  getVariantFamilyAndRank(variant, &family, &rank);
+  getVariantFamilyAndRank((DispatchVariant)cap, &cap_family, &cap_rank);
+  return family == cap_family && rank <= cap_rank;
+}
+
+/*
+ * Runnable variants which still shouldn't be picked automatically.  SVE at 128 bits does the same work as NEON with
+ * predication on top, e.g. on Graviton4 and most phones.
+ */
+static bool isVariantWorthIt(DispatchVariant variant, const SystemInfo &info) {
+  if (variant == DispatchVariant::AARCH64_SVE) {
+    return info.sve_vector_bytes > 16;
+  }
+  return true;
+}
+
+const DispatchTable *resolveDispatchTable() {
+  SystemInfo info = getSystemInfo();
+  const DispatchTable *table = nullptr;
+
+  for (DispatchVariant variant : PREFERENCE_ORDER) {
+    if (canRunVariant(variant, info.cpu_capabilities) == false || isWithinMaxVariant(variant) == false ||
+        isVariantWorthIt(variant, info) == false) {
+      continue;
+    }
+
+    table = getCompiledTable(variant);
+    if (table != nullptr) {
+      break;
+    }
+  }
+
+  // Every thread which races here computes the same answer, so there's no need for anything more than a store.
+  dispatch_table_cache.store(table, std::memory_order_release);
+  return table;
+}
+
+DispatchVariant getDispatchVariant() { return getDispatchTable()->variant; }
+
+bool isDispatchVariantRunnable(DispatchVariant variant) {
+  return canRunVariant(variant, getSystemInfo().cpu_capabilities) && isWithinMaxVariant(variant) &&
+         getCompiledTable(variant) != nullptr;
+}
+
+bool forceDispatchVariant(DispatchVariant variant) {
+  if (isDispatchVariantRunnable(variant) == false) {
+    return false;
+  }
+
+  dispatch_table_cache.store(getCompiledTable(variant), std::memory_order_release);
+  return true;
+}
+
+void resetDispatchVariant() { resolveDispatchTable(); }
+
+void setMaxDispatchVariant(DispatchVariant variant) {
+  max_variant.store((int)variant, std::memory_order_relaxed);
+  resolveDispatchTable();
+}
+
+void resetMaxDispatchVariant() {
+  max_variant.store(MAX_VARIANT_FROM_ENVIRONMENT, std::memory_order_relaxed);
+  resolveDispatchTable();
+}
+
+bool getMaxDispatchVariant(DispatchVariant *out) {
+  int cap = loadMaxVariant();
+  if (cap == MAX_VARIANT_NONE) {
+    return false;
+  }
+  *out = (DispatchVariant)cap;
+  return true;
+}
+
+} // namespace simdsp
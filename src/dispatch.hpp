@@ -0,0 +1,47 @@
+#pragma once
+
+/*
+ * Vanilla-side access to the dispatch table.  Must not be included from anything under src/dispatched.
+ *
+ * Static builds have one variant, built with the same flags as the vanilla side, so there the vanilla side can see
+ * that variant's table directly.
+ */
+
+#include "dispatch_table.hpp"
+
+#if SIMDSP_STATIC_DISPATCH
+#include "dispatched/dispatch_table_definition.hpp"
+#endif
+
+#include <atomic>
+
+namespace simdsp {
+
+/*
+ * Null until the first call to resolveDispatchTable.  Points at a table with static storage duration afterwards.
+ */
+extern std::atomic<const DispatchTable *> dispatch_table_cache;
+
+/*
+ * Slow path: work out which variant to use from getSystemInfo(), store it to the cache, and return it.
+ */
+const DispatchTable *resolveDispatchTable();
+
+/*
+ * Get the dispatch table.  After the first call this is a load and a (predictable) branch, so calling through the
+ * returned table costs one indirect call.  In static builds the table is a constant, and calling through it is a direct
+ * call.
+ */
+inline const DispatchTable *getDispatchTable() {
+#if SIMDSP_STATIC_DISPATCH
+  return &SIMDPP_ARCH_NAMESPACE::dispatch_table;
+#else
+  const DispatchTable *table = dispatch_table_cache.load(std::memory_order_acquire);
+  if (table != nullptr) {
+    return table;
+  }
+  return resolveDispatchTable();
+#endif
+}
+
+} // namespace simdsp
@@ -0,0 +1,90 @@
+#include "simdsp/convolution/batch_convolution.hpp"
+
+#include "batch_convolution_kernel.hpp"
+#include "dispatched/convolution/direct_convolution.hpp"
+#include "dispatched/dispatched_functions.hpp"
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+static const unsigned int LANES = BATCH_CONVOLUTION_LANES;
+
+/*
+ * Write one lane of the transposed output back to its job's channel, under the job's mode.  ADD is a template
+ * parameter, as in writeBlockOutput, so the per-sample loop doesn't branch on it.
+ */
+template <bool ADD>
+static void scatterLane(const float *t_output, unsigned int lane, float *out, unsigned int channels,
+                        unsigned int frames, const OutputMode &mode) {
+  float gain_delta = (mode.gain_end - mode.gain_start) / (float)frames;
+  for (unsigned int i = 0; i < frames; i++) {
+    float gain = getRampGain(mode.gain_start, gain_delta, i);
+    float *o = out + i * channels;
+    *o = (ADD ? *o : 0.0f) + t_output[i * LANES + lane] * gain;
+  }
+}
+
+void batchBlockConvolver(const BatchConvolutionJob *jobs, unsigned int job_count, unsigned int channels,
+                         unsigned int input_len, unsigned int impulse_len, float *workspace) {
+  unsigned int history_len = impulse_len - 1 + input_len;
+  // Everything in workspace is [frame][lane].
+  float *t_input = workspace;
+  float *t_impulse = t_input + history_len * LANES;
+  float *t_output = t_impulse + impulse_len * LANES;
+
+  unsigned int total_lanes = job_count * channels;
+  for (unsigned int first_lane = 0; first_lane < total_lanes; first_lane += LANES) {
+    unsigned int lanes = total_lanes - first_lane < LANES ? total_lanes - first_lane : LANES;
+
+    // Gather.  Unused lanes are zeroed so the arithmetic below can always run at full width.
+    for (unsigned int lane = 0; lane < LANES; lane++) {
+      if (lane >= lanes) {
+        for (unsigned int i = 0; i < history_len; i++) {
+          t_input[i * LANES + lane] = 0.0f;
+        }
+        for (unsigned int i = 0; i < impulse_len; i++) {
+          t_impulse[i * LANES + lane] = 0.0f;
+        }
+        continue;
+      }
+
+      const BatchConvolutionJob &job = jobs[(first_lane + lane) / channels];
+      unsigned int ch = (first_lane + lane) % channels;
+      const float *in = job.input - (impulse_len - 1) * channels + ch;
+      const float *imp = job.impulse + ch;
+      for (unsigned int i = 0; i < history_len; i++) {
+        t_input[i * LANES + lane] = in[i * channels];
+      }
+      for (unsigned int i = 0; i < impulse_len; i++) {
+        t_impulse[i * LANES + lane] = imp[i * channels];
+      }
+    }
+
+    for (unsigned int sample = 0; sample < input_len; sample++) {
+      float acc[LANES] = {0.0f};
+      const float *window = t_input + sample * LANES;
+      for (unsigned int k = 0; k < impulse_len; k++) {
+        for (unsigned int lane = 0; lane < LANES; lane++) {
+          acc[lane] += window[k * LANES + lane] * t_impulse[k * LANES + lane];
+        }
+      }
+      for (unsigned int lane = 0; lane < LANES; lane++) {
+        t_output[sample * LANES + lane] = acc[lane];
+      }
+    }
+
+    // Scatter.
+    for (unsigned int lane = 0; lane < lanes; lane++) {
+      const BatchConvolutionJob &job = jobs[(first_lane + lane) / channels];
+      unsigned int ch = (first_lane + lane) % channels;
+      if (job.mode.add) {
+        scatterLane<true>(t_output, lane, job.output + ch, channels, input_len, job.mode);
+      } else {
+        scatterLane<false>(t_output, lane, job.output + ch, channels, input_len, job.mode);
+      }
+    }
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
@@ -0,0 +1,51 @@
+#include "dispatched/convolution/direct_convolution.hpp"
+#include "dispatched/dispatched_functions.hpp"
+
+#include <stddef.h>
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * The result for frame i is from[i], or with a crossfade from[i] + (to[i] - from[i]) * (i + 1) / frames, so the last
+ * frame is entirely to and the block after a crossfade continues from it without a step.
+ */
+template <bool ADD, bool CROSSFADE>
+static void writeOutput(const float *from, const float *to, float *output, size_t frames, size_t output_stride,
+                        const OutputMode &mode) {
+  float step = 1.0f / (float)frames;
+  float gain_delta = (mode.gain_end - mode.gain_start) * step;
+
+  for (size_t i = 0; i < frames; i++) {
+    float position = (float)(int)(i + 1);
+    float value = CROSSFADE ? from[i] + (to[i] - from[i]) * (position * step) : from[i];
+    float gain = getRampGain(mode.gain_start, gain_delta, i);
+    float *o = output + i * output_stride;
+    *o = (ADD ? *o : 0.0f) + value * gain;
+  }
+}
+
+/*
+ * Write one channel of a block, output_stride apart, under mode, crossfading from from to to unless to is null.
+ */
+void writeBlockOutput(const float *from, const float *to, float *output, unsigned int frames,
+                      unsigned int output_stride, const OutputMode *mode) {
+  if (frames == 0) {
+    return;
+  }
+
+  if (to != nullptr) {
+    if (mode->add) {
+      writeOutput<true, true>(from, to, output, frames, output_stride, *mode);
+    } else {
+      writeOutput<false, true>(from, to, output, frames, output_stride, *mode);
+    }
+  } else if (mode->add) {
+    writeOutput<true, false>(from, to, output, frames, output_stride, *mode);
+  } else {
+    writeOutput<false, false>(from, to, output, frames, output_stride, *mode);
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
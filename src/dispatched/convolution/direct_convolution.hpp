@@ -0,0 +1,76 @@
+#pragma once
+
+/*
+ * Pieces shared by the direct convolution kernels (genericBlockConvolver, tiledBlockConvolver, and for the ramp
+ * batchBlockConvolver and writeBlockOutput), compiled into each of them per variant.  Only for src/dispatched, since
+ * everything here is in the variant's namespace.
+ */
+
+#include "simdsp/feature_macros.hpp"
+
+#include <stddef.h>
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * Taps applied per pass over the output in the specialized kernels.  Their coefficients stay in registers across the
+ * pass, so each output frame is loaded and stored once per TAP_GROUP taps rather than once per tap.
+ */
+static const unsigned int TAP_GROUP = 8;
+
+/*
+ * The gain of output frame i under a ramp, by the convention of OutputMode.  Through int because there's no vector
+ * conversion from 64-bit integers below AVX-512.
+ */
+static inline float getRampGain(float gain_start, float gain_delta, size_t i) {
+  return gain_start + gain_delta * (float)(int)(i + 1);
+}
+
+/*
+ * One pass of a group of taps over output frames [frame_begin, frame_end), with the channel count a compile-time
+ * constant.  FROM_ZERO is for the first pass when replacing, which doesn't read the output at all.
+ *
+ * Without a ramp the gain is already in the coefficients, and the sums go straight into the output.  With one, the
+ * pass's sum is scaled by each frame's gain on the way in.
+ */
+template <unsigned int CHANNELS, bool FROM_ZERO, bool RAMP>
+static void applyTapGroup(const float *x_base, const float (*coefficients)[CHANNELS], float *output, size_t frame_begin,
+                          size_t frame_end, float gain_start, float gain_delta) {
+  // A local copy, which the compiler can see nothing else writes, so that it stays in registers across the stores to
+  // output.
+  float h[TAP_GROUP][CHANNELS];
+  for (size_t t = 0; t < TAP_GROUP; t++) {
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+      h[t][ch] = coefficients[t][ch];
+    }
+  }
+
+  for (size_t frame = frame_begin; frame < frame_end; frame++) {
+    const float *x = x_base + frame * CHANNELS;
+    float *o = output + frame * CHANNELS;
+    float acc[CHANNELS];
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+      acc[ch] = FROM_ZERO || RAMP ? 0.0f : o[ch];
+    }
+    for (size_t t = 0; t < TAP_GROUP; t++) {
+      for (size_t ch = 0; ch < CHANNELS; ch++) {
+        acc[ch] += x[t * CHANNELS + ch] * h[t][ch];
+      }
+    }
+
+    if (RAMP) {
+      float gain = getRampGain(gain_start, gain_delta, frame);
+      for (size_t ch = 0; ch < CHANNELS; ch++) {
+        o[ch] = (FROM_ZERO ? 0.0f : o[ch]) + acc[ch] * gain;
+      }
+    } else {
+      for (size_t ch = 0; ch < CHANNELS; ch++) {
+        o[ch] = acc[ch];
+      }
+    }
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
@@ -0,0 +1,30 @@
+#include "dispatched/dispatched_functions.hpp"
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * acc += a * b over n split complex values.
+ */
+void complexMultiplyAccumulate(const float *a_re, const float *a_im, const float *b_re, const float *b_im,
+                               float *acc_re, float *acc_im, unsigned int n) {
+  for (unsigned int i = 0; i < n; i++) {
+    acc_re[i] += a_re[i] * b_re[i] - a_im[i] * b_im[i];
+    acc_im[i] += a_re[i] * b_im[i] + a_im[i] * b_re[i];
+  }
+}
+
+/*
+ * a *= b over n split complex values.
+ */
+void complexMultiplyInPlace(float *a_re, float *a_im, const float *b_re, const float *b_im, unsigned int n) {
+  for (unsigned int i = 0; i < n; i++) {
+    float r = a_re[i] * b_re[i] - a_im[i] * b_im[i];
+    float im = a_re[i] * b_im[i] + a_im[i] * b_re[i];
+    a_re[i] = r;
+    a_im[i] = im;
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
@@ -1,26 +1,157 @@
-#include "simdsp/convolution/generic_block_convolution.hpp"
+#include "dispatched/convolution/direct_convolution.hpp"
+#include "dispatched/dispatched_functions.hpp"
+
+#include <stddef.h>
 
 namespace simdsp {
 namespace SIMDPP_ARCH_NAMESPACE {
 
-void genericBlockConvolver(float *input, unsigned int input_len, unsigned int input_channels, float *impulse,
-                           unsigned int impulse_len, float *output) {
-  float *hstart = input - (impulse_len + 1) * input_channels;
-  for (unsigned int sample = 0; sample < input_len; sample++) {
+/*
+ * Channels the runtime fallback accumulates at once.
+ */
+static const unsigned int CHANNEL_CHUNK = 16;
+
+/*
+ * The fallback for shapes without a specialization: runtime everything, channels innermost, a chunk of channels at a
+ * time so that each output frame is written once.
+ */
+template <bool RAMP>
+static void convolveRuntimeShape(const float *input, size_t input_len, size_t input_channels, const float *impulse,
+                                 size_t impulse_len, float *output, const OutputMode &mode, float gain_delta) {
+  const float *hstart = input - (impulse_len - 1) * input_channels;
+
+  for (size_t sample = 0; sample < input_len; sample++) {
     float *oframe = output + sample * input_channels;
+    float gain = RAMP ? getRampGain(mode.gain_start, gain_delta, sample) : mode.gain_start;
+
+    for (size_t ch_begin = 0; ch_begin < input_channels; ch_begin += CHANNEL_CHUNK) {
+      size_t ch_count = input_channels - ch_begin < CHANNEL_CHUNK ? input_channels - ch_begin : CHANNEL_CHUNK;
+      float acc[CHANNEL_CHUNK] = {};
 
-    for (unsigned int impulse_ind = 0; impulse_ind < impulse_len; impulse_ind++) {
-      float *iframe = hstart + (sample + impulse_ind) * input_channels;
-      float *impulseframe = impulse + impulse_ind * input_channels;
-      for (unsigned int ch = 0; ch < input_channels; ch++) {
-        oframe[ch] += iframe[ch] * impulseframe[ch];
+      for (size_t impulse_ind = 0; impulse_ind < impulse_len; impulse_ind++) {
+        const float *iframe = hstart + (sample + impulse_ind) * input_channels + ch_begin;
+        const float *impulseframe = impulse + impulse_ind * input_channels + ch_begin;
+        for (size_t ch = 0; ch < ch_count; ch++) {
+          acc[ch] += iframe[ch] * impulseframe[ch];
+        }
+      }
+
+      for (size_t ch = 0; ch < ch_count; ch++) {
+        oframe[ch_begin + ch] = (mode.add ? oframe[ch_begin + ch] : 0.0f) + acc[ch] * gain;
       }
     }
   }
 }
 
-} // namespace SIMDPP_ARCH_NAMESPACE
+/*
+ * CHANNELS, and IMPULSE_LEN unless it is 0, are compile-time constants here.
+ *
+ * With the channel count known, a frame is a fixed-size group of floats, so the loop over output frames vectorizes
+ * with whole frames (or several of them) per vector and the per-channel coefficients as a repeating pattern, rather
+ * than leaving most of a vector idle on a short runtime channel loop.  A known impulse length additionally lets the
+ * compiler unroll the loop over tap groups and drop the tail.
+ *
+ * Indices are size_t: with 32-bit indices GCC can't prove consecutive frames are contiguous, and for mono falls back to
+ * scalar code.
+ */
+template <unsigned int CHANNELS, unsigned int IMPULSE_LEN, bool RAMP>
+static void convolveFixedShape(const float *input, size_t input_len, const float *impulse,
+                               size_t runtime_impulse_len, float *output, const OutputMode &mode, float gain_delta) {
+  static_assert(IMPULSE_LEN % TAP_GROUP == 0, "Fixed impulse lengths must be whole tap groups");
+  const size_t impulse_len = IMPULSE_LEN != 0 ? IMPULSE_LEN : runtime_impulse_len;
+  const float *hstart = input - (impulse_len - 1) * CHANNELS;
+  // Without a ramp, the gain goes into the coefficients.
+  const float coefficient_gain = RAMP ? 1.0f : mode.gain_start;
+  size_t tap = 0;
+
+  // Only possible for runtime lengths, which have no full group to do the replacing.
+  if (!mode.add && impulse_len < TAP_GROUP) {
+    for (size_t i = 0; i < input_len * CHANNELS; i++) {
+      output[i] = 0.0f;
+    }
+  }
+
+  for (; tap + TAP_GROUP <= impulse_len; tap += TAP_GROUP) {
+    float h[TAP_GROUP][CHANNELS];
+    for (size_t t = 0; t < TAP_GROUP; t++) {
+      for (size_t ch = 0; ch < CHANNELS; ch++) {
+        h[t][ch] = impulse[(tap + t) * CHANNELS + ch] * coefficient_gain;
+      }
+    }
+
+    const float *x_base = hstart + tap * CHANNELS;
+    if (tap == 0 && !mode.add) {
+      applyTapGroup<CHANNELS, true, RAMP>(x_base, h, output, 0, input_len, mode.gain_start, gain_delta);
+    } else {
+      applyTapGroup<CHANNELS, false, RAMP>(x_base, h, output, 0, input_len, mode.gain_start, gain_delta);
+    }
+  }
+
+  // Only compiled for runtime lengths: the fixed ones are all multiples of TAP_GROUP, and an instantiated but dead tail
+  // is indexing GCC can prove goes out of bounds, which it warns about.
+  if constexpr (IMPULSE_LEN == 0) {
+    for (; tap < impulse_len; tap++) {
+      for (size_t frame = 0; frame < input_len; frame++) {
+        float gain = RAMP ? getRampGain(mode.gain_start, gain_delta, frame) : coefficient_gain;
+        for (size_t ch = 0; ch < CHANNELS; ch++) {
+          output[frame * CHANNELS + ch] += hstart[(frame + tap) * CHANNELS + ch] * impulse[tap * CHANNELS + ch] * gain;
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Pick the impulse length specialization for a channel count, or the one with only the channel count fixed.
+ */
+template <unsigned int CHANNELS, bool RAMP>
+static void convolveFixedChannels(const float *input, size_t input_len, const float *impulse, size_t impulse_len,
+                                  float *output, const OutputMode &mode, float gain_delta) {
+  switch (impulse_len) {
+  case 32:
+    return convolveFixedShape<CHANNELS, 32, RAMP>(input, input_len, impulse, impulse_len, output, mode, gain_delta);
+  case 64:
+    return convolveFixedShape<CHANNELS, 64, RAMP>(input, input_len, impulse, impulse_len, output, mode, gain_delta);
+  case 128:
+    return convolveFixedShape<CHANNELS, 128, RAMP>(input, input_len, impulse, impulse_len, output, mode, gain_delta);
+  case 256:
+    return convolveFixedShape<CHANNELS, 256, RAMP>(input, input_len, impulse, impulse_len, output, mode, gain_delta);
+  default:
+    return convolveFixedShape<CHANNELS, 0, RAMP>(input, input_len, impulse, impulse_len, output, mode, gain_delta);
+  }
+}
+
+template <bool RAMP>
+static void convolve(const float *input, size_t input_len, unsigned int input_channels, const float *impulse,
+                     size_t impulse_len, float *output, const OutputMode &mode, float gain_delta) {
+  switch (input_channels) {
+  case 1:
+    return convolveFixedChannels<1, RAMP>(input, input_len, impulse, impulse_len, output, mode, gain_delta);
+  case 2:
+    return convolveFixedChannels<2, RAMP>(input, input_len, impulse, impulse_len, output, mode, gain_delta);
+  case 4:
+    return convolveFixedChannels<4, RAMP>(input, input_len, impulse, impulse_len, output, mode, gain_delta);
+  case 8:
+    return convolveFixedChannels<8, RAMP>(input, input_len, impulse, impulse_len, output, mode, gain_delta);
+  default:
+    return convolveRuntimeShape<RAMP>(input, input_len, input_channels, impulse, impulse_len, output, mode,
+                                      gain_delta);
+  }
+}
 
 void genericBlockConvolver(float *input, unsigned int input_len, unsigned int input_channels, float *impulse,
-                           unsigned int impulse_len, float *output) {}
+                           unsigned int impulse_len, float *output, const OutputMode *mode) {
+  if (input_len == 0) {
+    return;
+  }
+
+  if (mode->gain_start == mode->gain_end) {
+    convolve<false>(input, input_len, input_channels, impulse, impulse_len, output, *mode, 0.0f);
+  } else {
+    float gain_delta = (mode->gain_end - mode->gain_start) / (float)input_len;
+    convolve<true>(input, input_len, input_channels, impulse, impulse_len, output, *mode, gain_delta);
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
 } // namespace simdsp
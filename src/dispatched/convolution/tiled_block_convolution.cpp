@@ -0,0 +1,157 @@
+#include "dispatched/convolution/direct_convolution.hpp"
+#include "dispatched/dispatched_functions.hpp"
+
+#include <stddef.h>
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * Accumulate taps [tap_begin, tap_end) of one channel into output frames [frame_begin, frame_end), for channel counts
+ * without a specialization.  Strided, but still reuses every load TAP_GROUP times.
+ *
+ * The output modes work as in convolveTile, with from_zero a runtime flag since this is the slow path anyway.
+ */
+template <bool RAMP>
+static void convolveChannelTile(const float *hstart, size_t channels, const float *impulse, float *output,
+                                size_t frame_begin, size_t frame_end, size_t tap_begin, size_t tap_end, bool from_zero,
+                                float coefficient_gain, float gain_start, float gain_delta) {
+  size_t tap = tap_begin;
+
+  for (; tap + TAP_GROUP <= tap_end; tap += TAP_GROUP) {
+    float h[TAP_GROUP];
+    for (size_t t = 0; t < TAP_GROUP; t++) {
+      h[t] = impulse[(tap + t) * channels] * coefficient_gain;
+    }
+
+    for (size_t frame = frame_begin; frame < frame_end; frame++) {
+      const float *x = hstart + (frame + tap) * channels;
+      float previous = from_zero ? 0.0f : output[frame * channels];
+      float acc = RAMP ? 0.0f : previous;
+      for (size_t t = 0; t < TAP_GROUP; t++) {
+        acc += x[t * channels] * h[t];
+      }
+      output[frame * channels] = RAMP ? previous + acc * getRampGain(gain_start, gain_delta, frame) : acc;
+    }
+    from_zero = false;
+  }
+
+  for (; tap < tap_end; tap++) {
+    float h = impulse[tap * channels] * coefficient_gain;
+    for (size_t frame = frame_begin; frame < frame_end; frame++) {
+      float gain = RAMP ? getRampGain(gain_start, gain_delta, frame) : 1.0f;
+      output[frame * channels] += hstart[(frame + tap) * channels] * h * gain;
+    }
+  }
+}
+
+/*
+ * All channels of an output tile at once, with the channel count a compile-time constant so that the loop over output
+ * frames vectorizes with whole frames per vector (see genericBlockConvolver).
+ */
+template <unsigned int CHANNELS, bool RAMP>
+static void convolveTile(const float *hstart, const float *impulse, float *output, size_t frame_begin,
+                         size_t frame_end, size_t tap_begin, size_t tap_end, bool from_zero, float coefficient_gain,
+                         float gain_start, float gain_delta) {
+  size_t tap = tap_begin;
+
+  for (; tap + TAP_GROUP <= tap_end; tap += TAP_GROUP) {
+    float h[TAP_GROUP][CHANNELS];
+    for (size_t t = 0; t < TAP_GROUP; t++) {
+      for (size_t ch = 0; ch < CHANNELS; ch++) {
+        h[t][ch] = impulse[(tap + t) * CHANNELS + ch] * coefficient_gain;
+      }
+    }
+
+    const float *x_base = hstart + tap * CHANNELS;
+    if (from_zero) {
+      applyTapGroup<CHANNELS, true, RAMP>(x_base, h, output, frame_begin, frame_end, gain_start, gain_delta);
+      from_zero = false;
+    } else {
+      applyTapGroup<CHANNELS, false, RAMP>(x_base, h, output, frame_begin, frame_end, gain_start, gain_delta);
+    }
+  }
+
+  for (; tap < tap_end; tap++) {
+    for (size_t frame = frame_begin; frame < frame_end; frame++) {
+      float gain = RAMP ? getRampGain(gain_start, gain_delta, frame) : 1.0f;
+      for (size_t ch = 0; ch < CHANNELS; ch++) {
+        output[frame * CHANNELS + ch] +=
+            hstart[(frame + tap) * CHANNELS + ch] * impulse[tap * CHANNELS + ch] * coefficient_gain * gain;
+      }
+    }
+  }
+}
+
+template <bool RAMP>
+static void convolveTiled(const float *input, size_t input_len, unsigned int input_channels, const float *impulse,
+                          size_t impulse_len, float *output, size_t tile_taps, size_t tile_frames,
+                          const OutputMode &mode, float gain_delta) {
+  const float *hstart = input - (impulse_len - 1) * input_channels;
+  // Without a ramp, the gain goes into the coefficients.
+  const float coefficient_gain = RAMP ? 1.0f : mode.gain_start;
+
+  // Replacing is done by the first group of taps of the first tap tile.  If there isn't a whole group there, zero
+  // first.
+  size_t first_tile_taps = impulse_len < tile_taps ? impulse_len : tile_taps;
+  if (!mode.add && first_tile_taps < TAP_GROUP) {
+    for (size_t i = 0; i < input_len * input_channels; i++) {
+      output[i] = 0.0f;
+    }
+  }
+
+  // A tile of taps, and the input it slides over, stays in L2 while it's applied to every output tile.  An output tile
+  // and the input under it stay in L1 while every tap of the tap tile passes over them.
+  for (size_t tap_begin = 0; tap_begin < impulse_len; tap_begin += tile_taps) {
+    size_t tap_end = impulse_len - tap_begin < tile_taps ? impulse_len : tap_begin + tile_taps;
+    bool from_zero = !mode.add && tap_begin == 0 && first_tile_taps >= TAP_GROUP;
+
+    for (size_t frame_begin = 0; frame_begin < input_len; frame_begin += tile_frames) {
+      size_t frame_end = input_len - frame_begin < tile_frames ? input_len : frame_begin + tile_frames;
+
+      switch (input_channels) {
+      case 1:
+        convolveTile<1, RAMP>(hstart, impulse, output, frame_begin, frame_end, tap_begin, tap_end, from_zero,
+                              coefficient_gain, mode.gain_start, gain_delta);
+        break;
+      case 2:
+        convolveTile<2, RAMP>(hstart, impulse, output, frame_begin, frame_end, tap_begin, tap_end, from_zero,
+                              coefficient_gain, mode.gain_start, gain_delta);
+        break;
+      case 4:
+        convolveTile<4, RAMP>(hstart, impulse, output, frame_begin, frame_end, tap_begin, tap_end, from_zero,
+                              coefficient_gain, mode.gain_start, gain_delta);
+        break;
+      case 8:
+        convolveTile<8, RAMP>(hstart, impulse, output, frame_begin, frame_end, tap_begin, tap_end, from_zero,
+                              coefficient_gain, mode.gain_start, gain_delta);
+        break;
+      default:
+        for (size_t ch = 0; ch < input_channels; ch++) {
+          convolveChannelTile<RAMP>(hstart + ch, input_channels, impulse + ch, output + ch, frame_begin, frame_end,
+                                    tap_begin, tap_end, from_zero, coefficient_gain, mode.gain_start, gain_delta);
+        }
+      }
+    }
+  }
+}
+
+void tiledBlockConvolver(float *input, unsigned int input_len, unsigned int input_channels, float *impulse,
+                         unsigned int impulse_len, float *output, unsigned int tile_taps, unsigned int tile_frames,
+                         const OutputMode *mode) {
+  if (input_len == 0) {
+    return;
+  }
+
+  if (mode->gain_start == mode->gain_end) {
+    convolveTiled<false>(input, input_len, input_channels, impulse, impulse_len, output, tile_taps, tile_frames, *mode,
+                         0.0f);
+  } else {
+    float gain_delta = (mode->gain_end - mode->gain_start) / (float)input_len;
+    convolveTiled<true>(input, input_len, input_channels, impulse, impulse_len, output, tile_taps, tile_frames, *mode,
+                        gain_delta);
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
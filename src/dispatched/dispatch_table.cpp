@@ -0,0 +1,9 @@
+#include "dispatched/dispatch_table_definition.hpp"
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+const DispatchTable *getDispatchTable() { return &dispatch_table; }
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
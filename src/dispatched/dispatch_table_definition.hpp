@@ -0,0 +1,48 @@
+#pragma once
+
+/*
+ * The dispatch table of the variant being compiled.  Included by dispatch_table.cpp, and in static builds (see
+ * SIMDSP_STATIC_DISPATCH in CMakeLists.txt) by src/dispatch.hpp, where the vanilla side is built for the same variant.
+ */
+
+#include "dispatch_table.hpp"
+#include "dispatched/dispatched_functions.hpp"
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * Constant-initialized, so this is ready before any code runs and the vanilla side can hand out pointers to it without
+ * worrying about static initialization order.  constexpr so that static builds, whose vanilla side includes this
+ * directly, see every entry at compile time and call through the table with direct calls.
+ */
+inline constexpr DispatchTable dispatch_table = {
+    DispatchVariant::SIMDSP_DISPATCH_VARIANT,
+    genericBlockConvolver,
+    tiledBlockConvolver,
+    batchBlockConvolver,
+    complexMultiplyAccumulate,
+    complexMultiplyInPlace,
+    writeBlockOutput,
+    biquadFilterBank,
+    polyphaseResample,
+    mixGainRamp,
+    mixMatrix,
+    interleaveChannels,
+    deinterleaveChannels,
+    encodeSamples,
+    decodeSamples,
+    fftRadix2Pass,
+    fftRadix3Pass,
+    fftRadix4Pass,
+    fftRadix5Pass,
+    fftRadix8Pass,
+    fftSplitEvenOdd,
+    fftMergeEvenOdd,
+    fftTranspose,
+    realFftPostprocess,
+    realFftPreprocess,
+};
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
@@ -0,0 +1,67 @@
+#pragma once
+
+/*
+ * Declarations of everything in src/dispatched which goes into the dispatch table, in the namespace of whichever
+ * variant is being compiled.  In static builds that is SIMDSP_BASELINE_ARCH_NAMESPACE, from simdsp/feature_macros.hpp.
+ */
+
+#include "polyphase_kernel.hpp"
+#include "simdsp/convolution/batch_convolution.hpp"
+#include "simdsp/convolution/output_mode.hpp"
+#include "simdsp/feature_macros.hpp"
+#include "simdsp/mixing/sample_format.hpp"
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+void genericBlockConvolver(float *input, unsigned int input_len, unsigned int input_channels, float *impulse,
+                           unsigned int impulse_len, float *output, const OutputMode *mode);
+void tiledBlockConvolver(float *input, unsigned int input_len, unsigned int input_channels, float *impulse,
+                         unsigned int impulse_len, float *output, unsigned int tile_taps, unsigned int tile_frames,
+                         const OutputMode *mode);
+void batchBlockConvolver(const BatchConvolutionJob *jobs, unsigned int job_count, unsigned int channels,
+                         unsigned int input_len, unsigned int impulse_len, float *workspace);
+void complexMultiplyAccumulate(const float *a_re, const float *a_im, const float *b_re, const float *b_im,
+                               float *acc_re, float *acc_im, unsigned int n);
+void complexMultiplyInPlace(float *a_re, float *a_im, const float *b_re, const float *b_im, unsigned int n);
+void writeBlockOutput(const float *from, const float *to, float *output, unsigned int frames,
+                      unsigned int output_stride, const OutputMode *mode);
+
+void biquadFilterBank(const float *input, float *output, unsigned int frames, unsigned int lanes,
+                      unsigned int sections, float *coefficients, const float *deltas, float *state,
+                      unsigned int lane_stride);
+unsigned int polyphaseResample(const PolyphaseKernelArgs *args, unsigned int last_frame, unsigned int *frame,
+                               uint64_t *frac, float *output);
+
+void mixGainRamp(const float *input, float *output, unsigned int frames, unsigned int channels, float gain_start,
+                 float gain_end, bool add);
+void mixMatrix(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+               unsigned int frames, const float *from_matrix, const float *to_matrix, bool add);
+void interleaveChannels(const float *const *planar, unsigned int channels, unsigned int frames, float *output);
+void deinterleaveChannels(const float *input, unsigned int channels, unsigned int frames, float *const *planar);
+void encodeSamples(const float *const *planar, unsigned int channels, unsigned int frames, SampleFormat format,
+                   void *output, uint32_t *dither);
+void decodeSamples(const void *input, unsigned int channels, unsigned int frames, SampleFormat format,
+                   float *const *planar);
+
+void fftRadix2Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m);
+void fftRadix3Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m);
+void fftRadix4Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m);
+void fftRadix5Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m);
+void fftRadix8Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m);
+void fftSplitEvenOdd(const float *input, float *even, float *odd, unsigned int n);
+void fftMergeEvenOdd(const float *even, const float *odd, float *output, unsigned int n);
+void fftTranspose(const float *in_re, const float *in_im, float *out_re, float *out_im, unsigned int rows,
+                  unsigned int cols);
+void realFftPostprocess(const float *z_re, const float *z_im, float *x_re, float *x_im, const float *w_re,
+                        const float *w_im, unsigned int n);
+void realFftPreprocess(const float *x_re, const float *x_im, float *z_re, float *z_im, const float *w_re,
+                       const float *w_im, unsigned int n);
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
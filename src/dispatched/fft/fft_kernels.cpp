@@ -0,0 +1,374 @@
+/*
+ * The inner loops of the FFT.
+ *
+ * Everything here works on split complex data (separate real and imaginary arrays), which is what lets the compiler
+ * vectorize these loops without shuffles for the common cases.
+ *
+ * The passes are decimation-in-frequency Stockham passes.  For a radix R, a sub-transform of length R * m, and a given
+ * stride:
+ *
+ * a_k = x[q + stride * (p + k * m)] for k in 0..R
+ * y[q + stride * (R * p + j)] = DFT_R(a)_j * exp(-2 pi i j p / (R * m))
+ *
+ * For p in 0..m and q in 0..stride.  Stockham passes ping-pong between two buffers and leave the output in natural
+ * order, so there's no bit reversal.  The q loop is also what lets a pass run many interleaved transforms at once,
+ * which the six-step algorithm uses for its column transforms.
+ *
+ * Twiddles for a pass are stored as R - 1 runs of m values: run j - 1 holds exp(-2 pi i j p / (R * m)).
+ */
+#include "dispatched/dispatched_functions.hpp"
+
+#include <stddef.h>
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * Butterflies.  These transform R values in place.  Everything in this namespace is per-variant, so it's fine for these
+ * to be inlined.
+ */
+
+static inline void butterfly2(float *re, float *im) {
+  float r0 = re[0], i0 = im[0];
+  re[0] = r0 + re[1];
+  im[0] = i0 + im[1];
+  re[1] = r0 - re[1];
+  im[1] = i0 - im[1];
+}
+
+static inline void butterfly3(float *re, float *im) {
+  const float s = 0.86602540378443864676f; // sin(2 pi / 3)
+  float t1r = re[1] + re[2], t1i = im[1] + im[2];
+  float t2r = re[1] - re[2], t2i = im[1] - im[2];
+  float mr = re[0] - 0.5f * t1r, mi = im[0] - 0.5f * t1i;
+
+  re[0] += t1r;
+  im[0] += t1i;
+  // -i * s * t2 = (s * t2i, -s * t2r)
+  re[1] = mr + s * t2i;
+  im[1] = mi - s * t2r;
+  re[2] = mr - s * t2i;
+  im[2] = mi + s * t2r;
+}
+
+static inline void butterfly4(float *re, float *im) {
+  float t0r = re[0] + re[2], t0i = im[0] + im[2];
+  float t1r = re[0] - re[2], t1i = im[0] - im[2];
+  float t2r = re[1] + re[3], t2i = im[1] + im[3];
+  float t3r = re[1] - re[3], t3i = im[1] - im[3];
+
+  re[0] = t0r + t2r;
+  im[0] = t0i + t2i;
+  re[2] = t0r - t2r;
+  im[2] = t0i - t2i;
+  // t1 -/+ i * t3
+  re[1] = t1r + t3i;
+  im[1] = t1i - t3r;
+  re[3] = t1r - t3i;
+  im[3] = t1i + t3r;
+}
+
+static inline void butterfly5(float *re, float *im) {
+  const float c1 = 0.30901699437494742410f;  // cos(2 pi / 5)
+  const float c2 = -0.80901699437494742410f; // cos(4 pi / 5)
+  const float s1 = 0.95105651629515357212f;  // sin(2 pi / 5)
+  const float s2 = 0.58778525229247312917f;  // sin(4 pi / 5)
+
+  float t1r = re[1] + re[4], t1i = im[1] + im[4];
+  float t2r = re[2] + re[3], t2i = im[2] + im[3];
+  float t3r = re[1] - re[4], t3i = im[1] - im[4];
+  float t4r = re[2] - re[3], t4i = im[2] - im[3];
+
+  float m1r = re[0] + c1 * t1r + c2 * t2r, m1i = im[0] + c1 * t1i + c2 * t2i;
+  float m2r = re[0] + c2 * t1r + c1 * t2r, m2i = im[0] + c2 * t1i + c1 * t2i;
+  float n1r = s1 * t3r + s2 * t4r, n1i = s1 * t3i + s2 * t4i;
+  float n2r = s2 * t3r - s1 * t4r, n2i = s2 * t3i - s1 * t4i;
+
+  re[0] += t1r + t2r;
+  im[0] += t1i + t2i;
+  // m -/+ i * n
+  re[1] = m1r + n1i;
+  im[1] = m1i - n1r;
+  re[4] = m1r - n1i;
+  im[4] = m1i + n1r;
+  re[2] = m2r + n2i;
+  im[2] = m2i - n2r;
+  re[3] = m2r - n2i;
+  im[3] = m2i + n2r;
+}
+
+static inline void butterfly8(float *re, float *im) {
+  const float h = 0.70710678118654752440f; // sqrt(2) / 2
+  float er[4] = {re[0], re[2], re[4], re[6]}, ei[4] = {im[0], im[2], im[4], im[6]};
+  float or_[4] = {re[1], re[3], re[5], re[7]}, oi[4] = {im[1], im[3], im[5], im[7]};
+
+  butterfly4(er, ei);
+  butterfly4(or_, oi);
+
+  // Multiply the odd half by exp(-2 pi i j / 8) for j = 1, 2, 3.
+  float r, i;
+  r = h * (or_[1] + oi[1]);
+  i = h * (oi[1] - or_[1]);
+  or_[1] = r;
+  oi[1] = i;
+  r = oi[2];
+  i = -or_[2];
+  or_[2] = r;
+  oi[2] = i;
+  r = h * (oi[3] - or_[3]);
+  i = -h * (or_[3] + oi[3]);
+  or_[3] = r;
+  oi[3] = i;
+
+  for (unsigned int j = 0; j < 4; j++) {
+    re[j] = er[j] + or_[j];
+    im[j] = ei[j] + oi[j];
+    re[j + 4] = er[j] - or_[j];
+    im[j + 4] = ei[j] - oi[j];
+  }
+}
+
+/*
+ * The passes are plain loops which rely on the compiler to vectorize them.  Indices are size_t throughout: with 32-bit
+ * ones GCC can't prove the addresses are affine in the loop variable, since the arithmetic might wrap, and vectorizes
+ * nothing.
+ *
+ * The loop along which a pass vectorizes (p for stride 1, q otherwise) reads contiguously, but the R outputs of each
+ * butterfly go to places R or stride apart, which GCC either can't vectorize or can't prove don't overlap.  So the
+ * vectorized paths run the butterflies a chunk at a time into rows of t, contiguous in the loop variable, then write
+ * the rows out: as an R x chunk transpose for stride 1, or as R contiguous copies otherwise.  Below
+ * PASS_VECTOR_MIN_LEN the extra copy and the short loops cost more than vectorizing saves, and the scalar loop is used.
+ */
+static const size_t PASS_CHUNK = 64;
+static const size_t PASS_VECTOR_MIN_LEN = 16;
+
+/*
+ * Every pass shape, one butterfly at a time.
+ */
+template <unsigned int R, void (*BUTTERFLY)(float *, float *)>
+static void stockhamPassScalar(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                               const float *tw_im, size_t stride, size_t m) {
+  for (size_t p = 0; p < m; p++) {
+    float wr[R], wi[R];
+    for (size_t j = 1; j < R; j++) {
+      wr[j] = tw_re[(j - 1) * m + p];
+      wi[j] = tw_im[(j - 1) * m + p];
+    }
+
+    const float *xr = x_re + stride * p, *xi = x_im + stride * p;
+    float *yr = y_re + stride * R * p, *yi = y_im + stride * R * p;
+
+    for (size_t q = 0; q < stride; q++) {
+      float br[R], bi[R];
+      for (size_t k = 0; k < R; k++) {
+        br[k] = xr[q + stride * k * m];
+        bi[k] = xi[q + stride * k * m];
+      }
+      BUTTERFLY(br, bi);
+      yr[q] = br[0];
+      yi[q] = bi[0];
+      for (size_t j = 1; j < R; j++) {
+        yr[q + stride * j] = br[j] * wr[j] - bi[j] * wi[j];
+        yi[q + stride * j] = br[j] * wi[j] + bi[j] * wr[j];
+      }
+    }
+  }
+}
+
+/*
+ * Stride 1, vectorized over p.  The twiddles vary with p, so they're loaded alongside the inputs.
+ */
+template <unsigned int R, void (*BUTTERFLY)(float *, float *)>
+static void stockhamPassStride1(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                                const float *tw_im, size_t m) {
+  for (size_t p0 = 0; p0 < m; p0 += PASS_CHUNK) {
+    size_t chunk = m - p0 < PASS_CHUNK ? m - p0 : PASS_CHUNK;
+    float t_re[R][PASS_CHUNK], t_im[R][PASS_CHUNK];
+
+    for (size_t p = 0; p < chunk; p++) {
+      float br[R], bi[R];
+      for (size_t k = 0; k < R; k++) {
+        br[k] = x_re[p0 + p + k * m];
+        bi[k] = x_im[p0 + p + k * m];
+      }
+      BUTTERFLY(br, bi);
+      t_re[0][p] = br[0];
+      t_im[0][p] = bi[0];
+      for (size_t j = 1; j < R; j++) {
+        float wr = tw_re[(j - 1) * m + p0 + p], wi = tw_im[(j - 1) * m + p0 + p];
+        t_re[j][p] = br[j] * wr - bi[j] * wi;
+        t_im[j][p] = br[j] * wi + bi[j] * wr;
+      }
+    }
+
+    float *yr = y_re + R * p0, *yi = y_im + R * p0;
+    for (size_t p = 0; p < chunk; p++) {
+      for (size_t j = 0; j < R; j++) {
+        yr[R * p + j] = t_re[j][p];
+        yi[R * p + j] = t_im[j][p];
+      }
+    }
+  }
+}
+
+/*
+ * Larger strides, vectorized over q with the twiddles for each p broadcast.
+ */
+template <unsigned int R, void (*BUTTERFLY)(float *, float *)>
+static void stockhamPassStrided(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                                const float *tw_im, size_t stride, size_t m) {
+  for (size_t p = 0; p < m; p++) {
+    float wr[R], wi[R];
+    for (size_t j = 1; j < R; j++) {
+      wr[j] = tw_re[(j - 1) * m + p];
+      wi[j] = tw_im[(j - 1) * m + p];
+    }
+
+    const float *xr = x_re + stride * p, *xi = x_im + stride * p;
+    float *yr = y_re + stride * R * p, *yi = y_im + stride * R * p;
+
+    for (size_t q0 = 0; q0 < stride; q0 += PASS_CHUNK) {
+      size_t chunk = stride - q0 < PASS_CHUNK ? stride - q0 : PASS_CHUNK;
+      float t_re[R][PASS_CHUNK], t_im[R][PASS_CHUNK];
+
+      for (size_t q = 0; q < chunk; q++) {
+        float br[R], bi[R];
+        for (size_t k = 0; k < R; k++) {
+          br[k] = xr[q0 + q + stride * k * m];
+          bi[k] = xi[q0 + q + stride * k * m];
+        }
+        BUTTERFLY(br, bi);
+        t_re[0][q] = br[0];
+        t_im[0][q] = bi[0];
+        for (size_t j = 1; j < R; j++) {
+          t_re[j][q] = br[j] * wr[j] - bi[j] * wi[j];
+          t_im[j][q] = br[j] * wi[j] + bi[j] * wr[j];
+        }
+      }
+
+      for (size_t j = 0; j < R; j++) {
+        for (size_t q = 0; q < chunk; q++) {
+          yr[stride * j + q0 + q] = t_re[j][q];
+          yi[stride * j + q0 + q] = t_im[j][q];
+        }
+      }
+    }
+  }
+}
+
+template <unsigned int R, void (*BUTTERFLY)(float *, float *)>
+static inline void stockhamPass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                                const float *tw_im, size_t stride, size_t m) {
+  if (stride == 1 && m >= PASS_VECTOR_MIN_LEN) {
+    stockhamPassStride1<R, BUTTERFLY>(x_re, x_im, y_re, y_im, tw_re, tw_im, m);
+  } else if (stride >= PASS_VECTOR_MIN_LEN) {
+    stockhamPassStrided<R, BUTTERFLY>(x_re, x_im, y_re, y_im, tw_re, tw_im, stride, m);
+  } else {
+    stockhamPassScalar<R, BUTTERFLY>(x_re, x_im, y_re, y_im, tw_re, tw_im, stride, m);
+  }
+}
+
+void fftRadix2Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m) {
+  stockhamPass<2, butterfly2>(x_re, x_im, y_re, y_im, tw_re, tw_im, stride, m);
+}
+
+void fftRadix3Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m) {
+  stockhamPass<3, butterfly3>(x_re, x_im, y_re, y_im, tw_re, tw_im, stride, m);
+}
+
+void fftRadix4Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m) {
+  stockhamPass<4, butterfly4>(x_re, x_im, y_re, y_im, tw_re, tw_im, stride, m);
+}
+
+void fftRadix5Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m) {
+  stockhamPass<5, butterfly5>(x_re, x_im, y_re, y_im, tw_re, tw_im, stride, m);
+}
+
+void fftRadix8Pass(const float *x_re, const float *x_im, float *y_re, float *y_im, const float *tw_re,
+                   const float *tw_im, unsigned int stride, unsigned int m) {
+  stockhamPass<8, butterfly8>(x_re, x_im, y_re, y_im, tw_re, tw_im, stride, m);
+}
+
+void fftSplitEvenOdd(const float *input, float *even, float *odd, unsigned int n) {
+  for (unsigned int i = 0; i < n; i++) {
+    even[i] = input[2 * i];
+    odd[i] = input[2 * i + 1];
+  }
+}
+
+void fftMergeEvenOdd(const float *even, const float *odd, float *output, unsigned int n) {
+  for (unsigned int i = 0; i < n; i++) {
+    output[2 * i] = even[i];
+    output[2 * i + 1] = odd[i];
+  }
+}
+
+/*
+ * out[c * rows + r] = in[r * cols + c], for both halves of a split complex matrix.  Goes in square tiles so that both
+ * sides stay in cache.
+ */
+void fftTranspose(const float *in_re, const float *in_im, float *out_re, float *out_im, unsigned int rows,
+                  unsigned int cols) {
+  const unsigned int TILE = 16;
+
+  for (unsigned int r0 = 0; r0 < rows; r0 += TILE) {
+    unsigned int r_end = r0 + TILE < rows ? r0 + TILE : rows;
+    for (unsigned int c0 = 0; c0 < cols; c0 += TILE) {
+      unsigned int c_end = c0 + TILE < cols ? c0 + TILE : cols;
+      for (unsigned int r = r0; r < r_end; r++) {
+        for (unsigned int c = c0; c < c_end; c++) {
+          out_re[c * rows + r] = in_re[r * cols + c];
+          out_im[c * rows + r] = in_im[r * cols + c];
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Turn the n-point complex FFT of a real sequence packed as z[j] = x[2j] + i x[2j + 1] into bins 0..n inclusive of the
+ * 2n-point real FFT of x.  w holds exp(-2 pi i k / 2n) for k in 0..n.
+ */
+void realFftPostprocess(const float *z_re, const float *z_im, float *x_re, float *x_im, const float *w_re,
+                        const float *w_im, unsigned int n) {
+  x_re[0] = z_re[0] + z_im[0];
+  x_im[0] = 0.0f;
+  x_re[n] = z_re[0] - z_im[0];
+  x_im[n] = 0.0f;
+
+  for (unsigned int k = 1; k < n; k++) {
+    float a = z_re[k], b = z_im[k];
+    float c = z_re[n - k], d = z_im[n - k];
+    float er = 0.5f * (a + c), ei = 0.5f * (b - d);
+    float or_ = 0.5f * (b + d), oi = -0.5f * (a - c);
+    x_re[k] = er + w_re[k] * or_ - w_im[k] * oi;
+    x_im[k] = ei + w_re[k] * oi + w_im[k] * or_;
+  }
+}
+
+/*
+ * The inverse of realFftPostprocess, except that the output is scaled by 2 so that running the (unnormalized) inverse
+ * complex FFT on it gives the real sequence scaled by 2n, the same as an unnormalized real inverse FFT would.
+ */
+void realFftPreprocess(const float *x_re, const float *x_im, float *z_re, float *z_im, const float *w_re,
+                       const float *w_im, unsigned int n) {
+  for (unsigned int k = 0; k < n; k++) {
+    float a = x_re[k], b = x_im[k];
+    float c = x_re[n - k], d = x_im[n - k];
+    // E = X[k] + conj(X[n - k]), D = X[k] - conj(X[n - k]).
+    float er = a + c, ei = b - d;
+    float dr = a - c, di = b + d;
+    // O = D * conj(w), Z = E + i O.
+    float or_ = dr * w_re[k] + di * w_im[k];
+    float oi = di * w_re[k] - dr * w_im[k];
+    z_re[k] = er - oi;
+    z_im[k] = ei + or_;
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
@@ -0,0 +1,123 @@
+#include "dispatched/dispatched_functions.hpp"
+
+#include <stddef.h>
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * Lanes advanced together.  Their coefficients and state live in local arrays for the whole block, which the compiler
+ * keeps in registers (or at worst L1), and the loop over a group's lanes is what vectorizes.
+ */
+static const unsigned int LANE_GROUP = 16;
+
+/*
+ * Run one section over the block for one group of lanes.  COUNT is the number of lanes if not 0; otherwise it's
+ * runtime_count, for the last, partial group.
+ *
+ * When interpolating, frame i uses coefficients + (i + 1) * deltas, so the last frame is at the target.
+ */
+template <unsigned int COUNT, bool INTERPOLATE>
+static void runSectionGroup(const float *src, float *dest, unsigned int frames, unsigned int lanes,
+                            unsigned int runtime_count, float *coefficients, const float *deltas, float *state,
+                            unsigned int lane_stride) {
+  const unsigned int count = COUNT != 0 ? COUNT : runtime_count;
+  float c[5][LANE_GROUP], d[5][LANE_GROUP], z1[LANE_GROUP], z2[LANE_GROUP];
+
+  // Pointer arithmetic in size_t throughout: with unsigned int indices the compiler has to allow for wraparound, and
+  // GCC responds by vectorizing across frames with gathers.
+  for (unsigned int k = 0; k < 5; k++) {
+    const float *c_row = coefficients + (size_t)k * lane_stride;
+    for (unsigned int l = 0; l < count; l++) {
+      c[k][l] = c_row[l];
+    }
+    if (INTERPOLATE) {
+      const float *d_row = deltas + (size_t)k * lane_stride;
+      for (unsigned int l = 0; l < count; l++) {
+        d[k][l] = d_row[l];
+      }
+    }
+  }
+  float *z1_row = state, *z2_row = state + lane_stride;
+  for (unsigned int l = 0; l < count; l++) {
+    z1[l] = z1_row[l];
+    z2[l] = z2_row[l];
+  }
+
+  for (size_t frame = 0; frame < frames; frame++) {
+    // Copied in first: src and dest are often the same buffer, and this way the compiler needn't care.
+    const float *x_frame = src + frame * lanes;
+    float *y_frame = dest + frame * lanes;
+    float x[LANE_GROUP];
+    for (unsigned int l = 0; l < count; l++) {
+      x[l] = x_frame[l];
+    }
+
+    float y[LANE_GROUP];
+    for (unsigned int l = 0; l < count; l++) {
+      if (INTERPOLATE) {
+        for (unsigned int k = 0; k < 5; k++) {
+          c[k][l] += d[k][l];
+        }
+      }
+      // Grouped so that only one multiply-add separates y from the next frame's y, which is the whole critical
+      // path: everything involving x can start before y is known.
+      y[l] = c[0][l] * x[l] + z1[l];
+      z1[l] = (c[1][l] * x[l] + z2[l]) - c[3][l] * y[l];
+      z2[l] = c[2][l] * x[l] - c[4][l] * y[l];
+    }
+
+    for (unsigned int l = 0; l < count; l++) {
+      y_frame[l] = y[l];
+    }
+  }
+
+  if (INTERPOLATE) {
+    for (unsigned int k = 0; k < 5; k++) {
+      float *c_row = coefficients + (size_t)k * lane_stride;
+      for (unsigned int l = 0; l < count; l++) {
+        c_row[l] = c[k][l];
+      }
+    }
+  }
+  for (unsigned int l = 0; l < count; l++) {
+    z1_row[l] = z1[l];
+    z2_row[l] = z2[l];
+  }
+}
+
+template <bool INTERPOLATE>
+static void runBank(const float *input, float *output, unsigned int frames, unsigned int lanes, unsigned int sections,
+                    float *coefficients, const float *deltas, float *state, unsigned int lane_stride) {
+  for (unsigned int s = 0; s < sections; s++) {
+    // Every section after the first works in place on the output.
+    const float *src = s == 0 ? input : output;
+    float *sec_coefficients = coefficients + (size_t)s * 5 * lane_stride;
+    const float *sec_deltas = INTERPOLATE ? deltas + (size_t)s * 5 * lane_stride : nullptr;
+    float *sec_state = state + (size_t)s * 2 * lane_stride;
+
+    unsigned int lane = 0;
+    for (; lane + LANE_GROUP <= lanes; lane += LANE_GROUP) {
+      runSectionGroup<LANE_GROUP, INTERPOLATE>(src + lane, output + lane, frames, lanes, LANE_GROUP,
+                                               sec_coefficients + lane, INTERPOLATE ? sec_deltas + lane : nullptr,
+                                               sec_state + lane, lane_stride);
+    }
+    if (lane < lanes) {
+      runSectionGroup<0, INTERPOLATE>(src + lane, output + lane, frames, lanes, lanes - lane, sec_coefficients + lane,
+                                      INTERPOLATE ? sec_deltas + lane : nullptr, sec_state + lane, lane_stride);
+    }
+  }
+}
+
+void biquadFilterBank(const float *input, float *output, unsigned int frames, unsigned int lanes,
+                      unsigned int sections, float *coefficients, const float *deltas, float *state,
+                      unsigned int lane_stride) {
+  if (deltas != nullptr) {
+    runBank<true>(input, output, frames, lanes, sections, coefficients, deltas, state, lane_stride);
+  } else {
+    runBank<false>(input, output, frames, lanes, sections, coefficients, deltas, state, lane_stride);
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
@@ -0,0 +1,301 @@
+#include "dispatched/dispatched_functions.hpp"
+
+#include <stddef.h>
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * Indices are size_t throughout: with 32-bit indices GCC can't prove that consecutive frames are contiguous, and either
+ * doesn't vectorize or gathers.
+ */
+
+template <bool ADD> static void writeSample(float *destination, float value) {
+  if (ADD) {
+    *destination += value;
+  } else {
+    *destination = value;
+  }
+}
+
+/*
+ * The position of frame i in a ramp, as a float.  Through int because there's no vector conversion from 64-bit
+ * integers below AVX-512.
+ */
+static float getRampPosition(size_t i) { return (float)(int)(i + 1); }
+
+template <bool ADD> static void mixConstantGain(const float *input, float *output, size_t samples, float gain) {
+  for (size_t i = 0; i < samples; i++) {
+    writeSample<ADD>(output + i, input[i] * gain);
+  }
+}
+
+template <unsigned int CHANNELS, bool ADD>
+static void mixGainRampFixed(const float *input, float *output, size_t frames, float gain_start, float delta) {
+  for (size_t i = 0; i < frames; i++) {
+    float gain = gain_start + delta * getRampPosition(i);
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+      writeSample<ADD>(output + i * CHANNELS + ch, input[i * CHANNELS + ch] * gain);
+    }
+  }
+}
+
+/*
+ * Channels go in fixed groups of 4 with a tail, since a loop of a handful of iterations with a runtime count costs more
+ * in overhead than in work.
+ */
+template <bool ADD>
+static void mixGainRampRuntime(const float *input, float *output, size_t frames, size_t channels, float gain_start,
+                               float delta) {
+  for (size_t i = 0; i < frames; i++) {
+    float gain = gain_start + delta * getRampPosition(i);
+    const float *x = input + i * channels;
+    float *y = output + i * channels;
+    size_t ch = 0;
+    for (; ch + 4 <= channels; ch += 4) {
+      for (size_t j = 0; j < 4; j++) {
+        writeSample<ADD>(y + ch + j, x[ch + j] * gain);
+      }
+    }
+    for (; ch < channels; ch++) {
+      writeSample<ADD>(y + ch, x[ch] * gain);
+    }
+  }
+}
+
+template <bool ADD>
+static void mixGainRampImpl(const float *input, float *output, size_t frames, unsigned int channels, float gain_start,
+                            float gain_end) {
+  if (gain_start == gain_end) {
+    mixConstantGain<ADD>(input, output, frames * channels, gain_start);
+    return;
+  }
+
+  float delta = (gain_end - gain_start) / (float)frames;
+  switch (channels) {
+  case 1:
+    return mixGainRampFixed<1, ADD>(input, output, frames, gain_start, delta);
+  case 2:
+    return mixGainRampFixed<2, ADD>(input, output, frames, gain_start, delta);
+  case 4:
+    return mixGainRampFixed<4, ADD>(input, output, frames, gain_start, delta);
+  case 8:
+    return mixGainRampFixed<8, ADD>(input, output, frames, gain_start, delta);
+  default:
+    return mixGainRampRuntime<ADD>(input, output, frames, channels, gain_start, delta);
+  }
+}
+
+void mixGainRamp(const float *input, float *output, unsigned int frames, unsigned int channels, float gain_start,
+                 float gain_end, bool add) {
+  if (add) {
+    mixGainRampImpl<true>(input, output, frames, channels, gain_start, gain_end);
+  } else {
+    mixGainRampImpl<false>(input, output, frames, channels, gain_start, gain_end);
+  }
+}
+
+/*
+ * The matrix is copied into locals so that the compiler knows it doesn't alias the output, and keeps it in registers
+ * for the small shapes.
+ */
+template <unsigned int IN, unsigned int OUT, bool RAMP, bool ADD>
+static void mixMatrixFixed(const float *input, float *output, size_t frames, const float *from_matrix,
+                           const float *to_matrix) {
+  float matrix[OUT * IN], delta[OUT * IN];
+  for (size_t k = 0; k < OUT * IN; k++) {
+    matrix[k] = from_matrix[k];
+    delta[k] = RAMP ? (to_matrix[k] - from_matrix[k]) / (float)frames : 0.0f;
+  }
+
+  for (size_t i = 0; i < frames; i++) {
+    const float *x = input + i * IN;
+    float *y = output + i * OUT;
+    float position = getRampPosition(i);
+
+    for (size_t o = 0; o < OUT; o++) {
+      float sum = 0.0f;
+      for (size_t c = 0; c < IN; c++) {
+        float coefficient = RAMP ? matrix[o * IN + c] + delta[o * IN + c] * position : matrix[o * IN + c];
+        sum += x[c] * coefficient;
+      }
+      writeSample<ADD>(y + o, sum);
+    }
+  }
+}
+
+template <bool RAMP, bool ADD>
+static void mixMatrixRuntime(const float *input, size_t input_channels, float *output, size_t output_channels,
+                             size_t frames, const float *from_matrix, const float *to_matrix) {
+  float inv_frames = 1.0f / (float)frames;
+
+  for (size_t i = 0; i < frames; i++) {
+    const float *x = input + i * input_channels;
+    float *y = output + i * output_channels;
+    float t = getRampPosition(i) * inv_frames;
+
+    for (size_t o = 0; o < output_channels; o++) {
+      const float *from = from_matrix + o * input_channels;
+      const float *to = RAMP ? to_matrix + o * input_channels : from;
+      float sum = 0.0f;
+      for (size_t c = 0; c < input_channels; c++) {
+        float coefficient = RAMP ? from[c] + (to[c] - from[c]) * t : from[c];
+        sum += x[c] * coefficient;
+      }
+      writeSample<ADD>(y + o, sum);
+    }
+  }
+}
+
+/*
+ * A fixed input count with any output count, e.g. upmixing stereo to 5.1: the input frame stays in registers and each
+ * output is an unrolled dot product.
+ */
+template <unsigned int IN, bool RAMP, bool ADD>
+static void mixMatrixFixedInput(const float *input, float *output, size_t output_channels, size_t frames,
+                                const float *from_matrix, const float *to_matrix) {
+  float inv_frames = 1.0f / (float)frames;
+
+  for (size_t i = 0; i < frames; i++) {
+    float x[IN];
+    for (size_t c = 0; c < IN; c++) {
+      x[c] = input[i * IN + c];
+    }
+    float *y = output + i * output_channels;
+    float t = getRampPosition(i) * inv_frames;
+
+    for (size_t o = 0; o < output_channels; o++) {
+      const float *from = from_matrix + o * IN;
+      const float *to = RAMP ? to_matrix + o * IN : from;
+      float sum = 0.0f;
+      for (size_t c = 0; c < IN; c++) {
+        float coefficient = RAMP ? from[c] + (to[c] - from[c]) * t : from[c];
+        sum += x[c] * coefficient;
+      }
+      writeSample<ADD>(y + o, sum);
+    }
+  }
+}
+
+template <unsigned int IN, bool RAMP, bool ADD>
+static void mixMatrixForInput(const float *input, float *output, unsigned int output_channels, size_t frames,
+                              const float *from_matrix, const float *to_matrix) {
+  switch (output_channels) {
+  case 1:
+    return mixMatrixFixed<IN, 1, RAMP, ADD>(input, output, frames, from_matrix, to_matrix);
+  case 2:
+    return mixMatrixFixed<IN, 2, RAMP, ADD>(input, output, frames, from_matrix, to_matrix);
+  case 4:
+    return mixMatrixFixed<IN, 4, RAMP, ADD>(input, output, frames, from_matrix, to_matrix);
+  case 8:
+    return mixMatrixFixed<IN, 8, RAMP, ADD>(input, output, frames, from_matrix, to_matrix);
+  default:
+    return mixMatrixFixedInput<IN, RAMP, ADD>(input, output, output_channels, frames, from_matrix, to_matrix);
+  }
+}
+
+template <bool RAMP, bool ADD>
+static void mixMatrixImpl(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+                          size_t frames, const float *from_matrix, const float *to_matrix) {
+  switch (input_channels) {
+  case 1:
+    return mixMatrixForInput<1, RAMP, ADD>(input, output, output_channels, frames, from_matrix, to_matrix);
+  case 2:
+    return mixMatrixForInput<2, RAMP, ADD>(input, output, output_channels, frames, from_matrix, to_matrix);
+  case 4:
+    return mixMatrixForInput<4, RAMP, ADD>(input, output, output_channels, frames, from_matrix, to_matrix);
+  case 8:
+    return mixMatrixForInput<8, RAMP, ADD>(input, output, output_channels, frames, from_matrix, to_matrix);
+  default:
+    return mixMatrixRuntime<RAMP, ADD>(input, input_channels, output, output_channels, frames, from_matrix,
+                                       to_matrix);
+  }
+}
+
+/*
+ * to_matrix is nullptr for a constant matrix.
+ */
+void mixMatrix(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+               unsigned int frames, const float *from_matrix, const float *to_matrix, bool add) {
+  if (to_matrix != nullptr && add) {
+    mixMatrixImpl<true, true>(input, input_channels, output, output_channels, frames, from_matrix, to_matrix);
+  } else if (to_matrix != nullptr) {
+    mixMatrixImpl<true, false>(input, input_channels, output, output_channels, frames, from_matrix, to_matrix);
+  } else if (add) {
+    mixMatrixImpl<false, true>(input, input_channels, output, output_channels, frames, from_matrix, to_matrix);
+  } else {
+    mixMatrixImpl<false, false>(input, input_channels, output, output_channels, frames, from_matrix, to_matrix);
+  }
+}
+
+template <unsigned int CHANNELS>
+static void interleaveFixed(const float *const *planar, size_t frames, float *output) {
+  const float *sources[CHANNELS];
+  for (size_t ch = 0; ch < CHANNELS; ch++) {
+    sources[ch] = planar[ch];
+  }
+
+  for (size_t i = 0; i < frames; i++) {
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+      output[i * CHANNELS + ch] = sources[ch][i];
+    }
+  }
+}
+
+template <unsigned int CHANNELS>
+static void deinterleaveFixed(const float *input, size_t frames, float *const *planar) {
+  float *destinations[CHANNELS];
+  for (size_t ch = 0; ch < CHANNELS; ch++) {
+    destinations[ch] = planar[ch];
+  }
+
+  for (size_t i = 0; i < frames; i++) {
+    for (size_t ch = 0; ch < CHANNELS; ch++) {
+      destinations[ch][i] = input[i * CHANNELS + ch];
+    }
+  }
+}
+
+void interleaveChannels(const float *const *planar, unsigned int channels, unsigned int frames, float *output) {
+  switch (channels) {
+  case 1:
+    return interleaveFixed<1>(planar, frames, output);
+  case 2:
+    return interleaveFixed<2>(planar, frames, output);
+  case 4:
+    return interleaveFixed<4>(planar, frames, output);
+  case 8:
+    return interleaveFixed<8>(planar, frames, output);
+  default:
+    // One channel at a time: strided stores, but each source is read once, in order.
+    for (size_t ch = 0; ch < channels; ch++) {
+      const float *source = planar[ch];
+      for (size_t i = 0; i < frames; i++) {
+        output[i * channels + ch] = source[i];
+      }
+    }
+  }
+}
+
+void deinterleaveChannels(const float *input, unsigned int channels, unsigned int frames, float *const *planar) {
+  switch (channels) {
+  case 1:
+    return deinterleaveFixed<1>(input, frames, planar);
+  case 2:
+    return deinterleaveFixed<2>(input, frames, planar);
+  case 4:
+    return deinterleaveFixed<4>(input, frames, planar);
+  case 8:
+    return deinterleaveFixed<8>(input, frames, planar);
+  default:
+    for (size_t ch = 0; ch < channels; ch++) {
+      float *destination = planar[ch];
+      for (size_t i = 0; i < frames; i++) {
+        destination[i] = input[i * channels + ch];
+      }
+    }
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
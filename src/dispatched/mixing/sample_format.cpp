@@ -0,0 +1,357 @@
+#include "dispatched/dispatched_functions.hpp"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * Integers are produced and consumed as int32 scaled to the format's full scale, so that every format shares the
+ * rounding and clamping and only the loads and stores differ.  Rounding is half away from zero, by hand: the only
+ * conversion which vectorizes everywhere truncates.
+ */
+
+/*
+ * Samples converted per chunk: dither noise for a chunk is generated into a buffer on the stack, then consumed by the
+ * conversion loop while it is still in L1.
+ */
+static const size_t CONVERSION_CHUNK = 256;
+
+template <SampleFormat FORMAT> struct FormatTraits;
+
+/*
+ * LIMIT is the float magnitude samples are clamped to before rounding, and HIGH the integer the positive side is then
+ * clamped to, since +LIMIT itself rounds one past it.
+ *
+ * STAGED formats go through an int32 buffer a chunk at a time when interleaving, so that packing and unpacking is a
+ * contiguous loop of its own: GCC vectorizes 3-byte samples with a stride of a whole frame poorly, and not at all when
+ * there is also a float conversion in the loop.
+ */
+template <> struct FormatTraits<SampleFormat::INT16> {
+  static constexpr float SCALE = 32768.0f, LIMIT = 32768.0f;
+  static constexpr int32_t HIGH = 32767;
+  static constexpr bool STAGED = false;
+
+  static void store(void *output, size_t index, int32_t value) { ((int16_t *)output)[index] = (int16_t)value; }
+  static int32_t load(const void *input, size_t index) { return ((const int16_t *)input)[index]; }
+};
+
+template <> struct FormatTraits<SampleFormat::INT24_PACKED> {
+  static constexpr float SCALE = 8388608.0f, LIMIT = 8388608.0f;
+  static constexpr int32_t HIGH = 8388607;
+  static constexpr bool STAGED = true;
+
+  static void store(void *output, size_t index, int32_t value) {
+    unsigned char *bytes = (unsigned char *)output + index * 3;
+    bytes[0] = (unsigned char)value;
+    bytes[1] = (unsigned char)(value >> 8);
+    bytes[2] = (unsigned char)(value >> 16);
+  }
+
+  static int32_t load(const void *input, size_t index) {
+    const unsigned char *bytes = (const unsigned char *)input + index * 3;
+    // Assemble in the top 3 bytes and shift back down to sign-extend.
+    uint32_t raw = ((uint32_t)bytes[0] << 8) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 24);
+    return (int32_t)raw >> 8;
+  }
+};
+
+template <> struct FormatTraits<SampleFormat::INT32> {
+  // The largest float below 2^31, since 2^31 itself would overflow the conversion.
+  static constexpr float SCALE = 2147483648.0f, LIMIT = 2147483520.0f;
+  static constexpr int32_t HIGH = 2147483647;
+  static constexpr bool STAGED = false;
+
+  static void store(void *output, size_t index, int32_t value) { ((int32_t *)output)[index] = value; }
+  static int32_t load(const void *input, size_t index) { return ((const int32_t *)input)[index]; }
+};
+
+static uint32_t getFloatBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static float getBitsFloat(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/*
+ * The magnitude is clamped as an integer: the bits of non-negative floats order the same way as the floats, so this
+ * is an integer min rather than the compares and blends GCC makes of a float clamp, which doubled the cost of the
+ * whole conversion.  NaN's bits are above infinity's, so it clamps to full scale rather than reaching the conversion.
+ */
+template <SampleFormat FORMAT> static int32_t quantize(float value) {
+  using Traits = FormatTraits<FORMAT>;
+  uint32_t bits = getFloatBits(value), limit = getFloatBits(Traits::LIMIT);
+  uint32_t magnitude = bits & 0x7fffffffu;
+  magnitude = magnitude < limit ? magnitude : limit;
+  value = getBitsFloat(magnitude | (bits & 0x80000000u));
+
+  int32_t rounded = (int32_t)(value + copysignf(0.5f, value));
+  return rounded < Traits::HIGH ? rounded : Traits::HIGH;
+}
+
+/*
+ * Fill noise with count (rounded up to a whole number of lanes) samples of TPDF noise in LSBs, advancing the state.
+ *
+ * Each lane is a xorshift32.  Written as one stream in which every output is the successor of the one
+ * SAMPLE_DITHER_LANES before it, the dependency distance is at least the vector width on every machine and the
+ * recurrence vectorizes; with the lanes held in an array and advanced together, GCC keeps them in scalar registers.
+ */
+static void generateTpdfNoise(uint32_t *state, float *noise, size_t count) {
+  uint32_t raw[SAMPLE_DITHER_LANES + CONVERSION_CHUNK];
+  size_t rounded = (count + SAMPLE_DITHER_LANES - 1) / SAMPLE_DITHER_LANES * SAMPLE_DITHER_LANES;
+
+  for (size_t j = 0; j < SAMPLE_DITHER_LANES; j++) {
+    raw[j] = state[j];
+  }
+  for (size_t i = SAMPLE_DITHER_LANES; i < SAMPLE_DITHER_LANES + rounded; i++) {
+    uint32_t x = raw[i - SAMPLE_DITHER_LANES];
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    raw[i] = x;
+  }
+  for (size_t j = 0; j < SAMPLE_DITHER_LANES; j++) {
+    state[j] = raw[rounded + j];
+  }
+
+  for (size_t i = 0; i < rounded; i++) {
+    uint32_t x = raw[SAMPLE_DITHER_LANES + i];
+    // The sum of two uniform 16-bit halves, centered: triangular on (-1, 1).
+    int32_t sum = (int32_t)(x & 0xffff) + (int32_t)(x >> 16) - 65535;
+    noise[i] = (float)sum * (1.0f / 65536.0f);
+  }
+}
+
+template <SampleFormat FORMAT, unsigned int CHANNELS, bool DITHER>
+static void encodeFixed(const float *const *planar, size_t frames, void *output, uint32_t *dither) {
+  using Traits = FormatTraits<FORMAT>;
+  const float *sources[CHANNELS];
+  for (size_t ch = 0; ch < CHANNELS; ch++) {
+    sources[ch] = planar[ch];
+  }
+
+  float noise[CONVERSION_CHUNK];
+  int32_t staged[CONVERSION_CHUNK];
+  const size_t chunk_frames = CONVERSION_CHUNK / CHANNELS;
+  for (size_t start = 0; start < frames; start += chunk_frames) {
+    size_t count = frames - start < chunk_frames ? frames - start : chunk_frames;
+    if (DITHER) {
+      generateTpdfNoise(dither, noise, count * CHANNELS);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+      for (size_t ch = 0; ch < CHANNELS; ch++) {
+        float value = sources[ch][start + i] * Traits::SCALE;
+        if (DITHER) {
+          value += noise[i * CHANNELS + ch];
+        }
+        if (Traits::STAGED) {
+          staged[i * CHANNELS + ch] = quantize<FORMAT>(value);
+        } else {
+          Traits::store(output, (start + i) * CHANNELS + ch, quantize<FORMAT>(value));
+        }
+      }
+    }
+
+    if (Traits::STAGED) {
+      for (size_t i = 0; i < count * CHANNELS; i++) {
+        Traits::store(output, start * CHANNELS + i, staged[i]);
+      }
+    }
+  }
+}
+
+/*
+ * Other channel counts go one channel at a time, as interleaveChannels does: strided stores, but each source is read
+ * once, in order.  Staged formats do the same a chunk of frames at a time into the staging buffer, if a frame fits.
+ */
+template <SampleFormat FORMAT, bool DITHER>
+static void encodeRuntime(const float *const *planar, size_t channels, size_t frames, void *output,
+                          uint32_t *dither) {
+  using Traits = FormatTraits<FORMAT>;
+  float noise[CONVERSION_CHUNK];
+
+  if (Traits::STAGED && channels <= CONVERSION_CHUNK) {
+    int32_t staged[CONVERSION_CHUNK];
+    const size_t chunk_frames = CONVERSION_CHUNK / channels;
+    for (size_t start = 0; start < frames; start += chunk_frames) {
+      size_t count = frames - start < chunk_frames ? frames - start : chunk_frames;
+      if (DITHER) {
+        generateTpdfNoise(dither, noise, count * channels);
+      }
+
+      for (size_t ch = 0; ch < channels; ch++) {
+        const float *source = planar[ch] + start;
+        for (size_t i = 0; i < count; i++) {
+          float value = source[i] * Traits::SCALE;
+          if (DITHER) {
+            value += noise[i * channels + ch];
+          }
+          staged[i * channels + ch] = quantize<FORMAT>(value);
+        }
+      }
+
+      for (size_t i = 0; i < count * channels; i++) {
+        Traits::store(output, start * channels + i, staged[i]);
+      }
+    }
+    return;
+  }
+
+  for (size_t ch = 0; ch < channels; ch++) {
+    const float *source = planar[ch];
+    for (size_t start = 0; start < frames; start += CONVERSION_CHUNK) {
+      size_t count = frames - start < CONVERSION_CHUNK ? frames - start : CONVERSION_CHUNK;
+      if (DITHER) {
+        generateTpdfNoise(dither, noise, count);
+      }
+
+      for (size_t i = 0; i < count; i++) {
+        float value = source[start + i] * Traits::SCALE;
+        if (DITHER) {
+          value += noise[i];
+        }
+        Traits::store(output, (start + i) * channels + ch, quantize<FORMAT>(value));
+      }
+    }
+  }
+}
+
+template <SampleFormat FORMAT, bool DITHER>
+static void encodeImpl(const float *const *planar, unsigned int channels, size_t frames, void *output,
+                       uint32_t *dither) {
+  switch (channels) {
+  case 1:
+    return encodeFixed<FORMAT, 1, DITHER>(planar, frames, output, dither);
+  case 2:
+    return encodeFixed<FORMAT, 2, DITHER>(planar, frames, output, dither);
+  case 4:
+    return encodeFixed<FORMAT, 4, DITHER>(planar, frames, output, dither);
+  case 8:
+    return encodeFixed<FORMAT, 8, DITHER>(planar, frames, output, dither);
+  default:
+    return encodeRuntime<FORMAT, DITHER>(planar, channels, frames, output, dither);
+  }
+}
+
+template <SampleFormat FORMAT>
+static void encodeFormat(const float *const *planar, unsigned int channels, size_t frames, void *output,
+                         uint32_t *dither) {
+  // INT32 has more precision than float, so there's nothing to dither.
+  if (dither != nullptr && FORMAT != SampleFormat::INT32) {
+    encodeImpl<FORMAT, true>(planar, channels, frames, output, dither);
+  } else {
+    encodeImpl<FORMAT, false>(planar, channels, frames, output, nullptr);
+  }
+}
+
+void encodeSamples(const float *const *planar, unsigned int channels, unsigned int frames, SampleFormat format,
+                   void *output, uint32_t *dither) {
+  switch (format) {
+  case SampleFormat::INT16:
+    return encodeFormat<SampleFormat::INT16>(planar, channels, frames, output, dither);
+  case SampleFormat::INT24_PACKED:
+    return encodeFormat<SampleFormat::INT24_PACKED>(planar, channels, frames, output, dither);
+  case SampleFormat::INT32:
+    return encodeFormat<SampleFormat::INT32>(planar, channels, frames, output, dither);
+  }
+}
+
+template <SampleFormat FORMAT, unsigned int CHANNELS>
+static void decodeFixed(const void *input, size_t frames, float *const *planar) {
+  using Traits = FormatTraits<FORMAT>;
+  float *destinations[CHANNELS];
+  for (size_t ch = 0; ch < CHANNELS; ch++) {
+    destinations[ch] = planar[ch];
+  }
+
+  if (!Traits::STAGED) {
+    for (size_t i = 0; i < frames; i++) {
+      for (size_t ch = 0; ch < CHANNELS; ch++) {
+        destinations[ch][i] = (float)Traits::load(input, i * CHANNELS + ch) * (1.0f / Traits::SCALE);
+      }
+    }
+    return;
+  }
+
+  int32_t staged[CONVERSION_CHUNK];
+  const size_t chunk_frames = CONVERSION_CHUNK / CHANNELS;
+  for (size_t start = 0; start < frames; start += chunk_frames) {
+    size_t count = frames - start < chunk_frames ? frames - start : chunk_frames;
+    for (size_t i = 0; i < count * CHANNELS; i++) {
+      staged[i] = Traits::load(input, start * CHANNELS + i);
+    }
+    for (size_t i = 0; i < count; i++) {
+      for (size_t ch = 0; ch < CHANNELS; ch++) {
+        destinations[ch][start + i] = (float)staged[i * CHANNELS + ch] * (1.0f / Traits::SCALE);
+      }
+    }
+  }
+}
+
+template <SampleFormat FORMAT>
+static void decodeRuntime(const void *input, size_t channels, size_t frames, float *const *planar) {
+  using Traits = FormatTraits<FORMAT>;
+  if (Traits::STAGED && channels <= CONVERSION_CHUNK) {
+    int32_t staged[CONVERSION_CHUNK];
+    const size_t chunk_frames = CONVERSION_CHUNK / channels;
+    for (size_t start = 0; start < frames; start += chunk_frames) {
+      size_t count = frames - start < chunk_frames ? frames - start : chunk_frames;
+      for (size_t i = 0; i < count * channels; i++) {
+        staged[i] = Traits::load(input, start * channels + i);
+      }
+      for (size_t ch = 0; ch < channels; ch++) {
+        float *destination = planar[ch] + start;
+        for (size_t i = 0; i < count; i++) {
+          destination[i] = (float)staged[i * channels + ch] * (1.0f / Traits::SCALE);
+        }
+      }
+    }
+    return;
+  }
+
+  for (size_t ch = 0; ch < channels; ch++) {
+    float *destination = planar[ch];
+    for (size_t i = 0; i < frames; i++) {
+      destination[i] = (float)Traits::load(input, i * channels + ch) * (1.0f / Traits::SCALE);
+    }
+  }
+}
+
+template <SampleFormat FORMAT>
+static void decodeFormat(const void *input, unsigned int channels, size_t frames, float *const *planar) {
+  switch (channels) {
+  case 1:
+    return decodeFixed<FORMAT, 1>(input, frames, planar);
+  case 2:
+    return decodeFixed<FORMAT, 2>(input, frames, planar);
+  case 4:
+    return decodeFixed<FORMAT, 4>(input, frames, planar);
+  case 8:
+    return decodeFixed<FORMAT, 8>(input, frames, planar);
+  default:
+    return decodeRuntime<FORMAT>(input, channels, frames, planar);
+  }
+}
+
+void decodeSamples(const void *input, unsigned int channels, unsigned int frames, SampleFormat format,
+                   float *const *planar) {
+  switch (format) {
+  case SampleFormat::INT16:
+    return decodeFormat<SampleFormat::INT16>(input, channels, frames, planar);
+  case SampleFormat::INT24_PACKED:
+    return decodeFormat<SampleFormat::INT24_PACKED>(input, channels, frames, planar);
+  case SampleFormat::INT32:
+    return decodeFormat<SampleFormat::INT32>(input, channels, frames, planar);
+  }
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
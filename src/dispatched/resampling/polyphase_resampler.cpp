@@ -0,0 +1,156 @@
+#include "dispatched/dispatched_functions.hpp"
+
+#include <stddef.h>
+
+namespace simdsp {
+namespace SIMDPP_ARCH_NAMESPACE {
+
+/*
+ * Taps per step of the dot products.  Each of these gets its own partial sum, which is what lets the compiler vectorize
+ * the dot product without reassociating floating point sums; the partial sums are added at the end.  Divides 16, so
+ * never leaves a tail.
+ */
+static const unsigned int TAP_GROUP = 8;
+
+/*
+ * Get the row for a position, interpolating into h if needed.  Returns the row to use.
+ */
+template <bool INTERPOLATE>
+static const float *getPhaseRow(const PolyphaseKernelArgs &args, uint64_t frac, float *h) {
+  if (!INTERPOLATE) {
+    return args.table + (size_t)frac * args.table_stride;
+  }
+
+  uint64_t scaled = frac * args.phase_count;
+  uint64_t phase = scaled / args.frac_denominator;
+  float weight = (float)(scaled - phase * args.frac_denominator) / (float)args.frac_denominator;
+  const float *row = args.table + (size_t)phase * args.table_stride, *next = row + args.table_stride;
+  for (unsigned int t = 0; t < args.taps; t++) {
+    h[t] = row[t] + weight * (next[t] - row[t]);
+  }
+  return h;
+}
+
+static void advancePosition(const PolyphaseKernelArgs &args, unsigned int &frame, uint64_t &frac) {
+  frame += args.step_frames;
+  frac += args.step_frac;
+  if (frac >= args.frac_denominator) {
+    frac -= args.frac_denominator;
+    frame++;
+  }
+}
+
+/*
+ * CHANNELS is a compile-time constant here, so a group of taps is a fixed-size block of interleaved floats, as in the
+ * fixed-shape direct convolution kernels.
+ */
+template <unsigned int CHANNELS, bool INTERPOLATE>
+static unsigned int resampleFixedChannels(const PolyphaseKernelArgs &args, unsigned int last_frame,
+                                          unsigned int *frame_io, uint64_t *frac_io, float *output) {
+  unsigned int frame = *frame_io, produced = 0;
+  uint64_t frac = *frac_io;
+  // Only used when interpolating.
+  float interpolated[INTERPOLATE ? POLYPHASE_MAX_TAPS : 1];
+
+  while (frame <= last_frame) {
+    const float *x = args.input + (size_t)frame * CHANNELS;
+    const float *h = getPhaseRow<INTERPOLATE>(args, frac, interpolated);
+
+    // Walking pointers rather than indexing by t + j: with 32-bit indices that might wrap, GCC can't prove the loads
+    // are contiguous, and falls back to scalar code.
+    float acc[TAP_GROUP][CHANNELS] = {};
+    const float *x_end = x + (size_t)args.taps * CHANNELS;
+    for (; x < x_end; x += TAP_GROUP * CHANNELS, h += TAP_GROUP) {
+      for (size_t j = 0; j < TAP_GROUP; j++) {
+        for (size_t ch = 0; ch < CHANNELS; ch++) {
+          acc[j][ch] += x[j * CHANNELS + ch] * h[j];
+        }
+      }
+    }
+
+    float *o = output + (size_t)produced * CHANNELS;
+    for (unsigned int ch = 0; ch < CHANNELS; ch++) {
+      float sum = 0.0f;
+      for (unsigned int j = 0; j < TAP_GROUP; j++) {
+        sum += acc[j][ch];
+      }
+      o[ch] = sum;
+    }
+
+    produced++;
+    advancePosition(args, frame, frac);
+  }
+
+  *frame_io = frame;
+  *frac_io = frac;
+  return produced;
+}
+
+/*
+ * Any other channel count: one channel at a time, strided.
+ */
+template <bool INTERPOLATE>
+static unsigned int resampleRuntimeChannels(const PolyphaseKernelArgs &args, unsigned int last_frame,
+                                            unsigned int *frame_io, uint64_t *frac_io, float *output) {
+  unsigned int frame = *frame_io, produced = 0, channels = args.channels;
+  uint64_t frac = *frac_io;
+  float interpolated[INTERPOLATE ? POLYPHASE_MAX_TAPS : 1];
+
+  while (frame <= last_frame) {
+    const float *x = args.input + (size_t)frame * channels;
+    const float *h = getPhaseRow<INTERPOLATE>(args, frac, interpolated);
+
+    for (size_t ch = 0; ch < channels; ch++) {
+      float acc[TAP_GROUP] = {};
+      for (size_t t = 0; t < args.taps; t += TAP_GROUP) {
+        for (size_t j = 0; j < TAP_GROUP; j++) {
+          acc[j] += x[(t + j) * channels + ch] * h[t + j];
+        }
+      }
+
+      float sum = 0.0f;
+      for (unsigned int j = 0; j < TAP_GROUP; j++) {
+        sum += acc[j];
+      }
+      output[(size_t)produced * channels + ch] = sum;
+    }
+
+    produced++;
+    advancePosition(args, frame, frac);
+  }
+
+  *frame_io = frame;
+  *frac_io = frac;
+  return produced;
+}
+
+template <bool INTERPOLATE>
+static unsigned int resample(const PolyphaseKernelArgs *args, unsigned int last_frame, unsigned int *frame,
+                             uint64_t *frac, float *output) {
+  switch (args->channels) {
+  case 1:
+    return resampleFixedChannels<1, INTERPOLATE>(*args, last_frame, frame, frac, output);
+  case 2:
+    return resampleFixedChannels<2, INTERPOLATE>(*args, last_frame, frame, frac, output);
+  case 4:
+    return resampleFixedChannels<4, INTERPOLATE>(*args, last_frame, frame, frac, output);
+  case 8:
+    return resampleFixedChannels<8, INTERPOLATE>(*args, last_frame, frame, frac, output);
+  default:
+    return resampleRuntimeChannels<INTERPOLATE>(*args, last_frame, frame, frac, output);
+  }
+}
+
+/*
+ * Write output frames until the position passes last_frame, returning how many were written.
+ */
+unsigned int polyphaseResample(const PolyphaseKernelArgs *args, unsigned int last_frame, unsigned int *frame,
+                               uint64_t *frac, float *output) {
+  if (args->interpolate_phases) {
+    return resample<true>(args, last_frame, frame, frac, output);
+  }
+  return resample<false>(args, last_frame, frame, frac, output);
+}
+
+} // namespace SIMDPP_ARCH_NAMESPACE
+} // namespace simdsp
@@ -0,0 +1,301 @@
+#include "fft.hpp"
+#include "simdsp/fft.hpp"
+#include "simdsp/system_info.hpp"
+
+#include "cache_sizes.hpp"
+#include "dispatch.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <map>
+#include <math.h>
+#include <mutex>
+
+namespace simdsp {
+
+/* M_PI isn't portable to MSVC without extra defines. */
+static const double PI = 3.14159265358979323846;
+
+static bool isComplexFftSizeSupported(unsigned int size) {
+  if (size == 0) {
+    return false;
+  }
+
+  for (unsigned int f : {2, 3, 5}) {
+    while (size % f == 0) {
+      size /= f;
+    }
+  }
+
+  return size == 1;
+}
+
+bool isRealFftSizeSupported(unsigned int size) {
+  return size >= 2 && size % 2 == 0 && isComplexFftSizeSupported(size / 2);
+}
+
+unsigned int getNextRealFftSize(unsigned int size) {
+  unsigned int candidate = std::max(size, 2u);
+  candidate += candidate % 2;
+  while (isRealFftSizeSupported(candidate) == false) {
+    candidate += 2;
+  }
+  return candidate;
+}
+
+ComplexFft::ComplexFft(unsigned int _size, FftAlgorithm _algorithm) : size(_size), algorithm(_algorithm) {
+  assert(isComplexFftSizeSupported(size));
+  assert(algorithm != FftAlgorithm::AUTOMATIC);
+
+  if (algorithm == FftAlgorithm::SIX_STEP) {
+    // rows is the largest divisor of size no larger than its square root.  Every divisor of a 2^a 3^b 5^c number is
+    // also one, so both halves are supported sizes.
+    rows = 1;
+    for (unsigned int d = 1; (unsigned long long)d * d <= size; d++) {
+      if (size % d == 0) {
+        rows = d;
+      }
+    }
+    cols = size / rows;
+
+    // The column block is 4 * rows * block_width floats (two split complex buffers).  Aim to keep it in a quarter of L2
+    // while staying wide enough to vectorize.
+    unsigned int budget = getL2Size() / 4 / (unsigned int)(4 * sizeof(float) * rows);
+    block_width = 16;
+    while (block_width * 2 <= budget) {
+      block_width *= 2;
+    }
+    block_width = std::min(block_width, cols);
+
+    column_fft = std::make_unique<ComplexFft>(rows, FftAlgorithm::IN_CACHE);
+    row_fft = std::make_unique<ComplexFft>(cols, FftAlgorithm::IN_CACHE);
+
+    six_step_tw_re.resize(size);
+    six_step_tw_im.resize(size);
+    for (unsigned int r = 0; r < rows; r++) {
+      for (unsigned int c = 0; c < cols; c++) {
+        // r * c can overflow 32 bits, and only matters mod size.
+        double angle = -2.0 * PI * (double)((unsigned long long)r * c % size) / (double)size;
+        six_step_tw_re[r * cols + c] = (float)cos(angle);
+        six_step_tw_im[r * cols + c] = (float)sin(angle);
+      }
+    }
+    return;
+  }
+
+  // Radix 8 first, since it's the fewest passes, then whatever power of two is left, then 3 and 5.
+  unsigned int remaining = size;
+  std::vector<unsigned int> radices;
+  while (remaining % 8 == 0) {
+    radices.push_back(8);
+    remaining /= 8;
+  }
+  if (remaining % 4 == 0) {
+    radices.push_back(4);
+    remaining /= 4;
+  }
+  if (remaining % 2 == 0) {
+    radices.push_back(2);
+    remaining /= 2;
+  }
+  for (unsigned int f : {3, 5}) {
+    while (remaining % f == 0) {
+      radices.push_back(f);
+      remaining /= f;
+    }
+  }
+
+  // Twiddles are computed in double so that large sizes don't accumulate error.
+  unsigned int len = size;
+  for (unsigned int radix : radices) {
+    unsigned int m = len / radix;
+    passes.push_back(Pass{radix, m, (unsigned int)tw_re.size()});
+    for (unsigned int j = 1; j < radix; j++) {
+      for (unsigned int p = 0; p < m; p++) {
+        double angle = -2.0 * PI * (double)(j * p) / (double)len;
+        tw_re.push_back((float)cos(angle));
+        tw_im.push_back((float)sin(angle));
+      }
+    }
+    len = m;
+  }
+}
+
+unsigned int ComplexFft::getWorkspaceSize() const {
+  if (algorithm == FftAlgorithm::SIX_STEP) {
+    // Transposed output, column blocks, row scratch.
+    return 2 * size + 4 * rows * block_width + 2 * cols;
+  }
+  return 2 * size;
+}
+
+bool ComplexFft::runPasses(float *re, float *im, float *scratch_re, float *scratch_im, unsigned int batch) const {
+  const DispatchTable *table = getDispatchTable();
+  bool in_scratch = false;
+  unsigned int stride = batch;
+
+  for (const Pass &pass : passes) {
+    const float *x_re = in_scratch ? scratch_re : re;
+    const float *x_im = in_scratch ? scratch_im : im;
+    float *y_re = in_scratch ? re : scratch_re;
+    float *y_im = in_scratch ? im : scratch_im;
+    const float *w_re = tw_re.data() + pass.tw_offset, *w_im = tw_im.data() + pass.tw_offset;
+
+    switch (pass.radix) {
+    case 2:
+      table->fftRadix2Pass(x_re, x_im, y_re, y_im, w_re, w_im, stride, pass.m);
+      break;
+    case 3:
+      table->fftRadix3Pass(x_re, x_im, y_re, y_im, w_re, w_im, stride, pass.m);
+      break;
+    case 4:
+      table->fftRadix4Pass(x_re, x_im, y_re, y_im, w_re, w_im, stride, pass.m);
+      break;
+    case 5:
+      table->fftRadix5Pass(x_re, x_im, y_re, y_im, w_re, w_im, stride, pass.m);
+      break;
+    case 8:
+      table->fftRadix8Pass(x_re, x_im, y_re, y_im, w_re, w_im, stride, pass.m);
+      break;
+    }
+
+    stride *= pass.radix;
+    in_scratch = !in_scratch;
+  }
+
+  return in_scratch;
+}
+
+void ComplexFft::forward(float *re, float *im, float *workspace, float **out_re, float **out_im) const {
+  if (algorithm == FftAlgorithm::SIX_STEP) {
+    runSixStep(re, im, workspace, out_re, out_im);
+    return;
+  }
+
+  float *scratch_re = workspace, *scratch_im = workspace + size;
+  if (runPasses(re, im, scratch_re, scratch_im, 1)) {
+    *out_re = scratch_re;
+    *out_im = scratch_im;
+  } else {
+    *out_re = re;
+    *out_im = im;
+  }
+}
+
+/*
+ * With the input viewed as a rows x cols matrix x[j1 * cols + j2] and the output index k = k1 + rows * k2:
+ *
+ * 1. Length-rows transforms down each column, a block of columns at a time, followed by multiplying element (k1, j2) by
+ * exp(-2 pi i k1 j2 / size).
+ * 2. Length-cols transforms along each row.
+ * 3. Transpose, which puts (k1, k2) at k1 + rows * k2.
+ */
+void ComplexFft::runSixStep(float *re, float *im, float *workspace, float **out_re, float **out_im) const {
+  const DispatchTable *table = getDispatchTable();
+  float *o_re = workspace, *o_im = workspace + size;
+  float *blk_re = workspace + 2 * size, *blk_im = blk_re + rows * block_width;
+  float *blk2_re = blk_im + rows * block_width, *blk2_im = blk2_re + rows * block_width;
+  float *row_re = blk2_im + rows * block_width, *row_im = row_re + cols;
+
+  for (unsigned int c0 = 0; c0 < cols; c0 += block_width) {
+    unsigned int width = std::min(block_width, cols - c0);
+
+    for (unsigned int r = 0; r < rows; r++) {
+      std::copy(re + r * cols + c0, re + r * cols + c0 + width, blk_re + r * width);
+      std::copy(im + r * cols + c0, im + r * cols + c0 + width, blk_im + r * width);
+    }
+
+    bool in_scratch = column_fft->runPasses(blk_re, blk_im, blk2_re, blk2_im, width);
+    float *c_re = in_scratch ? blk2_re : blk_re, *c_im = in_scratch ? blk2_im : blk_im;
+
+    for (unsigned int r = 0; r < rows; r++) {
+      table->complexMultiplyInPlace(c_re + r * width, c_im + r * width, &six_step_tw_re[r * cols + c0],
+                                    &six_step_tw_im[r * cols + c0], width);
+      std::copy(c_re + r * width, c_re + (r + 1) * width, re + r * cols + c0);
+      std::copy(c_im + r * width, c_im + (r + 1) * width, im + r * cols + c0);
+    }
+  }
+
+  for (unsigned int r = 0; r < rows; r++) {
+    float *this_re = re + r * cols, *this_im = im + r * cols;
+    if (row_fft->runPasses(this_re, this_im, row_re, row_im, 1)) {
+      std::copy(row_re, row_re + cols, this_re);
+      std::copy(row_im, row_im + cols, this_im);
+    }
+  }
+
+  table->fftTranspose(re, im, o_re, o_im, rows, cols);
+  *out_re = o_re;
+  *out_im = o_im;
+}
+
+/*
+ * Out-of-cache means the two split complex ping-pong buffers don't fit in L2.
+ */
+static FftAlgorithm chooseAlgorithm(unsigned int complex_size) {
+  unsigned long long working_set = 4ull * sizeof(float) * complex_size;
+  return working_set > getL2Size() ? FftAlgorithm::SIX_STEP : FftAlgorithm::IN_CACHE;
+}
+
+RealFft::RealFft(unsigned int _size, FftAlgorithm algorithm) : size(_size) {
+  assert(isRealFftSizeSupported(size));
+
+  unsigned int n = size / 2;
+  if (algorithm == FftAlgorithm::AUTOMATIC) {
+    algorithm = chooseAlgorithm(n);
+  }
+  complex_fft = std::make_unique<ComplexFft>(n, algorithm);
+
+  for (unsigned int k = 0; k <= n; k++) {
+    double angle = -2.0 * PI * (double)k / (double)size;
+    real_tw_re.push_back((float)cos(angle));
+    real_tw_im.push_back((float)sin(angle));
+  }
+}
+
+RealFft::~RealFft() {}
+
+FftAlgorithm RealFft::getAlgorithm() const { return complex_fft->getAlgorithm(); }
+
+unsigned int RealFft::getWorkspaceSize() const { return size + complex_fft->getWorkspaceSize(); }
+
+void RealFft::forward(const float *input, float *out_re, float *out_im, float *workspace) const {
+  const DispatchTable *table = getDispatchTable();
+  unsigned int n = size / 2;
+  float *a_re = workspace, *a_im = workspace + n;
+  float *z_re, *z_im;
+
+  table->fftSplitEvenOdd(input, a_re, a_im, n);
+  complex_fft->forward(a_re, a_im, workspace + size, &z_re, &z_im);
+  table->realFftPostprocess(z_re, z_im, out_re, out_im, &real_tw_re[0], &real_tw_im[0], n);
+}
+
+void RealFft::inverse(const float *in_re, const float *in_im, float *output, float *workspace) const {
+  const DispatchTable *table = getDispatchTable();
+  unsigned int n = size / 2;
+  float *a_re = workspace, *a_im = workspace + n;
+  float *z_re, *z_im;
+
+  table->realFftPreprocess(in_re, in_im, a_re, a_im, &real_tw_re[0], &real_tw_im[0], n);
+  // Swapping real and imaginary on the way in and out turns the forward transform into the inverse.
+  complex_fft->forward(a_im, a_re, workspace + size, &z_im, &z_re);
+  table->fftMergeEvenOdd(z_re, z_im, output, n);
+}
+
+std::shared_ptr<const RealFft> getRealFft(unsigned int size) {
+  // Function-local so that this works from other static initializers.
+  static std::mutex lock;
+  static std::map<unsigned int, std::shared_ptr<const RealFft>> plans;
+
+  std::lock_guard<std::mutex> guard(lock);
+  auto it = plans.find(size);
+  if (it != plans.end()) {
+    return it->second;
+  }
+
+  auto plan = std::make_shared<const RealFft>(size);
+  plans[size] = plan;
+  return plan;
+}
+
+} // namespace simdsp
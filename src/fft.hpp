@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+ * The complex FFT under RealFft.
+ *
+ * Vanilla code only: the butterflies themselves go through the dispatch table.
+ */
+
+#include "simdsp/fft.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace simdsp {
+
+/*
+ * A complex FFT of size 2^a 3^b 5^c.  Forward only; the inverse is the forward with the real and imaginary parts
+ * swapped on the way in and out, which for split complex data is free.
+ */
+class ComplexFft {
+public:
+  /*
+   * algorithm may not be AUTOMATIC.
+   */
+  ComplexFft(unsigned int size, FftAlgorithm algorithm);
+
+  unsigned int getSize() const { return size; }
+  FftAlgorithm getAlgorithm() const { return algorithm; }
+  unsigned int getWorkspaceSize() const;
+
+  /*
+   * Transform (re, im), destroying it.  The result is left either in (re, im) or in the workspace, and *out_re and
+   * *out_im are set to point at it.
+   */
+  void forward(float *re, float *im, float *workspace, float **out_re, float **out_im) const;
+
+  /*
+   * Run the Stockham passes on batch interleaved transforms: element j of transform q is at q + batch * j.  Scratch
+   * must be as large as the input.  Returns whether the result ended up in the scratch buffers.  Only for IN_CACHE
+   * plans.
+   */
+  bool runPasses(float *re, float *im, float *scratch_re, float *scratch_im, unsigned int batch) const;
+
+private:
+  void runSixStep(float *re, float *im, float *workspace, float **out_re, float **out_im) const;
+
+  struct Pass {
+    unsigned int radix, m, tw_offset;
+  };
+
+  unsigned int size;
+  FftAlgorithm algorithm;
+
+  std::vector<Pass> passes;
+  std::vector<float> tw_re, tw_im;
+
+  // For SIX_STEP: size = rows * cols.  Column transforms are of length rows, done block_width columns at a time.
+  unsigned int rows = 0, cols = 0, block_width = 0;
+  std::unique_ptr<ComplexFft> column_fft, row_fft;
+  // exp(-2 pi i r c / size) at r * cols + c.
+  std::vector<float> six_step_tw_re, six_step_tw_im;
+};
+
+} // namespace simdsp
@@ -0,0 +1,184 @@
+#include "simdsp/filters/biquad_filter_bank.hpp"
+
+#include "dispatch.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+
+namespace simdsp {
+
+BiquadCoefficients designBiquad(BiquadType type, double sample_rate, double frequency, double q, double gain_db) {
+  assert(sample_rate > 0.0 && frequency > 0.0 && frequency < sample_rate / 2.0);
+  assert(q > 0.0);
+
+  const double pi = 3.14159265358979323846;
+  double w0 = 2.0 * pi * frequency / sample_rate;
+  double cos_w0 = cos(w0), alpha = sin(w0) / (2.0 * q);
+  double a = pow(10.0, gain_db / 40.0), sqrt_a_alpha = 2.0 * sqrt(a) * alpha;
+  double b0 = 1.0, b1 = 0.0, b2 = 0.0, a0 = 1.0, a1 = 0.0, a2 = 0.0;
+
+  switch (type) {
+  case BiquadType::LOWPASS:
+    b0 = (1.0 - cos_w0) / 2.0;
+    b1 = 1.0 - cos_w0;
+    b2 = b0;
+    a0 = 1.0 + alpha;
+    a1 = -2.0 * cos_w0;
+    a2 = 1.0 - alpha;
+    break;
+  case BiquadType::HIGHPASS:
+    b0 = (1.0 + cos_w0) / 2.0;
+    b1 = -(1.0 + cos_w0);
+    b2 = b0;
+    a0 = 1.0 + alpha;
+    a1 = -2.0 * cos_w0;
+    a2 = 1.0 - alpha;
+    break;
+  case BiquadType::BANDPASS:
+    b0 = alpha;
+    b1 = 0.0;
+    b2 = -alpha;
+    a0 = 1.0 + alpha;
+    a1 = -2.0 * cos_w0;
+    a2 = 1.0 - alpha;
+    break;
+  case BiquadType::NOTCH:
+    b0 = 1.0;
+    b1 = -2.0 * cos_w0;
+    b2 = 1.0;
+    a0 = 1.0 + alpha;
+    a1 = -2.0 * cos_w0;
+    a2 = 1.0 - alpha;
+    break;
+  case BiquadType::ALLPASS:
+    b0 = 1.0 - alpha;
+    b1 = -2.0 * cos_w0;
+    b2 = 1.0 + alpha;
+    a0 = 1.0 + alpha;
+    a1 = -2.0 * cos_w0;
+    a2 = 1.0 - alpha;
+    break;
+  case BiquadType::PEAKING:
+    b0 = 1.0 + alpha * a;
+    b1 = -2.0 * cos_w0;
+    b2 = 1.0 - alpha * a;
+    a0 = 1.0 + alpha / a;
+    a1 = -2.0 * cos_w0;
+    a2 = 1.0 - alpha / a;
+    break;
+  case BiquadType::LOW_SHELF:
+    b0 = a * ((a + 1.0) - (a - 1.0) * cos_w0 + sqrt_a_alpha);
+    b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cos_w0);
+    b2 = a * ((a + 1.0) - (a - 1.0) * cos_w0 - sqrt_a_alpha);
+    a0 = (a + 1.0) + (a - 1.0) * cos_w0 + sqrt_a_alpha;
+    a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cos_w0);
+    a2 = (a + 1.0) + (a - 1.0) * cos_w0 - sqrt_a_alpha;
+    break;
+  case BiquadType::HIGH_SHELF:
+    b0 = a * ((a + 1.0) + (a - 1.0) * cos_w0 + sqrt_a_alpha);
+    b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cos_w0);
+    b2 = a * ((a + 1.0) + (a - 1.0) * cos_w0 - sqrt_a_alpha);
+    a0 = (a + 1.0) - (a - 1.0) * cos_w0 + sqrt_a_alpha;
+    a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cos_w0);
+    a2 = (a + 1.0) - (a - 1.0) * cos_w0 - sqrt_a_alpha;
+    break;
+  }
+
+  BiquadCoefficients ret;
+  ret.b0 = (float)(b0 / a0);
+  ret.b1 = (float)(b1 / a0);
+  ret.b2 = (float)(b2 / a0);
+  ret.a1 = (float)(a1 / a0);
+  ret.a2 = (float)(a2 / a0);
+  return ret;
+}
+
+BiquadFilterBank::BiquadFilterBank(unsigned int _lanes, unsigned int _sections) : lanes(_lanes), sections(_sections) {
+  assert(lanes != 0 && sections != 0);
+
+  lane_stride = (unsigned int)padToSimdAlignment<float>(lanes);
+  coefficients.resize((size_t)sections * 5 * lane_stride);
+  targets.resize(coefficients.size());
+  deltas.resize(coefficients.size());
+  state.resize((size_t)sections * 2 * lane_stride);
+
+  // Everything starts as the identity, which is b0 = 1 and the rest 0.
+  for (unsigned int s = 0; s < sections; s++) {
+    std::fill(getCoefficientArray(coefficients, s, 0), getCoefficientArray(coefficients, s, 0) + lanes, 1.0f);
+    std::fill(getCoefficientArray(targets, s, 0), getCoefficientArray(targets, s, 0) + lanes, 1.0f);
+  }
+}
+
+void BiquadFilterBank::setCoefficients(unsigned int lane, unsigned int section, const BiquadCoefficients &c,
+                                       bool interpolate) {
+  assert(lane < lanes && section < sections);
+
+  const float values[5] = {c.b0, c.b1, c.b2, c.a1, c.a2};
+  for (unsigned int k = 0; k < 5; k++) {
+    getCoefficientArray(targets, section, k)[lane] = values[k];
+    if (!interpolate) {
+      getCoefficientArray(coefficients, section, k)[lane] = values[k];
+    }
+  }
+  interpolation_pending |= interpolate;
+}
+
+BiquadCoefficients BiquadFilterBank::getCoefficients(unsigned int lane, unsigned int section) const {
+  assert(lane < lanes && section < sections);
+
+  const float *base = &targets[(size_t)section * 5 * lane_stride + lane];
+  BiquadCoefficients ret;
+  ret.b0 = base[0];
+  ret.b1 = base[lane_stride];
+  ret.b2 = base[2 * lane_stride];
+  ret.a1 = base[3 * lane_stride];
+  ret.a2 = base[4 * lane_stride];
+  return ret;
+}
+
+void BiquadFilterBank::finishInterpolation() {
+  // Exactly at the targets, rather than wherever accumulating the deltas left us.
+  std::copy(targets.begin(), targets.end(), coefficients.begin());
+  interpolation_pending = false;
+}
+
+void BiquadFilterBank::resetLane(unsigned int lane) {
+  assert(lane < lanes);
+
+  for (unsigned int s = 0; s < sections; s++) {
+    for (unsigned int k = 0; k < 5; k++) {
+      getCoefficientArray(coefficients, s, k)[lane] = getCoefficientArray(targets, s, k)[lane];
+    }
+    state[(size_t)s * 2 * lane_stride + lane] = 0.0f;
+    state[((size_t)s * 2 + 1) * lane_stride + lane] = 0.0f;
+  }
+}
+
+void BiquadFilterBank::reset() {
+  finishInterpolation();
+  std::fill(state.begin(), state.end(), 0.0f);
+}
+
+void BiquadFilterBank::process(const float *input, float *output, unsigned int frames) {
+  if (frames == 0) {
+    return;
+  }
+
+  const DispatchTable *table = getDispatchTable();
+  if (!interpolation_pending) {
+    table->biquadFilterBank(input, output, frames, lanes, sections, &coefficients[0], nullptr, &state[0],
+                            lane_stride);
+    return;
+  }
+
+  float inv_frames = 1.0f / (float)frames;
+  for (size_t i = 0; i < coefficients.paddedSize(); i++) {
+    deltas[i] = (targets[i] - coefficients[i]) * inv_frames;
+  }
+  table->biquadFilterBank(input, output, frames, lanes, sections, &coefficients[0], &deltas[0], &state[0],
+                          lane_stride);
+  finishInterpolation();
+}
+
+} // namespace simdsp
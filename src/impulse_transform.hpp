@@ -0,0 +1,17 @@
+#pragma once
+
+#include "simdsp/fft.hpp"
+
+namespace simdsp {
+
+/*
+ * Partition and transform an interleaved impulse into the layout described by ImpulseSpectra, using fft (of twice the
+ * block size).  Shared by UniformPartitionedConvolver and the impulse spectra files so that the two can never disagree.
+ *
+ * time_block holds fft.getSize() floats and workspace fft.getWorkspaceSize(); nothing is allocated.
+ */
+void transformImpulsePartitions(const RealFft &fft, unsigned int channels, unsigned int partition_count,
+                                unsigned int spectrum_stride, const float *impulse, unsigned int impulse_len,
+                                float *out_re, float *out_im, float *time_block, float *workspace);
+
+} // namespace simdsp
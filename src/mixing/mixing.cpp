@@ -0,0 +1,39 @@
+#include "simdsp/mixing/mixing.hpp"
+
+#include "dispatch.hpp"
+
+namespace simdsp {
+
+// Static builds have these inline in the header.
+#if !SIMDSP_STATIC_DISPATCH
+
+void mixGain(const float *input, float *output, unsigned int frames, unsigned int channels, float gain, bool add) {
+  getDispatchTable()->mixGainRamp(input, output, frames, channels, gain, gain, add);
+}
+
+void mixGainRamp(const float *input, float *output, unsigned int frames, unsigned int channels, float gain_start,
+                 float gain_end, bool add) {
+  getDispatchTable()->mixGainRamp(input, output, frames, channels, gain_start, gain_end, add);
+}
+
+void mixMatrix(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+               unsigned int frames, const float *matrix, bool add) {
+  getDispatchTable()->mixMatrix(input, input_channels, output, output_channels, frames, matrix, nullptr, add);
+}
+
+void mixMatrixRamp(const float *input, unsigned int input_channels, float *output, unsigned int output_channels,
+                   unsigned int frames, const float *from_matrix, const float *to_matrix, bool add) {
+  getDispatchTable()->mixMatrix(input, input_channels, output, output_channels, frames, from_matrix, to_matrix, add);
+}
+
+void interleaveChannels(const float *const *planar, unsigned int channels, unsigned int frames, float *output) {
+  getDispatchTable()->interleaveChannels(planar, channels, frames, output);
+}
+
+void deinterleaveChannels(const float *input, unsigned int channels, unsigned int frames, float *const *planar) {
+  getDispatchTable()->deinterleaveChannels(input, channels, frames, planar);
+}
+
+#endif
+
+} // namespace simdsp
@@ -0,0 +1,60 @@
+#include "simdsp/mixing/sample_format.hpp"
+
+#include "dispatch.hpp"
+
+#include <assert.h>
+
+namespace simdsp {
+
+unsigned int getSampleFormatBytes(SampleFormat format) {
+  switch (format) {
+  case SampleFormat::INT16:
+    return 2;
+  case SampleFormat::INT24_PACKED:
+    return 3;
+  case SampleFormat::INT32:
+    return 4;
+  }
+  assert(!"Unknown sample format");
+  return 0;
+}
+
+SampleDither::SampleDither(uint64_t seed) {
+  // splitmix64, so that nearby seeds give unrelated lanes.
+  for (unsigned int i = 0; i < SAMPLE_DITHER_LANES; i++) {
+    seed += 0x9e3779b97f4a7c15ull;
+    uint64_t z = seed;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    // xorshift never leaves 0.
+    state[i] = (uint32_t)(z >> 32) | 1;
+  }
+}
+
+// Static builds have these inline in the header.
+#if !SIMDSP_STATIC_DISPATCH
+
+void convertFloatToSamples(const float *input, unsigned int samples, SampleFormat format, void *output,
+                           SampleDither *dither) {
+  // Any layout is one channel as far as the kernels are concerned.
+  getDispatchTable()->encodeSamples(&input, 1, samples, format, output, dither ? dither->state : nullptr);
+}
+
+void convertSamplesToFloat(const void *input, unsigned int samples, SampleFormat format, float *output) {
+  getDispatchTable()->decodeSamples(input, 1, samples, format, &output);
+}
+
+void interleaveFloatToSamples(const float *const *planar, unsigned int channels, unsigned int frames,
+                              SampleFormat format, void *output, SampleDither *dither) {
+  getDispatchTable()->encodeSamples(planar, channels, frames, format, output, dither ? dither->state : nullptr);
+}
+
+void deinterleaveSamplesToFloat(const void *input, unsigned int channels, unsigned int frames, SampleFormat format,
+                                float *const *planar) {
+  getDispatchTable()->decodeSamples(input, channels, frames, format, planar);
+}
+
+#endif
+
+} // namespace simdsp
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace simdsp {
+
+static const unsigned int POLYPHASE_MAX_TAPS = 64;
+
+/*
+ * The fixed parameters of a run of polyphase resampling, for the dispatched polyphaseResample kernel.  Plain data,
+ * since this is included from dispatched code.
+ *
+ * Output frame k is the dot product of taps interleaved input frames starting at input + frame * channels with the
+ * table row for the fractional part of the position, where the position starts at frame + frac / frac_denominator and
+ * advances by step_frames + step_frac / frac_denominator per output frame.
+ *
+ * Rows are table_stride floats apart.  Without interpolation there are phase_count == frac_denominator rows, one per
+ * fractional position.  With it, there are phase_count + 1 rows evenly spanning [0, 1] and the row for a position is
+ * linearly interpolated between its two neighbours.
+ *
+ * taps is a multiple of 16 and at most POLYPHASE_MAX_TAPS.
+ */
+struct PolyphaseKernelArgs {
+  const float *input;
+  unsigned int channels;
+  const float *table;
+  unsigned int table_stride, taps, phase_count;
+  bool interpolate_phases;
+  uint64_t frac_denominator;
+  unsigned int step_frames;
+  uint64_t step_frac;
+};
+
+} // namespace simdsp
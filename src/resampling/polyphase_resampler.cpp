@@ -0,0 +1,244 @@
+#include "simdsp/resampling/polyphase_resampler.hpp"
+
+#include "dispatch.hpp"
+#include "polyphase_kernel.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <map>
+#include <math.h>
+#include <mutex>
+#include <tuple>
+
+namespace simdsp {
+
+/*
+ * Rational resamplers needing more phases than this use an interpolated table instead.  Past it the table stops
+ * fitting in L2 at the higher qualities, and ratios like that are usually a rate which is slightly off rather than a
+ * real conversion.
+ */
+static const unsigned int MAX_RATIONAL_PHASES = 1024;
+
+/*
+ * Phases in an interpolated table.  With linear interpolation between them, the error is well under the stopband of
+ * even the best quality.
+ */
+static const unsigned int INTERPOLATED_PHASES = 256;
+
+/*
+ * Input frames history holds beyond what one output frame needs.  Longer input is worked through in pieces.
+ */
+static const unsigned int HISTORY_CHUNK_FRAMES = 1024;
+
+struct PolyphaseTable {
+  unsigned int taps, stride, phase_count;
+  bool interpolated;
+  AlignedBuffer<float> coefficients;
+};
+
+struct QualityParameters {
+  unsigned int taps;
+  // Kaiser window shape, and where the passband ends as a fraction of the lower Nyquist frequency.
+  double beta, bandwidth;
+};
+
+static QualityParameters getQualityParameters(ResamplerQuality quality) {
+  switch (quality) {
+  case ResamplerQuality::LOW:
+    return {16, 6.0, 0.85};
+  case ResamplerQuality::MEDIUM:
+    return {32, 8.0, 0.9};
+  case ResamplerQuality::HIGH:
+    return {64, 10.0, 0.94};
+  }
+  return {32, 8.0, 0.9};
+}
+
+static double besselI0(double x) {
+  double sum = 1.0, term = 1.0;
+  for (unsigned int k = 1; k < 50; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+    if (term < sum * 1e-12) {
+      break;
+    }
+  }
+  return sum;
+}
+
+/*
+ * Row r is the windowed sinc sampled at t - (taps / 2 - 1) - r / phase_count for taps t, so that the kernel's output
+ * for a position is centered taps / 2 - 1 frames after it, plus the fraction.  Each row is normalized to unity gain at
+ * DC, which keeps the gain from wobbling between phases.
+ */
+static std::shared_ptr<const PolyphaseTable> buildTable(ResamplerQuality quality, double cutoff,
+                                                        unsigned int phase_count, bool interpolated) {
+  const double pi = 3.14159265358979323846;
+  QualityParameters params = getQualityParameters(quality);
+  assert(params.taps % 16 == 0 && params.taps <= POLYPHASE_MAX_TAPS);
+
+  auto table = std::make_shared<PolyphaseTable>();
+  table->taps = params.taps;
+  table->stride = (unsigned int)padToSimdAlignment<float>(params.taps);
+  table->phase_count = phase_count;
+  table->interpolated = interpolated;
+
+  unsigned int rows = phase_count + (interpolated ? 1 : 0);
+  table->coefficients.resize((size_t)rows * table->stride);
+
+  double half = params.taps / 2.0, i0_beta = besselI0(params.beta);
+  for (unsigned int r = 0; r < rows; r++) {
+    float *row = &table->coefficients[(size_t)r * table->stride];
+    double offset = (double)r / (double)phase_count, sum = 0.0;
+    double values[POLYPHASE_MAX_TAPS];
+
+    for (unsigned int t = 0; t < params.taps; t++) {
+      double arg = (double)t - (half - 1.0) - offset;
+      double x = pi * cutoff * arg;
+      double sinc = fabs(x) < 1e-12 ? 1.0 : sin(x) / x;
+      double ratio = arg / half;
+      double window = fabs(ratio) >= 1.0 ? 0.0 : besselI0(params.beta * sqrt(1.0 - ratio * ratio)) / i0_beta;
+      values[t] = cutoff * sinc * window;
+      sum += values[t];
+    }
+
+    for (unsigned int t = 0; t < params.taps; t++) {
+      row[t] = (float)(values[t] / sum);
+    }
+  }
+
+  return table;
+}
+
+/*
+ * Tables are shared between everyone asking for the same quality, ratio, and mode, and live until the process exits,
+ * like FFT plans.
+ */
+static std::shared_ptr<const PolyphaseTable> getPolyphaseTable(ResamplerQuality quality, unsigned int up,
+                                                               unsigned int down, bool interpolated) {
+  // Function-local so that this works from other static initializers.
+  static std::mutex lock;
+  static std::map<std::tuple<int, unsigned int, unsigned int, bool>, std::shared_ptr<const PolyphaseTable>> tables;
+
+  auto key = std::make_tuple((int)quality, up, down, interpolated);
+  std::lock_guard<std::mutex> guard(lock);
+  auto it = tables.find(key);
+  if (it != tables.end()) {
+    return it->second;
+  }
+
+  double cutoff = getQualityParameters(quality).bandwidth * std::min(1.0, (double)up / (double)down);
+  auto table = buildTable(quality, cutoff, interpolated ? INTERPOLATED_PHASES : up, interpolated);
+  tables[key] = table;
+  return table;
+}
+
+static unsigned int gcd(unsigned int a, unsigned int b) {
+  while (b != 0) {
+    unsigned int t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+PolyphaseResampler::PolyphaseResampler(unsigned int _channels, unsigned int input_rate, unsigned int output_rate,
+                                       ResamplerQuality quality, bool _variable)
+    : channels(_channels), variable(_variable) {
+  assert(channels != 0 && input_rate != 0 && output_rate != 0);
+
+  unsigned int g = gcd(input_rate, output_rate);
+  unsigned int up = output_rate / g, down = input_rate / g;
+  bool interpolated = variable || up > MAX_RATIONAL_PHASES;
+
+  table = getPolyphaseTable(quality, up, down, interpolated);
+  taps = table->taps;
+
+  if (interpolated) {
+    frac_denominator = (uint64_t)1 << 32;
+    setRatio((double)output_rate / (double)input_rate);
+  } else {
+    frac_denominator = up;
+    step_frames = down / up;
+    step_frac = down % up;
+  }
+
+  history_capacity = taps + HISTORY_CHUNK_FRAMES;
+  history.resize((size_t)history_capacity * channels);
+  reset();
+}
+
+PolyphaseResampler::~PolyphaseResampler() {}
+
+void PolyphaseResampler::setRatio(double ratio) {
+  assert(table->interpolated);
+  assert(ratio > 0.0);
+
+  double step = 1.0 / ratio;
+  double whole = floor(step);
+  step_frames = (unsigned int)whole;
+  step_frac = (uint64_t)((step - whole) * (double)frac_denominator + 0.5);
+  if (step_frac >= frac_denominator) {
+    step_frames++;
+    step_frac -= frac_denominator;
+  }
+}
+
+void PolyphaseResampler::reset() {
+  std::fill(history.begin(), history.end(), 0.0f);
+  // Leading silence, so that the first output frame is centered on the first input frame.
+  history_frames = taps / 2 - 1;
+  frame = 0;
+  frac = 0;
+}
+
+unsigned int PolyphaseResampler::getMaxOutputFrames(unsigned int input_frames) const {
+  uint64_t step = (uint64_t)step_frames * frac_denominator + step_frac;
+  uint64_t span = (uint64_t)(history_frames + input_frames - std::min(frame, history_frames)) * frac_denominator;
+  return (unsigned int)(span / step + 1);
+}
+
+unsigned int PolyphaseResampler::drain(float *output) {
+  unsigned int produced = 0;
+  if (history_frames >= taps) {
+    PolyphaseKernelArgs args;
+    args.input = history.data();
+    args.channels = channels;
+    args.table = table->coefficients.data();
+    args.table_stride = table->stride;
+    args.taps = taps;
+    args.phase_count = table->phase_count;
+    args.interpolate_phases = table->interpolated;
+    args.frac_denominator = frac_denominator;
+    args.step_frames = step_frames;
+    args.step_frac = step_frac;
+    produced = getDispatchTable()->polyphaseResample(&args, history_frames - taps, &frame, &frac, output);
+  }
+
+  // Everything before the next position is done with.  When downsampling hard, the next position may be past the end.
+  unsigned int drop = std::min(frame, history_frames);
+  std::copy(history.begin() + (size_t)drop * channels, history.begin() + (size_t)history_frames * channels,
+            history.begin());
+  history_frames -= drop;
+  frame -= drop;
+  return produced;
+}
+
+unsigned int PolyphaseResampler::process(const float *input, unsigned int input_frames, float *output) {
+  unsigned int produced = 0;
+
+  // After draining, fewer than taps frames are left, so there's always room for more.
+  while (input_frames != 0) {
+    unsigned int count = std::min(history_capacity - history_frames, input_frames);
+    std::copy(input, input + (size_t)count * channels, history.begin() + (size_t)history_frames * channels);
+    history_frames += count;
+    input += (size_t)count * channels;
+    input_frames -= count;
+
+    produced += drain(output + (size_t)produced * channels);
+  }
+
+  return produced;
+}
+
+} // namespace simdsp
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <assert.h>
+#include <atomic>
+#include <vector>
+
+namespace simdsp {
+
+/*
+ * A bounded, lock-free, single-producer single-consumer queue.
+ *
+ * push may only be called from one thread and pop from one (possibly different) thread.  Neither allocates or blocks;
+ * push fails if the queue is full and pop fails if it is empty.
+ */
+template <typename T> class SpscQueue {
+public:
+  /* capacity must be a power of two. */
+  explicit SpscQueue(unsigned int capacity) : slots(capacity), mask(capacity - 1) {
+    assert(capacity != 0 && (capacity & (capacity - 1)) == 0);
+  }
+
+  bool push(const T &value) {
+    unsigned int t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == slots.size()) {
+      return false;
+    }
+    slots[t & mask] = value;
+    // Release publishes the slot, and anything the producer wrote before pushing.
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T &out) {
+    unsigned int h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    out = slots[h & mask];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<T> slots;
+  unsigned int mask;
+  // Kept on separate cache lines so that the two threads don't fight over them.
+  alignas(64) std::atomic<unsigned int> head{0};
+  alignas(64) std::atomic<unsigned int> tail{0};
+};
+
+} // namespace simdsp
@@ -13,10 +13,13 @@
 #include "simdsp/system_info.hpp"
 #include "simdsp/feature_macros.hpp"
 
+#include <assert.h>
 #include <atomic>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <thread>
 
 #if SIMDSP_IS_X86
 #if __GNUC__
@@ -29,16 +32,30 @@
 #endif
 #endif
 
+#if SIMDSP_IS_AARCH64
+#if __linux__
+#include <sys/auxv.h>
+#include <sys/prctl.h>
+#endif
+
+#if __APPLE__
+#include <sys/sysctl.h>
+#endif
+#endif
+
 namespace simdsp {
 /*
  * by using this intermediate array, we can guarantee the count is correct with sizeof.
  */
 static const CpuBit BITS_ARRAY[] = {
-    CpuCapabilities::X86_SSE2,     CpuCapabilities::X86_SSE3,        CpuCapabilities::X86_SSSE3,
-    CpuCapabilities::X86_SSE4_1,   CpuCapabilities::X86_POPCNT_INSN, CpuCapabilities::X86_AVX,
-    CpuCapabilities::X86_AVX2,     CpuCapabilities::X86_FMA3,        CpuCapabilities::X86_FMA4,
-    CpuCapabilities::X86_XOP,      CpuCapabilities::X86_AVX512F,     CpuCapabilities::X86_AVX512BW,
-    CpuCapabilities::X86_AVX512DQ, CpuCapabilities::X86_AVX512VL,
+    CpuCapabilities::X86_SSE2,       CpuCapabilities::X86_SSE3,        CpuCapabilities::X86_SSSE3,
+    CpuCapabilities::X86_SSE4_1,     CpuCapabilities::X86_POPCNT_INSN, CpuCapabilities::X86_AVX,
+    CpuCapabilities::X86_AVX2,       CpuCapabilities::X86_FMA3,        CpuCapabilities::X86_FMA4,
+    CpuCapabilities::X86_XOP,        CpuCapabilities::X86_AVX512F,     CpuCapabilities::X86_AVX512BW,
+    CpuCapabilities::X86_AVX512DQ,   CpuCapabilities::X86_AVX512VL,    CpuCapabilities::AARCH64_NEON,
+    CpuCapabilities::AARCH64_FP16,   CpuCapabilities::AARCH64_DOTPROD, CpuCapabilities::AARCH64_SVE,
+    CpuCapabilities::AARCH64_SVE2,   CpuCapabilities::X86_F16C,        CpuCapabilities::X86_AVX512VNNI,
+    CpuCapabilities::X86_AVX512BF16, CpuCapabilities::X86_AVX512FP16,  CpuCapabilities::X86_AVX_VNNI,
 };
 
 const CpuBit *CpuCapabilities::ALL_BITS = BITS_ARRAY;
@@ -114,6 +131,11 @@ static CpuCapabilities getCpuCapabilities();
 static CpuManufacturer getCpuManufacturer();
 static CpuArchitecture getCpuArchitecture();
 static CpuCaches getCpuCacheInfo();
+static bool getDazSupported();
+static CpuTopology getCpuTopology();
+static void getCpuTopologyFallback(CpuTopology *topology);
+static unsigned int getSveVectorBytes();
+static bool getAvx512Downclocks();
 
 SystemInfo getSystemInfoUncached() {
   SystemInfo sysinfo{};
@@ -122,6 +144,10 @@ SystemInfo getSystemInfoUncached() {
   sysinfo.cpu_manufacturer = getCpuManufacturer();
   sysinfo.cpu_architecture = getCpuArchitecture();
   sysinfo.cache_info = getCpuCacheInfo();
+  sysinfo.daz_supported = getDazSupported();
+  sysinfo.topology = getCpuTopology();
+  sysinfo.sve_vector_bytes = getSveVectorBytes();
+  sysinfo.avx512_downclocks = getAvx512Downclocks();
   return sysinfo;
 }
 
@@ -164,6 +190,228 @@ SystemInfo getSystemInfo() {
   return info_cache.info;
 }
 
+bool getCacheSharingMask(const CpuTopology *topology, unsigned int cpu, unsigned int level,
+                         uint64_t mask[CPU_TOPOLOGY_MAX_CPUS / 64]) {
+  assert(cpu < topology->logical_cores);
+  assert(level == 2 || level == 3);
+
+  for (unsigned int i = 0; i < CPU_TOPOLOGY_MAX_CPUS / 64; i++) {
+    mask[i] = 0;
+  }
+
+  auto domain = [&](const LogicalCpu &c) { return level == 2 ? c.l2_domain : c.l3_domain; };
+  uint16_t mine = domain(topology->cpus[cpu]);
+  if (mine == CPU_TOPOLOGY_UNKNOWN) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < topology->logical_cores; i++) {
+    const LogicalCpu &other = topology->cpus[i];
+    if (domain(other) == mine) {
+      mask[other.os_index / 64] |= (uint64_t)1 << (other.os_index % 64);
+    }
+  }
+  return true;
+}
+
+namespace {
+/*
+ * Hands out dense indices for arbitrary keys, in the order they are first seen.  There can't be more distinct cores,
+ * caches, etc. than there are CPUs, so a linear search over a fixed array is plenty.
+ */
+struct DenseIndices {
+  unsigned int keys[CPU_TOPOLOGY_MAX_CPUS];
+  unsigned int count = 0;
+
+  uint16_t get(unsigned int key) {
+    for (unsigned int i = 0; i < count; i++) {
+      if (keys[i] == key) {
+        return (uint16_t)i;
+      }
+    }
+    assert(count < CPU_TOPOLOGY_MAX_CPUS);
+    keys[count] = key;
+    return (uint16_t)count++;
+  }
+};
+} // namespace
+
+#if __linux__
+static bool readSysfsLine(const char *path, char *buf, size_t size) {
+  FILE *f = fopen(path, "r");
+  if (f == nullptr) {
+    return false;
+  }
+  bool ok = fgets(buf, (int)size, f) != nullptr;
+  fclose(f);
+  return ok;
+}
+
+/*
+ * Parse a list like "0-3,8,10-11", as Linux uses for sets of CPUs and NUMA nodes, into a mask of
+ * CPU_TOPOLOGY_MAX_CPUS bits.  Anything past that is dropped.
+ */
+static bool parseSysfsList(const char *list, uint64_t mask[CPU_TOPOLOGY_MAX_CPUS / 64]) {
+  for (unsigned int i = 0; i < CPU_TOPOLOGY_MAX_CPUS / 64; i++) {
+    mask[i] = 0;
+  }
+
+  const char *cursor = list;
+  while (*cursor != '\0' && *cursor != '\n') {
+    char *end;
+    unsigned long first = strtoul(cursor, &end, 10), last = first;
+    if (end == cursor) {
+      return false;
+    }
+    if (*end == '-') {
+      cursor = end + 1;
+      last = strtoul(cursor, &end, 10);
+      if (end == cursor || last < first) {
+        return false;
+      }
+    }
+
+    for (unsigned long i = first; i <= last && i < CPU_TOPOLOGY_MAX_CPUS; i++) {
+      mask[i / 64] |= (uint64_t)1 << (i % 64);
+    }
+
+    cursor = end;
+    if (*cursor == ',') {
+      cursor++;
+    }
+  }
+  return true;
+}
+
+static bool readSysfsList(const char *path, uint64_t mask[CPU_TOPOLOGY_MAX_CPUS / 64]) {
+  // A list of every CPU on a big machine, written out one at a time, is a few kilobytes.
+  char buf[4096];
+  return readSysfsLine(path, buf, sizeof(buf)) && parseSysfsList(buf, mask);
+}
+
+/*
+ * The lowest CPU in a sysfs CPU list, which identifies the core, package or cache the list is the members of.  Lists
+ * are sorted, so this is the first number.
+ */
+static bool readSysfsListKey(const char *path, unsigned int *key) {
+  char buf[4096];
+  if (readSysfsLine(path, buf, sizeof(buf)) == false) {
+    return false;
+  }
+  char *end;
+  *key = (unsigned int)strtoul(buf, &end, 10);
+  return end != buf;
+}
+
+static bool isInMask(const uint64_t *mask, unsigned int i) { return (mask[i / 64] >> (i % 64)) & 1; }
+
+static bool readCpuTopologySysfs(CpuTopology *topology) {
+  uint64_t online[CPU_TOPOLOGY_MAX_CPUS / 64];
+  if (readSysfsList("/sys/devices/system/cpu/online", online) == false) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < CPU_TOPOLOGY_MAX_CPUS; i++) {
+    if (isInMask(online, i)) {
+      topology->cpus[topology->logical_cores++].os_index = (uint16_t)i;
+    }
+  }
+  if (topology->logical_cores == 0) {
+    return false;
+  }
+
+  DenseIndices cores, packages, l2s, l3s, nodes;
+  char path[256];
+
+  for (unsigned int i = 0; i < topology->logical_cores; i++) {
+    LogicalCpu &cpu = topology->cpus[i];
+    unsigned int key;
+
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", cpu.os_index);
+    cpu.core = cores.get(readSysfsListKey(path, &key) ? key : cpu.os_index);
+    // core_siblings_list is the package, despite the name, and is older than package_cpus_list.
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_siblings_list", cpu.os_index);
+    cpu.package = packages.get(readSysfsListKey(path, &key) ? key : 0);
+
+    cpu.l2_domain = CPU_TOPOLOGY_UNKNOWN;
+    cpu.l3_domain = CPU_TOPOLOGY_UNKNOWN;
+    for (unsigned int index = 0;; index++) {
+      char buf[64];
+
+      snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/level", cpu.os_index, index);
+      if (readSysfsLine(path, buf, sizeof(buf)) == false) {
+        break;
+      }
+      unsigned int level = (unsigned int)atoi(buf);
+
+      snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/type", cpu.os_index, index);
+      if (readSysfsLine(path, buf, sizeof(buf)) == false || buf[0] == 'I') {
+        // Instruction caches don't matter for placing threads.
+        continue;
+      }
+
+      snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cache/index%u/shared_cpu_list", cpu.os_index,
+               index);
+      if (readSysfsListKey(path, &key) == false) {
+        continue;
+      }
+      if (level == 2) {
+        cpu.l2_domain = l2s.get(key);
+      } else if (level == 3) {
+        cpu.l3_domain = l3s.get(key);
+      }
+    }
+  }
+
+  // Without NUMA support in the kernel, there's no node directory and everything is node 0.
+  uint64_t node_list[CPU_TOPOLOGY_MAX_CPUS / 64];
+  if (readSysfsList("/sys/devices/system/node/online", node_list)) {
+    for (unsigned int node = 0; node < CPU_TOPOLOGY_MAX_CPUS; node++) {
+      uint64_t node_cpus[CPU_TOPOLOGY_MAX_CPUS / 64];
+      snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+      if (isInMask(node_list, node) == false || readSysfsList(path, node_cpus) == false) {
+        continue;
+      }
+      for (unsigned int i = 0; i < topology->logical_cores; i++) {
+        if (isInMask(node_cpus, topology->cpus[i].os_index)) {
+          topology->cpus[i].numa_node = nodes.get(node);
+        }
+      }
+    }
+  }
+
+  topology->physical_cores = cores.count;
+  topology->packages = packages.count;
+  topology->numa_nodes = nodes.count > 0 ? nodes.count : 1;
+  topology->l2_domains = l2s.count;
+  topology->l3_domains = l3s.count;
+  return true;
+}
+#endif
+
+static CpuTopology getCpuTopology() {
+  CpuTopology topology{};
+
+#if __linux__
+  if (readCpuTopologySysfs(&topology)) {
+    return topology;
+  }
+  // Perhaps /sys isn't mounted, as in some containers.
+  topology = CpuTopology{};
+#endif
+
+  unsigned int logical = std::thread::hardware_concurrency();
+  logical = logical == 0 ? 1 : logical;
+  logical = logical < CPU_TOPOLOGY_MAX_CPUS ? logical : CPU_TOPOLOGY_MAX_CPUS;
+  topology.logical_cores = logical;
+  for (unsigned int i = 0; i < logical; i++) {
+    topology.cpus[i].os_index = (uint16_t)i;
+  }
+
+  getCpuTopologyFallback(&topology);
+  return topology;
+}
+
 #if SIMDSP_IS_X86
 static void runCpuId(unsigned level, unsigned subleaf, unsigned *eax, unsigned *ebx, unsigned *ecx, unsigned *edx) {
 #if __GNUC__
@@ -212,11 +460,19 @@ inline uint64_t getXcr(unsigned level) {
 #endif
 }
 
+/*
+ * XCR0 bits for the register state the OS saves on context switch.  A feature is only usable if the OS saves its
+ * registers: otherwise they get silently corrupted whenever the thread is preempted, or the instructions fault.
+ */
+static const uint64_t XCR0_SSE = 1u << 1, XCR0_AVX = 1u << 2;
+// Opmask registers, the upper halves of zmm0-15, and zmm16-31.
+static const uint64_t XCR0_AVX512 = (1u << 5) | (1u << 6) | (1u << 7);
+
 static CpuCapabilities getCpuCapabilities() {
   CpuCapabilities caps{};
 
   uint32_t eax, ebx, ecx, edx;
-  bool xsave_xrstore_avail = false;
+  bool avx_os = false, avx512_os = false;
 
   runCpuId(0, 0, &eax, &ebx, &ecx, &edx);
   unsigned int max_cpuid_level = eax;
@@ -228,6 +484,13 @@ static CpuCapabilities getCpuCapabilities() {
   if (max_cpuid_level >= 0x00000001) {
     runCpuId(0x00000001, 0, &eax, &ebx, &ecx, &edx);
 
+    // OSXSAVE, i.e. the OS has turned on XSAVE and XCR0 can be read.
+    if (ecx & (1u << 27)) {
+      uint64_t xcr = getXcr(0);
+      avx_os = (xcr & (XCR0_SSE | XCR0_AVX)) == (XCR0_SSE | XCR0_AVX);
+      avx512_os = avx_os && (xcr & XCR0_AVX512) == XCR0_AVX512;
+    }
+
     if (edx & (1u << 26))
       caps |= CpuCapabilities::X86_SSE2;
     if (ecx & (1u << 0))
@@ -240,46 +503,93 @@ static CpuCapabilities getCpuCapabilities() {
       caps |= CpuCapabilities::X86_POPCNT_INSN; // popcnt is included in SSE4.2 on Intel
     if (ecx & (1u << 23))
       caps |= CpuCapabilities::X86_POPCNT_INSN;
-    if (ecx & (1u << 12))
+    // FMA and F16C work on ymm registers, so need the AVX state too.
+    if (ecx & (1u << 12) && avx_os)
       caps |= CpuCapabilities::X86_FMA3;
-    if (ecx & (1u << 26)) {
-      // XSAVE/XRSTORE available on hardware, now check OS support
-      uint64_t xcr = getXcr(0);
-      if ((xcr & 6) == 6)
-        xsave_xrstore_avail = true;
-    }
-
-    if (ecx & (1u << 28) && xsave_xrstore_avail)
+    if (ecx & (1u << 28) && avx_os)
       caps |= CpuCapabilities::X86_AVX;
+    if (ecx & (1u << 29) && avx_os)
+      caps |= CpuCapabilities::X86_F16C;
   }
   if (max_ex_cpuid_level >= 0x80000001) {
     runCpuId(0x80000001, 0, &eax, &ebx, &ecx, &edx);
-    if (ecx & (1u << 16))
+    if (ecx & (1u << 16) && avx_os)
       caps |= CpuCapabilities::X86_FMA4;
-    if (ecx & (1u << 11))
+    if (ecx & (1u << 11) && avx_os)
       caps |= CpuCapabilities::X86_XOP;
   }
 
   if (max_cpuid_level >= 0x00000007) {
     runCpuId(0x00000007, 0, &eax, &ebx, &ecx, &edx);
-    if (ebx & (1u << 5) && xsave_xrstore_avail)
+    unsigned int max_leaf7_subleaf = eax;
+
+    if (ebx & (1u << 5) && avx_os)
       caps |= CpuCapabilities::X86_AVX2;
-    if (ebx & (1u << 16) && xsave_xrstore_avail)
+    if (ebx & (1u << 16) && avx512_os)
       caps |= CpuCapabilities::X86_AVX512F;
-    if (ebx & (1u << 30) && xsave_xrstore_avail)
+    if (ebx & (1u << 30) && avx512_os)
       caps |= CpuCapabilities::X86_AVX512BW;
-    if (ebx & (1u << 17) && xsave_xrstore_avail)
+    if (ebx & (1u << 17) && avx512_os)
       caps |= CpuCapabilities::X86_AVX512DQ;
-    if (ebx & (1u << 31) && xsave_xrstore_avail)
+    if (ebx & (1u << 31) && avx512_os)
       caps |= CpuCapabilities::X86_AVX512VL;
+    if (ecx & (1u << 11) && avx512_os)
+      caps |= CpuCapabilities::X86_AVX512VNNI;
+    if (edx & (1u << 23) && avx512_os)
+      caps |= CpuCapabilities::X86_AVX512FP16;
+
+    if (max_leaf7_subleaf >= 1) {
+      runCpuId(0x00000007, 1, &eax, &ebx, &ecx, &edx);
+      if (eax & (1u << 4) && avx_os)
+        caps |= CpuCapabilities::X86_AVX_VNNI;
+      if (eax & (1u << 5) && avx512_os)
+        caps |= CpuCapabilities::X86_AVX512BF16;
+    }
   }
 
   return caps;
 }
 
+/*
+ * Intel parts from Skylake-SP to Tiger Lake drop to a lower frequency "license" while running heavy 512-bit code, for
+ * long enough after the last such instruction that sprinkling a few through otherwise scalar code is a net loss.
+ * Sapphire Rapids and later barely do, and AMD doesn't.  There is no CPUID bit for this, so it's a list of models.
+ */
+static bool getAvx512Downclocks() {
+  unsigned int eax, ebx, ecx, edx;
+
+  if (getCpuManufacturer() != CpuManufacturer::INTEL) {
+    return false;
+  }
+
+  SAFE_CPUID(1, 0);
+  unsigned int family = (eax >> 8) & 0xf, model = (eax >> 4) & 0xf;
+  if (family == 6 || family == 15) {
+    model |= ((eax >> 16) & 0xf) << 4;
+  }
+  if (family != 6) {
+    return false;
+  }
+
+  switch (model) {
+  case 0x55: // Skylake-SP, Cascade Lake, Cooper Lake.
+  case 0x66: // Cannon Lake.
+  case 0x6a: // Ice Lake-SP.
+  case 0x6c: // Ice Lake-D.
+  case 0x7d: // Ice Lake client.
+  case 0x7e:
+  case 0x8c: // Tiger Lake.
+  case 0x8d:
+  case 0xa7: // Rocket Lake.
+    return true;
+  default:
+    return false;
+  }
+}
+
 static CpuCaches getCpuCacheInfoIntel() {
   unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
-  CpuCaches ret{0};
+  CpuCaches ret{};
 
   SAFE_CPUID(0, 0);
   unsigned int max_fn = eax;
@@ -359,7 +669,7 @@ static CpuCaches getCpuCacheInfoIntel() {
 
 static CpuCaches getCpuCacheInfoAmd() {
   unsigned int eax, ebx, ecx, edx;
-  CpuCaches ret{0};
+  CpuCaches ret{};
 
   SAFE_CPUID(0x80000000, 0);
   unsigned int max_fn = eax;
@@ -392,17 +702,268 @@ static CpuCaches getCpuCacheInfo() {
   }
 }
 
+/*
+ * DAZ support is advertised by bit 6 of MXCSR_MASK, which only FXSAVE reveals.  A mask of 0 means the CPU predates the
+ * field, and so DAZ.
+ */
+static bool getDazSupported() {
+  unsigned int eax, ebx, ecx, edx;
+
+  SAFE_CPUID(1, 0);
+  // FXSR.
+  if ((edx & (1u << 24)) == 0) {
+    return false;
+  }
+
+  alignas(16) unsigned char area[512] = {};
+#if _MSC_VER
+  _fxsave(area);
+#else
+  __asm__ __volatile__("fxsave %0" : "=m"(area));
+#endif
+
+  uint32_t mxcsr_mask = (uint32_t)area[28] | ((uint32_t)area[29] << 8) | ((uint32_t)area[30] << 16) |
+                        ((uint32_t)area[31] << 24);
+  return (mxcsr_mask & (1u << 6)) != 0;
+}
+
+static unsigned int divideRoundingUp(unsigned int a, unsigned int b) { return (a + b - 1) / b; }
+
+/*
+ * Without the OS to ask, all we get is how many threads share each core, package and cache.  That is enough if CPUs
+ * are numbered package by package with SMT siblings adjacent, which is what Windows and macOS do.  Each package is
+ * assumed to be its own NUMA node.
+ */
+static void getCpuTopologyFallback(CpuTopology *topology) {
+  unsigned int eax, ebx, ecx, edx;
+  unsigned int logical = topology->logical_cores;
+
+  SAFE_CPUID(0, 0);
+  unsigned int max_fn = eax;
+  SAFE_CPUID(0x80000000, 0);
+  unsigned int max_ex_fn = eax;
+
+  // 0x1F is a superset of 0xB, adding module and die levels.  Either may be present but empty.
+  unsigned int topology_leaf = 0;
+  if (max_fn >= 0x1f) {
+    SAFE_CPUID(0x1f, 0);
+    topology_leaf = ebx != 0 ? 0x1f : 0;
+  }
+  if (topology_leaf == 0 && max_fn >= 0xb) {
+    SAFE_CPUID(0xb, 0);
+    topology_leaf = ebx != 0 ? 0xb : 0;
+  }
+
+  // Each level reports how many threads are within it, so the last level is the package.
+  unsigned int threads_per_core = 1, threads_per_package = logical;
+  if (topology_leaf != 0) {
+    for (unsigned int subleaf = 0;; subleaf++) {
+      SAFE_CPUID(topology_leaf, subleaf);
+      unsigned int level_type = (ecx >> 8) & 0xff, threads = ebx & 0xffff;
+      if (level_type == 0 || threads == 0) {
+        break;
+      }
+      if (level_type == 1) {
+        threads_per_core = threads;
+      }
+      threads_per_package = threads;
+    }
+  }
+
+  // The cache leaves report how many threads could share each cache, which is rounded up to a power of 2.  That is fine
+  // as long as the cache isn't shared across packages, which it can't be.
+  unsigned int threads_per_cache[4] = {};
+  unsigned int cache_leaf = getCpuManufacturer() == CpuManufacturer::AMD ? 0x8000001d : 4;
+  if ((cache_leaf == 4 && max_fn >= 4) || (cache_leaf != 4 && max_ex_fn >= cache_leaf)) {
+    for (unsigned int subleaf = 0;; subleaf++) {
+      SAFE_CPUID(cache_leaf, subleaf);
+      unsigned int cache_type = eax & 0x1f, cache_level = (eax >> 5) & 0x7;
+      if (cache_type == 0) {
+        break;
+      }
+      // Skip instruction caches.
+      if (cache_type != 2 && cache_level < 4) {
+        threads_per_cache[cache_level] = ((eax >> 14) & 0xfff) + 1;
+      }
+    }
+  }
+
+  threads_per_package = threads_per_package < threads_per_core ? threads_per_core : threads_per_package;
+  for (unsigned int level = 2; level < 4; level++) {
+    if (threads_per_cache[level] > threads_per_package) {
+      threads_per_cache[level] = threads_per_package;
+    }
+  }
+
+  for (unsigned int i = 0; i < logical; i++) {
+    LogicalCpu &cpu = topology->cpus[i];
+    cpu.core = (uint16_t)(i / threads_per_core);
+    cpu.package = (uint16_t)(i / threads_per_package);
+    cpu.numa_node = cpu.package;
+    cpu.l2_domain = threads_per_cache[2] != 0 ? (uint16_t)(i / threads_per_cache[2]) : CPU_TOPOLOGY_UNKNOWN;
+    cpu.l3_domain = threads_per_cache[3] != 0 ? (uint16_t)(i / threads_per_cache[3]) : CPU_TOPOLOGY_UNKNOWN;
+  }
+
+  topology->physical_cores = divideRoundingUp(logical, threads_per_core);
+  topology->packages = divideRoundingUp(logical, threads_per_package);
+  topology->numa_nodes = topology->packages;
+  topology->l2_domains = threads_per_cache[2] != 0 ? divideRoundingUp(logical, threads_per_cache[2]) : 0;
+  topology->l3_domains = threads_per_cache[3] != 0 ? divideRoundingUp(logical, threads_per_cache[3]) : 0;
+}
+
+static unsigned int getSveVectorBytes() { return 0; }
+
 #elif SIMDSP_IS_AARCH64
 
+#if __linux__
+/*
+ * From the kernel's asm/hwcap.h, which glibc doesn't always pull in, and which older toolchains have fewer of.
+ */
+static const unsigned long HWCAP_BIT_ASIMD = 1ul << 1, HWCAP_BIT_ASIMDHP = 1ul << 10, HWCAP_BIT_ASIMDDP = 1ul << 20,
+                           HWCAP_BIT_SVE = 1ul << 22;
+static const unsigned long HWCAP2_BIT_SVE2 = 1ul << 1;
+
+static CpuCapabilities getCpuCapabilities() {
+  CpuCapabilities caps{};
+  unsigned long hwcap = getauxval(AT_HWCAP), hwcap2 = getauxval(AT_HWCAP2);
+
+  if (hwcap & HWCAP_BIT_ASIMD)
+    caps |= CpuCapabilities::AARCH64_NEON;
+  if (hwcap & HWCAP_BIT_ASIMDHP)
+    caps |= CpuCapabilities::AARCH64_FP16;
+  if (hwcap & HWCAP_BIT_ASIMDDP)
+    caps |= CpuCapabilities::AARCH64_DOTPROD;
+  if (hwcap & HWCAP_BIT_SVE)
+    caps |= CpuCapabilities::AARCH64_SVE;
+  if (hwcap2 & HWCAP2_BIT_SVE2)
+    caps |= CpuCapabilities::AARCH64_SVE2;
+
+  return caps;
+}
+
+/*
+ * The kernel knows the vector length even if userspace can't execute rdvl without SVE in the compiler.  The constants
+ * are from linux/prctl.h.
+ */
+static unsigned int getSveVectorBytes() {
+  const int PR_SVE_GET_VL_OPTION = 51;
+  const int PR_SVE_VL_LEN_MASK_BITS = 0xffff;
+
+  if ((getauxval(AT_HWCAP) & HWCAP_BIT_SVE) == 0) {
+    return 0;
+  }
+  int vl = prctl(PR_SVE_GET_VL_OPTION);
+  return vl < 0 ? 0 : (unsigned int)(vl & PR_SVE_VL_LEN_MASK_BITS);
+}
+
+/*
+ * Cache sizes from sysfs, which has what the firmware (ACPI PPTT or the device tree) told the kernel.  Sizes look like
+ * "64K".
+ */
+static CpuCaches getCpuCacheInfo() {
+  CpuCaches ret{};
+  char path[256], buf[64];
+
+  for (unsigned int index = 0;; index++) {
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/level", index);
+    if (readSysfsLine(path, buf, sizeof(buf)) == false) {
+      break;
+    }
+    unsigned int level = (unsigned int)atoi(buf);
+
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/size", index);
+    if (readSysfsLine(path, buf, sizeof(buf)) == false) {
+      continue;
+    }
+    char *suffix;
+    unsigned int size = (unsigned int)strtoul(buf, &suffix, 10);
+    if (*suffix == 'K') {
+      size *= 1024;
+    } else if (*suffix == 'M') {
+      size *= 1024 * 1024;
+    }
+
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%u/type", index);
+    if (readSysfsLine(path, buf, sizeof(buf)) == false) {
+      continue;
+    }
+    // Data, Instruction, or Unified.
+    unsigned int *dests[3][3] = {
+        {&ret.l1d, &ret.l1i, &ret.l1u},
+        {&ret.l2d, &ret.l2i, &ret.l2u},
+        {&ret.l3d, &ret.l3i, &ret.l3u},
+    };
+    unsigned int kind = buf[0] == 'D' ? 0 : buf[0] == 'I' ? 1 : buf[0] == 'U' ? 2 : 3;
+    if (level >= 1 && level <= 3 && kind < 3) {
+      *dests[level - 1][kind] = size;
+    }
+  }
+
+  return ret;
+}
+
+#elif __APPLE__
+
+static bool getSysctlFlag(const char *name) {
+  int value = 0;
+  size_t size = sizeof(value);
+  return sysctlbyname(name, &value, &size, nullptr, 0) == 0 && value != 0;
+}
+
+static unsigned int getSysctlSize(const char *name) {
+  uint64_t value = 0;
+  size_t size = sizeof(value);
+  return sysctlbyname(name, &value, &size, nullptr, 0) == 0 ? (unsigned int)value : 0;
+}
+
+/*
+ * No Apple silicon has SVE.
+ */
 static CpuCapabilities getCpuCapabilities() {
-  // For now we don't understand neon.
-  return CpuCapabilities{};
+  CpuCapabilities caps = CpuCapabilities::AARCH64_NEON;
+
+  if (getSysctlFlag("hw.optional.arm.FEAT_FP16"))
+    caps |= CpuCapabilities::AARCH64_FP16;
+  if (getSysctlFlag("hw.optional.arm.FEAT_DotProd"))
+    caps |= CpuCapabilities::AARCH64_DOTPROD;
+
+  return caps;
+}
+
+static unsigned int getSveVectorBytes() { return 0; }
+
+/*
+ * The performance cores' caches, since that's where audio threads end up.  Older macOS only has the hw.* names.
+ */
+static CpuCaches getCpuCacheInfo() {
+  CpuCaches ret{};
+
+  ret.l1d = getSysctlSize("hw.perflevel0.l1dcachesize");
+  ret.l1i = getSysctlSize("hw.perflevel0.l1icachesize");
+  ret.l2u = getSysctlSize("hw.perflevel0.l2cachesize");
+  if (ret.l1d == 0) {
+    ret.l1d = getSysctlSize("hw.l1dcachesize");
+    ret.l1i = getSysctlSize("hw.l1icachesize");
+    ret.l2u = getSysctlSize("hw.l2cachesize");
+  }
+  return ret;
 }
 
+#else
+
 /*
- * For now, no cache info.  ARM doesn't make getting at this easy, and it's not useful because the only major platforms
- * which we currently care about have well-defined hardware.
+ * Windows on ARM and anything else: AdvSIMD is mandatory, and that's all we know.
  */
+static CpuCapabilities getCpuCapabilities() { return CpuCapabilities{} | CpuCapabilities::AARCH64_NEON; }
+
+static unsigned int getSveVectorBytes() { return 0; }
+
+static CpuCaches getCpuCacheInfo() { return CpuCaches{}; }
+
+#endif
+
+static bool getAvx512Downclocks() { return false; }
+
 static CpuManufacturer getCpuManufacturer() {
 #ifdef __APPLE__
   return CpuManufacturer::APPLE;
@@ -413,7 +974,23 @@ static CpuManufacturer getCpuManufacturer() {
 
 static CpuArchitecture getCpuArchitecture() { return CpuArchitecture::AARCH64; }
 
-static CpuCaches getCpuCacheInfo() { return CpuCaches{}; }
+// FPCR.FZ is architectural, and flushes inputs as well as outputs.
+static bool getDazSupported() { return true; }
+
+/*
+ * Only Linux tells us anything, and that is handled by the sysfs code.  Treat every CPU as its own core.
+ */
+static void getCpuTopologyFallback(CpuTopology *topology) {
+  for (unsigned int i = 0; i < topology->logical_cores; i++) {
+    LogicalCpu &cpu = topology->cpus[i];
+    cpu.core = (uint16_t)i;
+    cpu.l2_domain = CPU_TOPOLOGY_UNKNOWN;
+    cpu.l3_domain = CPU_TOPOLOGY_UNKNOWN;
+  }
+  topology->physical_cores = topology->logical_cores;
+  topology->packages = 1;
+  topology->numa_nodes = 1;
+}
 #else
 #error Unable to build CPU info for this architecture.
 #endif
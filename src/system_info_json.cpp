@@ -6,6 +6,7 @@
 #include <sstream>
 #include <stddef.h>
 #include <variant>
+#include <vector>
 
 // Normally we don't do this, but using iostreams is suepr super annoying without it.
 using namespace std;
@@ -38,6 +39,52 @@ template <typename V> static void jsonify(ostringstream &out, const map<string,
   out << '}';
 }
 
+template <typename V> static void jsonify(ostringstream &out, const vector<V> &v) {
+  out << '[';
+
+  for (size_t i = 0; i < v.size(); i++) {
+    jsonify(out, v[i]);
+    if (i + 1 < v.size()) {
+      out << ',';
+    }
+  }
+
+  out << ']';
+}
+
+static void jsonify(ostringstream &out, const CpuTopology &topology) {
+  vector<map<string, unsigned int>> cpus;
+
+  for (unsigned int i = 0; i < topology.logical_cores; i++) {
+    const LogicalCpu &cpu = topology.cpus[i];
+    // CPU_TOPOLOGY_UNKNOWN comes out as 65535, which is at least obviously not an index.
+    cpus.push_back({
+        {"os_index", cpu.os_index},
+        {"core", cpu.core},
+        {"package", cpu.package},
+        {"numa_node", cpu.numa_node},
+        {"l2_domain", cpu.l2_domain},
+        {"l3_domain", cpu.l3_domain},
+    });
+  }
+
+  out << '{';
+  jsonWriteKv(out, "logical_cores", topology.logical_cores);
+  out << ',';
+  jsonWriteKv(out, "physical_cores", topology.physical_cores);
+  out << ',';
+  jsonWriteKv(out, "packages", topology.packages);
+  out << ',';
+  jsonWriteKv(out, "numa_nodes", topology.numa_nodes);
+  out << ',';
+  jsonWriteKv(out, "l2_domains", topology.l2_domains);
+  out << ',';
+  jsonWriteKv(out, "l3_domains", topology.l3_domains);
+  out << ',';
+  jsonWriteKv(out, "cpus", cpus);
+  out << '}';
+}
+
 template <typename V> static void jsonWriteKv(ostringstream &out, const char *k, const V &v) {
   out << '"' << k << '"' << ':';
   jsonify(out, v);
@@ -74,6 +121,14 @@ char *convertSystemInfoToJson(SystemInfo *sysinfo) {
   jsonWriteKv(out, "cpu_manufacturer", cpuManufacturerToString(sysinfo->cpu_manufacturer));
   out << ',';
   jsonWriteKv(out, "cpu_architecture", cpuArchitectureToString(sysinfo->cpu_architecture));
+  out << ',';
+  jsonWriteKv(out, "daz_supported", sysinfo->daz_supported);
+  out << ',';
+  jsonWriteKv(out, "sve_vector_bytes", sysinfo->sve_vector_bytes);
+  out << ',';
+  jsonWriteKv(out, "avx512_downclocks", sysinfo->avx512_downclocks);
+  out << ',';
+  jsonWriteKv(out, "cpu_topology", sysinfo->topology);
   out << '}';
 
   return strdup(out.str().c_str());
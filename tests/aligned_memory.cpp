@@ -0,0 +1,82 @@
+#include "simdsp/aligned_memory.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <new>
+#include <stdint.h>
+#include <utility>
+
+static bool isAligned(const void *ptr) { return (uintptr_t)ptr % simdsp::getSimdAlignment() == 0; }
+
+TEST_CASE("the alignment convention is a sane power of two", "[memory]") {
+  size_t alignment = simdsp::getSimdAlignment();
+  REQUIRE(alignment >= 16);
+  REQUIRE(alignment <= simdsp::MAX_SIMD_ALIGNMENT);
+  REQUIRE((alignment & (alignment - 1)) == 0);
+
+  REQUIRE(simdsp::padToSimdAlignment<float>(0) == 0);
+  REQUIRE(simdsp::padToSimdAlignment<float>(1) == alignment / sizeof(float));
+  REQUIRE(simdsp::padToSimdAlignment<float>(alignment / sizeof(float)) == alignment / sizeof(float));
+  REQUIRE(simdsp::padToSimdAlignment<double>(alignment / sizeof(double) + 1) == 2 * alignment / sizeof(double));
+}
+
+TEST_CASE("aligned buffers are aligned, padded, and zeroed", "[memory]") {
+  for (size_t count : {1u, 3u, 16u, 17u, 1000u}) {
+    simdsp::AlignedBuffer<float> buf(count);
+    REQUIRE(buf.size() == count);
+    REQUIRE(buf.paddedSize() >= count);
+    REQUIRE(isAligned(buf.data()));
+    for (size_t i = 0; i < buf.paddedSize(); i++) {
+      REQUIRE(buf[i] == 0.0f);
+    }
+  }
+
+  simdsp::AlignedBuffer<float> a(10), b(20);
+  float *a_data = a.data(), *b_data = b.data();
+  std::swap(a, b);
+  REQUIRE(a.data() == b_data);
+  REQUIRE(a.size() == 20);
+  REQUIRE(b.data() == a_data);
+  REQUIRE(b.size() == 10);
+
+  simdsp::AlignedBuffer<float> empty;
+  REQUIRE(empty.empty());
+  REQUIRE(empty.data() == nullptr);
+
+  // Far more than any address space, so this fails at the allocation and not on first use.
+  simdsp::AlignedBuffer<float> huge(10);
+  REQUIRE_THROWS_AS(huge.resize((size_t)1 << 60), std::bad_alloc);
+  REQUIRE(huge.empty());
+  REQUIRE(huge.data() == nullptr);
+}
+
+TEST_CASE("aligned arenas allocate aligned, zeroed, padded spans until they run out", "[memory]") {
+  simdsp::AlignedArena arena(4096);
+  REQUIRE(arena.getCapacity() >= 4096);
+
+  auto first = arena.allocate<float>(5);
+  REQUIRE(first.count == 5);
+  REQUIRE(isAligned(first.data));
+  for (size_t i = 0; i < first.padded_count; i++) {
+    REQUIRE(first[i] == 0.0f);
+    first[i] = 1.0f;
+  }
+
+  size_t mark = arena.getMark();
+  auto second = arena.allocate<double>(7);
+  REQUIRE(isAligned(second.data));
+  REQUIRE((void *)second.data >= (void *)(first.data + first.padded_count));
+
+  arena.rewind(mark);
+  auto third = arena.allocate<float>(3);
+  REQUIRE((void *)third.data == (void *)second.data);
+  REQUIRE(third[0] == 0.0f);
+
+  auto too_big = arena.allocate<float>(arena.getCapacity());
+  REQUIRE(too_big.empty());
+  REQUIRE(too_big.data == nullptr);
+
+  arena.reset();
+  REQUIRE(arena.getUsed() == 0);
+  REQUIRE(arena.allocate<float>(5).data == first.data);
+}
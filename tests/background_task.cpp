@@ -0,0 +1,50 @@
+#include "simdsp/convolution/convolution_worker.hpp"
+
+#include "background_task.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <thread>
+
+static void countRun(void *userdata) { (*(unsigned int *)userdata)++; }
+
+TEST_CASE("a stolen task can be resubmitted without a second queue entry", "[convolution]") {
+  simdsp::ConvolutionWorker worker;
+  unsigned int runs = 0;
+  simdsp::BackgroundTask task;
+  task.run = countRun;
+  task.userdata = &runs;
+
+  // Not attached yet, so the worker leaves whatever is pushed alone and every task gets stolen.  A capacity of one
+  // means a second entry for the same task would overflow.
+  simdsp::BackgroundTaskQueue queue(1);
+  queue.worker = &worker;
+
+  REQUIRE(simdsp::submitTask(&queue, &task));
+  REQUIRE(simdsp::finishTask(&task));
+  REQUIRE(runs == 1);
+
+  // The stolen task's entry is still in the queue.
+  REQUIRE(simdsp::submitTask(&queue, &task));
+  REQUIRE(simdsp::finishTask(&task));
+  REQUIRE(runs == 2);
+
+  // Once attached, the worker pops the old entry and runs the new submission from it.
+  REQUIRE(simdsp::submitTask(&queue, &task));
+  worker.attach(&queue);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (task.state.load() != simdsp::BACKGROUND_TASK_DONE && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  REQUIRE(simdsp::finishTask(&task) == false);
+  REQUIRE(runs == 3);
+
+  // And the queue has room again.
+  REQUIRE(task.in_queue.load() == false);
+  REQUIRE(simdsp::submitTask(&queue, &task));
+  simdsp::finishTask(&task);
+  REQUIRE(runs == 4);
+
+  worker.detach(&queue);
+}
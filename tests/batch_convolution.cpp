@@ -0,0 +1,54 @@
+#include "test_common.hpp"
+
+#include "simdsp/convolution/batch_convolution.hpp"
+#include "simdsp/convolution/generic_block_convolution.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+static void checkBatch(unsigned int job_count, unsigned int channels, unsigned int input_len, unsigned int impulse_len,
+                       bool vary_modes = false) {
+  unsigned int seed = job_count * 17 + channels * 3 + impulse_len;
+  unsigned int history_len = impulse_len - 1 + input_len;
+
+  std::vector<std::vector<float>> inputs(job_count), impulses(job_count), outputs(job_count), expected(job_count);
+  std::vector<simdsp::BatchConvolutionJob> jobs(job_count);
+  for (unsigned int j = 0; j < job_count; j++) {
+    inputs[j] = makeNoise(history_len * channels, seed + 2 * j);
+    impulses[j] = makeNoise(impulse_len * channels, seed + 2 * j + 1);
+    // Outputs start nonzero to check that results are added.
+    outputs[j].assign(input_len * channels, 1.0f);
+    expected[j].assign(input_len * channels, 1.0f);
+
+    float *cur = &inputs[j][(impulse_len - 1) * channels];
+    jobs[j] = simdsp::BatchConvolutionJob{cur, &impulses[j][0], &outputs[j][0]};
+    if (vary_modes) {
+      // Every job differs, to catch modes being applied to the wrong lanes.
+      jobs[j].mode.add = j % 2 == 0;
+      jobs[j].mode.gain_start = 0.5f + 0.25f * (float)j;
+      jobs[j].mode.gain_end = j % 3 == 0 ? jobs[j].mode.gain_start : -1.0f + 0.125f * (float)j;
+    }
+    simdsp::genericBlockConvolver(cur, input_len, channels, &impulses[j][0], impulse_len, &expected[j][0],
+                                  jobs[j].mode);
+  }
+
+  std::vector<float> workspace(simdsp::getBatchBlockConvolverWorkspaceSize(input_len, impulse_len));
+  simdsp::batchBlockConvolver(&jobs[0], job_count, channels, input_len, impulse_len, &workspace[0]);
+
+  for (unsigned int j = 0; j < job_count; j++) {
+    for (unsigned int i = 0; i < input_len * channels; i++) {
+      REQUIRE(outputs[j][i] == Approx(expected[j][i]).margin(1e-4));
+    }
+  }
+}
+
+TEST_CASE("batchBlockConvolver matches genericBlockConvolver", "[convolution]") {
+  SECTION("one mono job") { checkBatch(1, 1, 32, 16); }
+  SECTION("exactly one group") { checkBatch(16, 1, 64, 128); }
+  SECTION("ragged last group") { checkBatch(37, 1, 48, 33); }
+  SECTION("stereo jobs") { checkBatch(9, 2, 32, 64); }
+  SECTION("single tap") { checkBatch(5, 3, 16, 1); }
+  SECTION("per-job output modes") { checkBatch(21, 1, 48, 40, true); }
+  SECTION("per-job output modes, stereo") { checkBatch(7, 2, 32, 17, true); }
+}
@@ -0,0 +1,166 @@
+#include "simdsp/filters/biquad_filter_bank.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <complex>
+#include <math.h>
+#include <random>
+#include <vector>
+
+/*
+ * One lane in double precision, with the coefficients of each section for each frame given by a linear ramp from from
+ * to to as BiquadFilterBank does it.  While coefficients move the output depends on the filter structure, so this is
+ * transposed direct form II as well.
+ */
+struct ReferenceLane {
+  std::vector<double> z1, z2;
+
+  explicit ReferenceLane(unsigned int sections) : z1(sections, 0.0), z2(sections, 0.0) {}
+
+  double tick(double in, const std::vector<simdsp::BiquadCoefficients> &from,
+              const std::vector<simdsp::BiquadCoefficients> &to, double t) {
+    for (unsigned int s = 0; s < z1.size(); s++) {
+      auto lerp = [&](float a, float b) { return (double)a + ((double)b - (double)a) * t; };
+      double b0 = lerp(from[s].b0, to[s].b0), b1 = lerp(from[s].b1, to[s].b1), b2 = lerp(from[s].b2, to[s].b2);
+      double a1 = lerp(from[s].a1, to[s].a1), a2 = lerp(from[s].a2, to[s].a2);
+      double out = b0 * in + z1[s];
+      z1[s] = b1 * in - a1 * out + z2[s];
+      z2[s] = b2 * in - a2 * out;
+      in = out;
+    }
+    return in;
+  }
+};
+
+static simdsp::BiquadCoefficients randomDesign(std::mt19937 &rng) {
+  std::uniform_int_distribution<int> type_dist(0, 7);
+  std::uniform_real_distribution<double> freq_dist(100.0, 15000.0), q_dist(0.5, 4.0), gain_dist(-12.0, 12.0);
+  return simdsp::designBiquad((simdsp::BiquadType)type_dist(rng), 48000.0, freq_dist(rng), q_dist(rng),
+                              gain_dist(rng));
+}
+
+/*
+ * Run blocks of noise through a bank with random designs per lane, changing the designs (interpolated) every few
+ * blocks, and compare every lane against the reference.
+ */
+static void checkAgainstReference(unsigned int lanes, unsigned int sections, unsigned int block_size,
+                                   unsigned int blocks, bool in_place) {
+  std::mt19937 rng(lanes * 31 + sections * 7 + block_size);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+  simdsp::BiquadFilterBank bank(lanes, sections);
+  std::vector<ReferenceLane> reference(lanes, ReferenceLane(sections));
+  std::vector<std::vector<simdsp::BiquadCoefficients>> current(lanes,
+                                                               std::vector<simdsp::BiquadCoefficients>(sections));
+
+  for (unsigned int lane = 0; lane < lanes; lane++) {
+    for (unsigned int s = 0; s < sections; s++) {
+      current[lane][s] = randomDesign(rng);
+      bank.setCoefficients(lane, s, current[lane][s], false);
+    }
+  }
+
+  double max_err = 0.0;
+  std::vector<float> input(block_size * lanes), output(block_size * lanes);
+  for (unsigned int b = 0; b < blocks; b++) {
+    auto targets = current;
+    if (b % 3 == 2) {
+      for (unsigned int lane = 0; lane < lanes; lane++) {
+        for (unsigned int s = 0; s < sections; s++) {
+          targets[lane][s] = randomDesign(rng);
+          bank.setCoefficients(lane, s, targets[lane][s]);
+        }
+      }
+    }
+
+    for (auto &x : input) {
+      x = dist(rng);
+    }
+    if (in_place) {
+      output = input;
+      bank.process(&output[0], &output[0], block_size);
+    } else {
+      bank.process(&input[0], &output[0], block_size);
+    }
+
+    for (unsigned int i = 0; i < block_size; i++) {
+      double t = (double)(i + 1) / (double)block_size;
+      for (unsigned int lane = 0; lane < lanes; lane++) {
+        double expected = reference[lane].tick(input[i * lanes + lane], current[lane], targets[lane], t);
+        max_err = fmax(max_err, fabs(expected - (double)output[i * lanes + lane]));
+      }
+    }
+    current = targets;
+  }
+
+  REQUIRE(max_err < 1e-3);
+}
+
+TEST_CASE("biquad filter banks match a double precision reference", "[filters]") {
+  SECTION("mono") { checkAgainstReference(1, 1, 64, 12, false); }
+  SECTION("stereo, cascaded") { checkAgainstReference(2, 3, 32, 12, false); }
+  SECTION("one full lane group") { checkAgainstReference(16, 2, 48, 9, false); }
+  SECTION("full and partial lane groups") { checkAgainstReference(37, 2, 16, 12, false); }
+  SECTION("in place") { checkAgainstReference(21, 2, 33, 9, true); }
+}
+
+TEST_CASE("biquad filter bank reset clears state", "[filters]") {
+  simdsp::BiquadFilterBank bank(3, 2);
+  for (unsigned int lane = 0; lane < 3; lane++) {
+    bank.setCoefficients(lane, 0, simdsp::designBiquad(simdsp::BiquadType::LOWPASS, 48000.0, 1000.0, 0.707), false);
+  }
+
+  std::vector<float> input(3 * 16, 1.0f), first(input.size()), again(input.size());
+  bank.process(&input[0], &first[0], 16);
+  bank.reset();
+  bank.process(&input[0], &again[0], 16);
+  REQUIRE(first == again);
+
+  bank.process(&input[0], &again[0], 16);
+  bank.resetLane(1);
+  bank.process(&input[0], &again[0], 16);
+  for (unsigned int i = 0; i < 16; i++) {
+    REQUIRE(again[i * 3 + 1] == first[i * 3 + 1]);
+  }
+}
+
+static double getMagnitude(const simdsp::BiquadCoefficients &c, double sample_rate, double frequency) {
+  std::complex<double> z = std::polar(1.0, -2.0 * 3.14159265358979323846 * frequency / sample_rate);
+  std::complex<double> num = (double)c.b0 + (double)c.b1 * z + (double)c.b2 * z * z;
+  std::complex<double> den = 1.0 + (double)c.a1 * z + (double)c.a2 * z * z;
+  return std::abs(num / den);
+}
+
+TEST_CASE("biquad designs have the expected responses", "[filters]") {
+  const double sr = 48000.0;
+  using simdsp::BiquadType;
+
+  auto lowpass = simdsp::designBiquad(BiquadType::LOWPASS, sr, 1000.0, 0.707);
+  REQUIRE(getMagnitude(lowpass, sr, 0.0) == Approx(1.0).epsilon(1e-4));
+  REQUIRE(getMagnitude(lowpass, sr, 1000.0) == Approx(0.707).epsilon(1e-2));
+  REQUIRE(getMagnitude(lowpass, sr, 20000.0) < 0.01);
+
+  auto highpass = simdsp::designBiquad(BiquadType::HIGHPASS, sr, 1000.0, 0.707);
+  REQUIRE(getMagnitude(highpass, sr, 0.0) < 1e-4);
+  REQUIRE(getMagnitude(highpass, sr, 20000.0) == Approx(1.0).epsilon(1e-2));
+
+  auto bandpass = simdsp::designBiquad(BiquadType::BANDPASS, sr, 2000.0, 2.0);
+  REQUIRE(getMagnitude(bandpass, sr, 2000.0) == Approx(1.0).epsilon(1e-4));
+
+  auto notch = simdsp::designBiquad(BiquadType::NOTCH, sr, 2000.0, 2.0);
+  REQUIRE(getMagnitude(notch, sr, 2000.0) < 1e-3);
+
+  auto allpass = simdsp::designBiquad(BiquadType::ALLPASS, sr, 2000.0, 2.0);
+  for (double f : {100.0, 2000.0, 15000.0}) {
+    REQUIRE(getMagnitude(allpass, sr, f) == Approx(1.0).epsilon(1e-4));
+  }
+
+  auto peaking = simdsp::designBiquad(BiquadType::PEAKING, sr, 3000.0, 1.0, 6.0);
+  REQUIRE(20.0 * log10(getMagnitude(peaking, sr, 3000.0)) == Approx(6.0).epsilon(1e-3));
+
+  auto low_shelf = simdsp::designBiquad(BiquadType::LOW_SHELF, sr, 500.0, 0.707, -6.0);
+  REQUIRE(20.0 * log10(getMagnitude(low_shelf, sr, 0.0)) == Approx(-6.0).epsilon(1e-3));
+
+  auto high_shelf = simdsp::designBiquad(BiquadType::HIGH_SHELF, sr, 5000.0, 0.707, 6.0);
+  REQUIRE(20.0 * log10(getMagnitude(high_shelf, sr, 24000.0)) == Approx(6.0).epsilon(1e-3));
+}
@@ -0,0 +1,87 @@
+#include "simdsp/convolution/convolution_worker.hpp"
+#include "simdsp/convolution/non_uniform_partitioned_convolution.hpp"
+#include "simdsp/denormals.hpp"
+#include "simdsp/mixing/mixing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <float.h>
+#include <math.h>
+#include <random>
+#include <vector>
+
+/*
+ * Through volatile, so that the compiler can't fold it at compile time, where denormals are always kept.
+ */
+static float halve(float x) {
+  volatile float half = 0.5f;
+  return x * half;
+}
+
+TEST_CASE("denormal guards flush and restore", "[denormals]") {
+  // Tests run on threads which don't flush, and this would be meaningless otherwise.
+  REQUIRE(simdsp::areDenormalsFlushed() == false);
+  REQUIRE(halve(FLT_MIN) != 0.0f);
+
+  {
+    simdsp::DenormalGuard guard;
+    REQUIRE(simdsp::areDenormalsFlushed());
+    REQUIRE(halve(FLT_MIN) == 0.0f);
+
+    {
+      simdsp::DenormalGuard inner;
+      REQUIRE(simdsp::areDenormalsFlushed());
+    }
+    // The inner guard puts back the outer one's state, not the thread's original.
+    REQUIRE(simdsp::areDenormalsFlushed());
+  }
+
+  REQUIRE(simdsp::areDenormalsFlushed() == false);
+  REQUIRE(halve(FLT_MIN) != 0.0f);
+}
+
+TEST_CASE("dispatched kernels run flushed under a guard", "[denormals]") {
+  std::vector<float> input(64, FLT_MIN), output(64);
+
+  simdsp::mixGain(input.data(), output.data(), 32, 2, 0.5f, false);
+  for (float x : output) {
+    REQUIRE(x != 0.0f);
+  }
+
+  simdsp::DenormalGuard guard;
+  simdsp::mixGain(input.data(), output.data(), 32, 2, 0.5f, false);
+  for (float x : output) {
+    REQUIRE(x == 0.0f);
+  }
+}
+
+TEST_CASE("worker tasks flush like the thread which submitted them", "[denormals][convolution]") {
+  // Signals whose products are all denormal, so any tail work done unflushed leaves something behind.
+  const unsigned int block_size = 32, impulse_len = 4000, blocks = 200;
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(-1e-20f, 1e-20f);
+  std::vector<float> impulse(impulse_len), input(block_size * blocks);
+  for (auto &x : impulse) {
+    x = dist(rng);
+  }
+  for (auto &x : input) {
+    x = dist(rng);
+  }
+
+  simdsp::ConvolutionWorker worker;
+  simdsp::DenormalGuard guard;
+  simdsp::NonUniformPartitionedConvolver inline_conv(block_size, 1, impulse.data(), impulse_len);
+  simdsp::NonUniformPartitionedConvolver worker_conv(block_size, 1, impulse.data(), impulse_len, 0, &worker);
+  REQUIRE(worker_conv.getLayout().size() > 1);
+
+  std::vector<float> inline_out(block_size), worker_out(block_size);
+  for (unsigned int b = 0; b < blocks; b++) {
+    inline_conv.process(&input[b * block_size], inline_out.data(), simdsp::OutputMode{false});
+    worker_conv.process(&input[b * block_size], worker_out.data(), simdsp::OutputMode{false});
+    for (unsigned int i = 0; i < block_size; i++) {
+      REQUIRE(fpclassify(worker_out[i]) != FP_SUBNORMAL);
+      REQUIRE(worker_out[i] == inline_out[i]);
+    }
+  }
+  REQUIRE(worker_conv.getBackgroundResultCount() > 0);
+}
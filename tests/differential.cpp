@@ -0,0 +1,571 @@
+#include "simdsp/aligned_memory.hpp"
+#include "simdsp/convolution/batch_convolution.hpp"
+#include "simdsp/convolution/generic_block_convolution.hpp"
+#include "simdsp/convolution/tiled_block_convolution.hpp"
+#include "simdsp/convolution/uniform_partitioned_convolution.hpp"
+#include "simdsp/dispatch.hpp"
+#include "simdsp/fft.hpp"
+#include "simdsp/filters/biquad_filter_bank.hpp"
+#include "simdsp/mixing/mixing.hpp"
+#include "simdsp/mixing/sample_format.hpp"
+#include "simdsp/resampling/polyphase_resampler.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <random>
+#include <string.h>
+#include <vector>
+
+/*
+ * Every dispatched kernel, under every variant this machine can run (and SIMDSP_MAX_ISA allows), against a reference
+ * computed in double precision one sample at a time.  Shapes, channel counts, gains and the alignment of every buffer
+ * which doesn't have to be aligned are random, so that each trial lands on a different mix of specialized kernels,
+ * runtime fallbacks, and loop tails.
+ *
+ * Sums are held to the worst case for float accumulation in any order, a small multiple of n * epsilon times the sum
+ * of the magnitudes of the terms.  That holds whatever order a variant adds in, while anything actually wrong is off
+ * by something on the order of the terms themselves.  Transforms and recursive filters get looser, empirical bounds,
+ * and the resampler, whose reference would be a reimplementation of it, is compared against GENERIC instead.
+ */
+
+static const double PI = 3.14159265358979323846;
+static const unsigned int TRIALS = 16;
+
+static std::vector<simdsp::DispatchVariant> getRunnableVariants() {
+  std::vector<simdsp::DispatchVariant> ret;
+  for (auto variant : {simdsp::DispatchVariant::GENERIC, simdsp::DispatchVariant::X86_SSE2,
+                       simdsp::DispatchVariant::X86_AVX, simdsp::DispatchVariant::X86_AVX2,
+                       simdsp::DispatchVariant::X86_AVX512F, simdsp::DispatchVariant::AARCH64_NEON,
+                       simdsp::DispatchVariant::AARCH64_SVE}) {
+    if (simdsp::isDispatchVariantRunnable(variant)) {
+      ret.push_back(variant);
+    }
+  }
+  return ret;
+}
+
+static unsigned int randomInt(std::mt19937 &rng, unsigned int lo, unsigned int hi) {
+  return std::uniform_int_distribution<unsigned int>(lo, hi)(rng);
+}
+
+static float randomFloat(std::mt19937 &rng, float lo, float hi) {
+  return std::uniform_real_distribution<float>(lo, hi)(rng);
+}
+
+static bool randomBool(std::mt19937 &rng) { return randomInt(rng, 0, 1) == 1; }
+
+/*
+ * Channel counts with specialized kernels half the time, anything up to 11 otherwise.
+ */
+static unsigned int randomChannels(std::mt19937 &rng) {
+  static const unsigned int SPECIALIZED[] = {1, 2, 4, 8};
+  return randomBool(rng) ? SPECIALIZED[randomInt(rng, 0, 3)] : randomInt(rng, 1, 11);
+}
+
+/*
+ * Random contents starting a random number of floats past an aligned address, so that kernels see every alignment.
+ */
+static float *makeMisaligned(simdsp::AlignedBuffer<float> &buffer, std::mt19937 &rng, size_t count) {
+  unsigned int offset = randomInt(rng, 0, 15);
+  buffer.resize(count + offset);
+  for (size_t i = 0; i < count + offset; i++) {
+    buffer[i] = randomFloat(rng, -1.0f, 1.0f);
+  }
+  return &buffer[offset];
+}
+
+static simdsp::OutputMode randomOutputMode(std::mt19937 &rng) {
+  simdsp::OutputMode mode;
+  mode.add = randomBool(rng);
+  mode.gain_start = randomFloat(rng, -2.0f, 2.0f);
+  mode.gain_end = randomBool(rng) ? mode.gain_start : randomFloat(rng, -2.0f, 2.0f);
+  return mode;
+}
+
+static double getRampGain(double start, double end, unsigned int i, unsigned int frames) {
+  return start + (end - start) * (double)(i + 1) / (double)frames;
+}
+
+/*
+ * Check one output against its reference: terms is the number of products summed, magnitude the sum of their
+ * magnitudes (after any gain).
+ */
+static void requireWithinSumBound(float actual, double expected, unsigned int terms, double magnitude) {
+  double bound = 4.0 * (terms + 4) * FLT_EPSILON * magnitude + FLT_MIN;
+  INFO("actual " << actual << ", expected " << expected << ", bound " << bound);
+  REQUIRE(fabs((double)actual - expected) <= bound);
+}
+
+/*
+ * genericBlockConvolver and tiledBlockConvolver: the impulse is reversed, and input points at the current frame with
+ * impulse_len - 1 frames of history before it.
+ */
+static void checkDirectConvolution(std::mt19937 &rng, bool tiled) {
+  static const unsigned int SPECIALIZED_TAPS[] = {32, 64, 128, 256};
+  unsigned int channels = randomChannels(rng);
+  unsigned int impulse_len = randomBool(rng) ? SPECIALIZED_TAPS[randomInt(rng, 0, 3)] : randomInt(rng, 1, 300);
+  unsigned int input_len = randomInt(rng, 1, 160);
+  simdsp::OutputMode mode = randomOutputMode(rng);
+  INFO("channels " << channels << ", impulse_len " << impulse_len << ", input_len " << input_len);
+
+  // The impulse has to follow the alignment convention, so only its contents are random.
+  simdsp::AlignedBuffer<float> impulse((size_t)impulse_len * channels), input_buf, output_buf;
+  for (auto &x : impulse) {
+    x = randomFloat(rng, -1.0f, 1.0f);
+  }
+  float *input = makeMisaligned(input_buf, rng, (size_t)(impulse_len - 1 + input_len) * channels);
+  float *output = makeMisaligned(output_buf, rng, (size_t)input_len * channels);
+  std::vector<float> original(output, output + (size_t)input_len * channels);
+
+  float *current = input + (size_t)(impulse_len - 1) * channels;
+  if (tiled) {
+    simdsp::DirectConvolutionTiling tiling{randomInt(rng, 1, 300), randomInt(rng, 1, 64)};
+    simdsp::tiledBlockConvolver(current, input_len, channels, &impulse[0], impulse_len, output,
+                                randomBool(rng) ? &tiling : nullptr, mode);
+  } else {
+    simdsp::genericBlockConvolver(current, input_len, channels, &impulse[0], impulse_len, output, mode);
+  }
+
+  double gain_scale = std::max(fabs(mode.gain_start), fabs(mode.gain_end));
+  for (unsigned int s = 0; s < input_len; s++) {
+    double gain = getRampGain(mode.gain_start, mode.gain_end, s, input_len);
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      double acc = 0.0, magnitude = 0.0;
+      for (unsigned int k = 0; k < impulse_len; k++) {
+        double term = (double)impulse[(size_t)k * channels + ch] * (double)input[(size_t)(s + k) * channels + ch];
+        acc += term;
+        magnitude += fabs(term);
+      }
+      double prior = mode.add ? original[(size_t)s * channels + ch] : 0.0;
+      requireWithinSumBound(output[(size_t)s * channels + ch], prior + acc * gain, impulse_len,
+                            magnitude * gain_scale + fabs(prior));
+    }
+  }
+}
+
+static void checkBatchConvolution(std::mt19937 &rng) {
+  unsigned int job_count = randomInt(rng, 1, 9), channels = randomInt(rng, 1, 3);
+  unsigned int input_len = randomInt(rng, 1, 100), impulse_len = randomInt(rng, 1, 80);
+  INFO("jobs " << job_count << ", channels " << channels << ", input_len " << input_len << ", impulse_len "
+               << impulse_len);
+
+  std::vector<simdsp::AlignedBuffer<float>> inputs(job_count), impulses(job_count), outputs(job_count);
+  std::vector<simdsp::BatchConvolutionJob> jobs(job_count);
+  std::vector<std::vector<float>> originals(job_count);
+  for (unsigned int j = 0; j < job_count; j++) {
+    float *input = makeMisaligned(inputs[j], rng, (size_t)(impulse_len - 1 + input_len) * channels);
+    jobs[j].input = input + (size_t)(impulse_len - 1) * channels;
+    jobs[j].impulse = makeMisaligned(impulses[j], rng, (size_t)impulse_len * channels);
+    jobs[j].output = makeMisaligned(outputs[j], rng, (size_t)input_len * channels);
+    jobs[j].mode = randomOutputMode(rng);
+    originals[j].assign(jobs[j].output, jobs[j].output + (size_t)input_len * channels);
+  }
+
+  std::vector<float> workspace(simdsp::getBatchBlockConvolverWorkspaceSize(input_len, impulse_len));
+  simdsp::batchBlockConvolver(&jobs[0], job_count, channels, input_len, impulse_len, workspace.data());
+
+  for (unsigned int j = 0; j < job_count; j++) {
+    const simdsp::OutputMode &mode = jobs[j].mode;
+    const float *input = jobs[j].input - (size_t)(impulse_len - 1) * channels;
+    double gain_scale = std::max(fabs(mode.gain_start), fabs(mode.gain_end));
+    for (unsigned int s = 0; s < input_len; s++) {
+      double gain = getRampGain(mode.gain_start, mode.gain_end, s, input_len);
+      for (unsigned int ch = 0; ch < channels; ch++) {
+        double acc = 0.0, magnitude = 0.0;
+        for (unsigned int k = 0; k < impulse_len; k++) {
+          double term =
+              (double)jobs[j].impulse[(size_t)k * channels + ch] * (double)input[(size_t)(s + k) * channels + ch];
+          acc += term;
+          magnitude += fabs(term);
+        }
+        double prior = mode.add ? originals[j][(size_t)s * channels + ch] : 0.0;
+        requireWithinSumBound(jobs[j].output[(size_t)s * channels + ch], prior + acc * gain, impulse_len,
+                              magnitude * gain_scale + fabs(prior));
+      }
+    }
+  }
+}
+
+/*
+ * The frequency-domain kernels (complex multiplies and the FFT passes), through the convolver which uses them.  FFT
+ * error is spread over the whole block, so it is bounded by the energy of the signal and impulse rather than by the
+ * terms of each output.
+ */
+static void checkUniformPartitionedConvolution(std::mt19937 &rng) {
+  static const unsigned int BLOCK_SIZES[] = {16, 30, 64, 96, 128};
+  unsigned int block_size = BLOCK_SIZES[randomInt(rng, 0, 4)], channels = randomInt(rng, 1, 4);
+  unsigned int impulse_len = randomInt(rng, 1, 700), blocks = 4;
+  INFO("block_size " << block_size << ", channels " << channels << ", impulse_len " << impulse_len);
+
+  simdsp::AlignedBuffer<float> impulse_buf, input_buf, output_buf;
+  float *impulse = makeMisaligned(impulse_buf, rng, (size_t)impulse_len * channels);
+  float *input = makeMisaligned(input_buf, rng, (size_t)block_size * blocks * channels);
+  float *output = makeMisaligned(output_buf, rng, (size_t)block_size * blocks * channels);
+
+  simdsp::UniformPartitionedConvolver convolver(block_size, channels, impulse, impulse_len);
+  for (unsigned int b = 0; b < blocks; b++) {
+    size_t at = (size_t)b * block_size * channels;
+    convolver.process(input + at, output + at, simdsp::OutputMode{false});
+  }
+
+  double fft_log = log2(2.0 * block_size);
+  for (unsigned int ch = 0; ch < channels; ch++) {
+    double impulse_energy = 0.0, input_energy = 0.0;
+    for (unsigned int k = 0; k < impulse_len; k++) {
+      impulse_energy += (double)impulse[(size_t)k * channels + ch] * impulse[(size_t)k * channels + ch];
+    }
+    for (unsigned int s = 0; s < block_size * blocks; s++) {
+      input_energy += (double)input[(size_t)s * channels + ch] * input[(size_t)s * channels + ch];
+    }
+    double bound = 8.0 * fft_log * FLT_EPSILON * sqrt(impulse_energy * input_energy);
+
+    for (unsigned int s = 0; s < block_size * blocks; s++) {
+      double expected = 0.0;
+      for (unsigned int k = 0; k < impulse_len && k <= s; k++) {
+        expected += (double)impulse[(size_t)k * channels + ch] * (double)input[(size_t)(s - k) * channels + ch];
+      }
+      INFO("frame " << s << ", channel " << ch);
+      REQUIRE(fabs((double)output[(size_t)s * channels + ch] - expected) <= bound);
+    }
+  }
+}
+
+static void checkRealFft(std::mt19937 &rng) {
+  unsigned int size = simdsp::getNextRealFftSize(randomInt(rng, 2, 2048));
+  auto algorithm = randomBool(rng) ? simdsp::FftAlgorithm::IN_CACHE : simdsp::FftAlgorithm::SIX_STEP;
+  INFO("size " << size << ", six step " << (algorithm == simdsp::FftAlgorithm::SIX_STEP));
+
+  simdsp::RealFft fft(size, algorithm);
+  unsigned int bins = fft.getBinCount();
+  std::vector<float> input(size), re(bins), im(bins), back(size), workspace(fft.getWorkspaceSize());
+  for (auto &x : input) {
+    x = randomFloat(rng, -1.0f, 1.0f);
+  }
+  double input_magnitude = 0.0;
+  for (float x : input) {
+    input_magnitude += fabs(x);
+  }
+
+  fft.forward(input.data(), re.data(), im.data(), workspace.data());
+  double bound = 4.0 * log2((double)size) * FLT_EPSILON * input_magnitude;
+  for (unsigned int k = 0; k < bins; k++) {
+    double expected_re = 0.0, expected_im = 0.0;
+    for (unsigned int t = 0; t < size; t++) {
+      double angle = -2.0 * PI * (double)((unsigned long long)k * t % size) / size;
+      expected_re += input[t] * cos(angle);
+      expected_im += input[t] * sin(angle);
+    }
+    INFO("bin " << k);
+    REQUIRE(fabs(re[k] - expected_re) <= bound);
+    REQUIRE(fabs(im[k] - expected_im) <= bound);
+  }
+
+  // The inverse, from a random spectrum rather than the forward's, so that its errors don't cancel.
+  for (unsigned int k = 0; k < bins; k++) {
+    re[k] = randomFloat(rng, -1.0f, 1.0f);
+    im[k] = k == 0 || k == bins - 1 ? 0.0f : randomFloat(rng, -1.0f, 1.0f);
+  }
+  double spectrum_magnitude = 0.0;
+  for (unsigned int k = 0; k < bins; k++) {
+    spectrum_magnitude += 2.0 * (fabs(re[k]) + fabs(im[k]));
+  }
+  fft.inverse(re.data(), im.data(), back.data(), workspace.data());
+  bound = 4.0 * log2((double)size) * FLT_EPSILON * spectrum_magnitude;
+  for (unsigned int t = 0; t < size; t++) {
+    double expected = 0.0;
+    for (unsigned int k = 0; k < bins; k++) {
+      double angle = 2.0 * PI * (double)((unsigned long long)k * t % size) / size;
+      double weight = k == 0 || k == bins - 1 ? 1.0 : 2.0;
+      expected += weight * (re[k] * cos(angle) - im[k] * sin(angle));
+    }
+    INFO("sample " << t);
+    REQUIRE(fabs(back[t] - expected) <= bound);
+  }
+}
+
+static void checkMixing(std::mt19937 &rng) {
+  unsigned int frames = randomInt(rng, 1, 300), channels = randomChannels(rng);
+  unsigned int out_channels = randomChannels(rng);
+  bool add = randomBool(rng);
+  float gain_start = randomFloat(rng, -2.0f, 2.0f), gain_end = randomFloat(rng, -2.0f, 2.0f);
+  INFO("frames " << frames << ", channels " << channels << " -> " << out_channels << ", add " << add);
+
+  simdsp::AlignedBuffer<float> input_buf, output_buf, matrix_buf, to_matrix_buf;
+  float *input = makeMisaligned(input_buf, rng, (size_t)frames * channels);
+  float *output = makeMisaligned(output_buf, rng, (size_t)frames * std::max(channels, out_channels));
+  std::vector<float> original(output, output + (size_t)frames * std::max(channels, out_channels));
+  auto restore = [&]() { std::copy(original.begin(), original.end(), output); };
+
+  {
+    simdsp::mixGain(input, output, frames, channels, gain_start, add);
+    for (size_t i = 0; i < (size_t)frames * channels; i++) {
+      double prior = add ? original[i] : 0.0, term = (double)input[i] * gain_start;
+      requireWithinSumBound(output[i], prior + term, 1, fabs(prior) + fabs(term));
+    }
+    restore();
+  }
+
+  {
+    simdsp::mixGainRamp(input, output, frames, channels, gain_start, gain_end, add);
+    double gain_scale = std::max(fabs(gain_start), fabs(gain_end));
+    for (unsigned int f = 0; f < frames; f++) {
+      double gain = getRampGain(gain_start, gain_end, f, frames);
+      for (unsigned int ch = 0; ch < channels; ch++) {
+        size_t i = (size_t)f * channels + ch;
+        double prior = add ? original[i] : 0.0;
+        requireWithinSumBound(output[i], prior + input[i] * gain, 1, fabs(prior) + fabs(input[i]) * gain_scale);
+      }
+    }
+    restore();
+  }
+
+  const float *from_matrix = makeMisaligned(matrix_buf, rng, (size_t)channels * out_channels);
+  const float *to_matrix = makeMisaligned(to_matrix_buf, rng, (size_t)channels * out_channels);
+  for (bool ramp : {false, true}) {
+    if (ramp) {
+      simdsp::mixMatrixRamp(input, channels, output, out_channels, frames, from_matrix, to_matrix, add);
+    } else {
+      simdsp::mixMatrix(input, channels, output, out_channels, frames, from_matrix, add);
+    }
+
+    for (unsigned int f = 0; f < frames; f++) {
+      for (unsigned int o = 0; o < out_channels; o++) {
+        size_t at = (size_t)f * out_channels + o;
+        double acc = add ? original[at] : 0.0, magnitude = fabs(acc);
+        for (unsigned int c = 0; c < channels; c++) {
+          double from = from_matrix[(size_t)o * channels + c], to = to_matrix[(size_t)o * channels + c];
+          double coefficient = ramp ? getRampGain(from, to, f, frames) : from;
+          double term = coefficient * input[(size_t)f * channels + c];
+          acc += term;
+          magnitude += std::max(fabs(from), ramp ? fabs(to) : 0.0) * fabs(input[(size_t)f * channels + c]);
+        }
+        requireWithinSumBound(output[at], acc, channels, magnitude);
+      }
+    }
+    restore();
+  }
+
+  // Layout conversions are exact.
+  std::vector<simdsp::AlignedBuffer<float>> planar_bufs(channels);
+  std::vector<float *> planar(channels);
+  for (unsigned int c = 0; c < channels; c++) {
+    planar[c] = makeMisaligned(planar_bufs[c], rng, frames);
+  }
+  simdsp::interleaveChannels(planar.data(), channels, frames, output);
+  for (unsigned int f = 0; f < frames; f++) {
+    for (unsigned int c = 0; c < channels; c++) {
+      REQUIRE(output[(size_t)f * channels + c] == planar[c][f]);
+    }
+  }
+  simdsp::deinterleaveChannels(input, channels, frames, planar.data());
+  for (unsigned int f = 0; f < frames; f++) {
+    for (unsigned int c = 0; c < channels; c++) {
+      REQUIRE(planar[c][f] == input[(size_t)f * channels + c]);
+    }
+  }
+}
+
+static int64_t quantizeReference(float value, unsigned int bits) {
+  double scale = ldexp(1.0, bits - 1);
+  double scaled = (double)value * scale;
+  double rounded = scaled < 0.0 ? ceil(scaled - 0.5) : floor(scaled + 0.5);
+  return (int64_t)fmin(fmax(rounded, -scale), scale - 1.0);
+}
+
+static int64_t readSample(const unsigned char *bytes, simdsp::SampleFormat format, size_t index) {
+  switch (format) {
+  case simdsp::SampleFormat::INT16: {
+    int16_t ret;
+    memcpy(&ret, bytes + index * 2, 2);
+    return ret;
+  }
+  case simdsp::SampleFormat::INT24_PACKED: {
+    int32_t ret = bytes[index * 3] | (bytes[index * 3 + 1] << 8) | (bytes[index * 3 + 2] << 16);
+    return ret >= (1 << 23) ? ret - (1 << 24) : ret;
+  }
+  case simdsp::SampleFormat::INT32: {
+    int32_t ret;
+    memcpy(&ret, bytes + index * 4, 4);
+    return ret;
+  }
+  }
+  return 0;
+}
+
+/*
+ * Without dither, conversion both ways is exact, except that INT32 is scaled in float and so may round ties the other
+ * way.  Inputs stay inside full scale, since INT32 clamps slightly short of it (see simdsp/mixing/sample_format.hpp).
+ */
+static void checkSampleFormats(std::mt19937 &rng) {
+  static const simdsp::SampleFormat FORMATS[] = {simdsp::SampleFormat::INT16, simdsp::SampleFormat::INT24_PACKED,
+                                                 simdsp::SampleFormat::INT32};
+  simdsp::SampleFormat format = FORMATS[randomInt(rng, 0, 2)];
+  unsigned int frames = randomInt(rng, 1, 600), channels = randomChannels(rng);
+  unsigned int bytes = simdsp::getSampleFormatBytes(format), bits = bytes * 8;
+  size_t samples = (size_t)frames * channels;
+  INFO("bytes " << bytes << ", frames " << frames << ", channels " << channels);
+
+  std::vector<simdsp::AlignedBuffer<float>> planar_bufs(channels);
+  std::vector<float *> planar(channels);
+  for (unsigned int c = 0; c < channels; c++) {
+    planar[c] = makeMisaligned(planar_bufs[c], rng, frames);
+    for (unsigned int f = 0; f < frames; f++) {
+      planar[c][f] *= 0.999f;
+    }
+  }
+  std::vector<unsigned char> encoded(samples * bytes + 8);
+  unsigned char *out = &encoded[randomInt(rng, 0, 7)];
+
+  simdsp::interleaveFloatToSamples(planar.data(), channels, frames, format, out);
+  for (unsigned int f = 0; f < frames; f++) {
+    for (unsigned int c = 0; c < channels; c++) {
+      int64_t expected = quantizeReference(planar[c][f], bits);
+      REQUIRE(llabs(readSample(out, format, (size_t)f * channels + c) - expected) <= (bits == 32 ? 1 : 0));
+    }
+  }
+
+  simdsp::AlignedBuffer<float> flat_buf;
+  float *flat = makeMisaligned(flat_buf, rng, samples);
+  simdsp::convertSamplesToFloat(out, (unsigned int)samples, format, flat);
+  for (size_t i = 0; i < samples; i++) {
+    REQUIRE((double)flat[i] == ldexp((double)readSample(out, format, i), -(int)(bits - 1)));
+  }
+
+  simdsp::convertFloatToSamples(flat, (unsigned int)samples, format, out);
+  simdsp::deinterleaveSamplesToFloat(out, channels, frames, format, planar.data());
+  for (unsigned int f = 0; f < frames; f++) {
+    for (unsigned int c = 0; c < channels; c++) {
+      REQUIRE(planar[c][f] == flat[(size_t)f * channels + c]);
+    }
+  }
+}
+
+/*
+ * Transposed direct form II, which is what the bank runs, from the coefficients it actually has.  The recursion
+ * amplifies rounding by up to the noise gain of the filter, so the bound is relative to the peak output.
+ */
+static void checkBiquadFilterBank(std::mt19937 &rng) {
+  static const simdsp::BiquadType TYPES[] = {simdsp::BiquadType::LOWPASS,  simdsp::BiquadType::HIGHPASS,
+                                             simdsp::BiquadType::BANDPASS, simdsp::BiquadType::PEAKING,
+                                             simdsp::BiquadType::LOW_SHELF};
+  unsigned int lanes = randomInt(rng, 1, 13), sections = randomInt(rng, 1, 3);
+  INFO("lanes " << lanes << ", sections " << sections);
+
+  simdsp::BiquadFilterBank bank(lanes, sections);
+  for (unsigned int lane = 0; lane < lanes; lane++) {
+    for (unsigned int s = 0; s < sections; s++) {
+      simdsp::BiquadType type = TYPES[randomInt(rng, 0, 4)];
+      float frequency = randomFloat(rng, 200.0f, 15000.0f), q = randomFloat(rng, 0.5f, 2.0f);
+      float gain_db = randomFloat(rng, -12.0f, 12.0f);
+      bank.setCoefficients(lane, s, simdsp::designBiquad(type, 48000.0, frequency, q, gain_db), false);
+    }
+  }
+
+  std::vector<double> state((size_t)lanes * sections * 2, 0.0);
+  std::vector<double> peak(lanes, 0.0);
+  // Two blocks, so that state carried between calls is checked too.
+  for (unsigned int block = 0; block < 2; block++) {
+    unsigned int frames = randomInt(rng, 1, 200);
+    simdsp::AlignedBuffer<float> input_buf, output_buf;
+    float *input = makeMisaligned(input_buf, rng, (size_t)frames * lanes);
+    float *output = makeMisaligned(output_buf, rng, (size_t)frames * lanes);
+    bank.process(input, output, frames);
+
+    std::vector<double> expected((size_t)frames * lanes);
+    for (unsigned int lane = 0; lane < lanes; lane++) {
+      for (unsigned int f = 0; f < frames; f++) {
+        double x = input[(size_t)f * lanes + lane];
+        for (unsigned int s = 0; s < sections; s++) {
+          simdsp::BiquadCoefficients c = bank.getCoefficients(lane, s);
+          double *z = &state[((size_t)lane * sections + s) * 2];
+          double y = c.b0 * x + z[0];
+          z[0] = c.b1 * x - c.a1 * y + z[1];
+          z[1] = c.b2 * x - c.a2 * y;
+          x = y;
+        }
+        expected[(size_t)f * lanes + lane] = x;
+        peak[lane] = std::max(peak[lane], fabs(x));
+      }
+    }
+
+    for (unsigned int f = 0; f < frames; f++) {
+      for (unsigned int lane = 0; lane < lanes; lane++) {
+        INFO("block " << block << ", frame " << f << ", lane " << lane);
+        REQUIRE(fabs(output[(size_t)f * lanes + lane] - expected[(size_t)f * lanes + lane]) <=
+                1e-4 * (peak[lane] + 1.0));
+      }
+    }
+  }
+}
+
+/*
+ * Run the resampler over a random signal in random calls, which have to be the same for every variant.
+ */
+static std::vector<float> runResampler(unsigned int seed) {
+  std::mt19937 rng(seed);
+  static const unsigned int RATES[] = {22050, 44100, 48000, 96000};
+  unsigned int channels = randomInt(rng, 1, 5), input_rate = RATES[randomInt(rng, 0, 3)];
+  unsigned int output_rate = RATES[randomInt(rng, 0, 3)];
+  auto quality = randomBool(rng) ? simdsp::ResamplerQuality::MEDIUM : simdsp::ResamplerQuality::HIGH;
+
+  simdsp::PolyphaseResampler resampler(channels, input_rate, output_rate, quality);
+  std::vector<float> ret;
+  for (unsigned int call = 0; call < 6; call++) {
+    unsigned int frames = randomInt(rng, 1, 400);
+    std::vector<float> input((size_t)frames * channels);
+    std::vector<float> output((size_t)resampler.getMaxOutputFrames(frames) * channels);
+    for (auto &x : input) {
+      x = randomFloat(rng, -1.0f, 1.0f);
+    }
+    unsigned int produced = resampler.process(input.data(), frames, output.data());
+    ret.insert(ret.end(), output.begin(), output.begin() + (size_t)produced * channels);
+  }
+  return ret;
+}
+
+TEST_CASE("every variant matches the double precision references", "[differential]") {
+  for (auto variant : getRunnableVariants()) {
+    REQUIRE(simdsp::forceDispatchVariant(variant));
+    std::mt19937 rng(1234);
+
+    for (unsigned int trial = 0; trial < TRIALS; trial++) {
+      INFO("variant " << simdsp::dispatchVariantToString(variant) << ", trial " << trial);
+      checkDirectConvolution(rng, false);
+      checkDirectConvolution(rng, true);
+      checkBatchConvolution(rng);
+      checkUniformPartitionedConvolution(rng);
+      checkRealFft(rng);
+      checkMixing(rng);
+      checkSampleFormats(rng);
+      checkBiquadFilterBank(rng);
+    }
+  }
+  simdsp::resetDispatchVariant();
+}
+
+TEST_CASE("every variant of the resampler matches generic", "[differential]") {
+  // GENERIC, except in static builds, where the one variant is compared against itself.
+  auto reference = getRunnableVariants().front();
+  for (unsigned int trial = 0; trial < TRIALS; trial++) {
+    REQUIRE(simdsp::forceDispatchVariant(reference));
+    std::vector<float> expected = runResampler(trial);
+    float peak = 0.0f;
+    for (float x : expected) {
+      peak = std::max(peak, fabsf(x));
+    }
+
+    for (auto variant : getRunnableVariants()) {
+      INFO("variant " << simdsp::dispatchVariantToString(variant) << ", trial " << trial);
+      REQUIRE(simdsp::forceDispatchVariant(variant));
+      std::vector<float> actual = runResampler(trial);
+      REQUIRE(actual.size() == expected.size());
+      for (size_t i = 0; i < actual.size(); i++) {
+        REQUIRE(fabsf(actual[i] - expected[i]) <= 1e-5f * (peak + 1.0f));
+      }
+    }
+  }
+  simdsp::resetDispatchVariant();
+}
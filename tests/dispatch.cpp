@@ -0,0 +1,148 @@
+#include "simdsp/convolution/generic_block_convolution.hpp"
+#include "simdsp/dispatch.hpp"
+#include "simdsp/feature_macros.hpp"
+#include "simdsp/system_info.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string.h>
+
+/*
+ * The variant which is always there: GENERIC, except in static builds, which have only the one the compiler targets.
+ */
+#if SIMDSP_STATIC_DISPATCH
+static const simdsp::DispatchVariant ALWAYS_COMPILED = simdsp::DispatchVariant::SIMDSP_BASELINE_VARIANT;
+#else
+static const simdsp::DispatchVariant ALWAYS_COMPILED = simdsp::DispatchVariant::GENERIC;
+#endif
+
+TEST_CASE("the selected dispatch variant is compiled in", "[dispatch]") {
+  auto variant = simdsp::getDispatchVariant();
+
+  REQUIRE(simdsp::isDispatchVariantCompiled(variant));
+  REQUIRE(simdsp::isDispatchVariantCompiled(ALWAYS_COMPILED));
+  REQUIRE(strcmp(simdsp::dispatchVariantToString(variant), "unknown") != 0);
+  // Resolution happens once.
+  REQUIRE(simdsp::getDispatchVariant() == variant);
+}
+
+TEST_CASE("genericBlockConvolver convolves through the dispatch table", "[dispatch][convolution]") {
+  const unsigned int channels = 2, impulse_len = 4, block = 8;
+  // impulse_len - 1 frames of history, then the block.
+  float input[(impulse_len - 1 + block) * channels];
+  float impulse[impulse_len * channels];
+  float output[block * channels] = {0.0f};
+
+  for (unsigned int i = 0; i < sizeof(input) / sizeof(input[0]); i++) {
+    input[i] = (float)(i % 7) - 3.0f;
+  }
+
+  // Reversed impulse: h[j] lives at impulse[(impulse_len - 1 - j) * channels].
+  for (unsigned int j = 0; j < impulse_len; j++) {
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      impulse[(impulse_len - 1 - j) * channels + ch] = (float)(j + 1) * (ch == 0 ? 1.0f : -0.5f);
+    }
+  }
+
+  float *cur = input + (impulse_len - 1) * channels;
+  simdsp::genericBlockConvolver(cur, block, channels, impulse, impulse_len, output);
+
+  for (unsigned int s = 0; s < block; s++) {
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      float expected = 0.0f;
+      for (unsigned int j = 0; j < impulse_len; j++) {
+        expected += cur[((int)s - (int)j) * (int)channels + (int)ch] * (float)(j + 1) * (ch == 0 ? 1.0f : -0.5f);
+      }
+      REQUIRE(output[s * channels + ch] == Approx(expected));
+    }
+  }
+}
+
+TEST_CASE("every runnable variant can be forced and the automatic choice restored", "[dispatch]") {
+  auto automatic = simdsp::getDispatchVariant();
+  REQUIRE(simdsp::isDispatchVariantRunnable(automatic));
+  REQUIRE(simdsp::isDispatchVariantRunnable(ALWAYS_COMPILED));
+
+  for (auto variant : {simdsp::DispatchVariant::GENERIC, simdsp::DispatchVariant::X86_SSE2,
+                       simdsp::DispatchVariant::X86_AVX, simdsp::DispatchVariant::X86_AVX2,
+                       simdsp::DispatchVariant::X86_AVX512F, simdsp::DispatchVariant::AARCH64_NEON,
+                       simdsp::DispatchVariant::AARCH64_SVE}) {
+    bool runnable = simdsp::isDispatchVariantRunnable(variant);
+    REQUIRE(simdsp::forceDispatchVariant(variant) == runnable);
+    if (runnable) {
+      REQUIRE(simdsp::getDispatchVariant() == variant);
+    }
+  }
+
+  simdsp::resetDispatchVariant();
+  REQUIRE(simdsp::getDispatchVariant() == automatic);
+}
+
+TEST_CASE("variant names parse with or without the architecture", "[dispatch]") {
+  simdsp::DispatchVariant variant;
+
+  REQUIRE(simdsp::parseDispatchVariant("generic", &variant));
+  REQUIRE(variant == simdsp::DispatchVariant::GENERIC);
+  REQUIRE(simdsp::parseDispatchVariant("x86_avx2", &variant));
+  REQUIRE(variant == simdsp::DispatchVariant::X86_AVX2);
+  REQUIRE(simdsp::parseDispatchVariant("AVX512F", &variant));
+  REQUIRE(variant == simdsp::DispatchVariant::X86_AVX512F);
+  REQUIRE(simdsp::parseDispatchVariant("neon", &variant));
+  REQUIRE(variant == simdsp::DispatchVariant::AARCH64_NEON);
+  REQUIRE(simdsp::parseDispatchVariant("avx3", &variant) == false);
+  REQUIRE(simdsp::parseDispatchVariant("", &variant) == false);
+}
+
+#if SIMDSP_STATIC_DISPATCH
+
+TEST_CASE("static builds only have the variant the compiler targets", "[dispatch]") {
+  REQUIRE(simdsp::getDispatchVariant() == ALWAYS_COMPILED);
+  for (auto variant : {simdsp::DispatchVariant::GENERIC, simdsp::DispatchVariant::X86_SSE2,
+                       simdsp::DispatchVariant::X86_AVX, simdsp::DispatchVariant::X86_AVX2,
+                       simdsp::DispatchVariant::X86_AVX512F, simdsp::DispatchVariant::AARCH64_NEON,
+                       simdsp::DispatchVariant::AARCH64_SVE}) {
+    REQUIRE(simdsp::isDispatchVariantCompiled(variant) == (variant == ALWAYS_COMPILED));
+  }
+
+  // Nothing can move it.
+  simdsp::setMaxDispatchVariant(simdsp::DispatchVariant::GENERIC);
+  REQUIRE(simdsp::getDispatchVariant() == ALWAYS_COMPILED);
+  simdsp::resetMaxDispatchVariant();
+  REQUIRE(simdsp::getDispatchVariant() == ALWAYS_COMPILED);
+}
+
+#else
+
+TEST_CASE("capping the variant rules out everything wider", "[dispatch]") {
+  auto automatic = simdsp::getDispatchVariant();
+  bool have_sse2 = simdsp::isDispatchVariantRunnable(simdsp::DispatchVariant::X86_SSE2);
+
+  simdsp::setMaxDispatchVariant(simdsp::DispatchVariant::GENERIC);
+  REQUIRE(simdsp::getDispatchVariant() == simdsp::DispatchVariant::GENERIC);
+  simdsp::DispatchVariant cap;
+  REQUIRE(simdsp::getMaxDispatchVariant(&cap));
+  REQUIRE(cap == simdsp::DispatchVariant::GENERIC);
+  REQUIRE(simdsp::isDispatchVariantRunnable(simdsp::DispatchVariant::GENERIC));
+  if (automatic != simdsp::DispatchVariant::GENERIC) {
+    REQUIRE(simdsp::isDispatchVariantRunnable(automatic) == false);
+    REQUIRE(simdsp::forceDispatchVariant(automatic) == false);
+  }
+
+  // Capping at a runnable variant picks exactly it, and leaves what's below it alone.
+  if (have_sse2) {
+    simdsp::setMaxDispatchVariant(simdsp::DispatchVariant::X86_SSE2);
+    REQUIRE(simdsp::getDispatchVariant() == simdsp::DispatchVariant::X86_SSE2);
+    REQUIRE(simdsp::isDispatchVariantRunnable(simdsp::DispatchVariant::X86_AVX) == false);
+    REQUIRE(simdsp::forceDispatchVariant(simdsp::DispatchVariant::GENERIC));
+  }
+
+  // A cap for another architecture leaves only GENERIC.
+  bool is_x86 = simdsp::getSystemInfo().cpu_architecture == simdsp::CpuArchitecture::X86;
+  simdsp::setMaxDispatchVariant(is_x86 ? simdsp::DispatchVariant::AARCH64_SVE : simdsp::DispatchVariant::X86_AVX512F);
+  REQUIRE(simdsp::getDispatchVariant() == simdsp::DispatchVariant::GENERIC);
+
+  simdsp::resetMaxDispatchVariant();
+  REQUIRE(simdsp::getDispatchVariant() == automatic);
+}
+
+#endif
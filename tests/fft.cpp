@@ -0,0 +1,76 @@
+#include "test_common.hpp"
+
+#include "simdsp/fft.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <math.h>
+#include <vector>
+
+/*
+ * Compare against a double precision DFT, then check that the inverse gets back to the input.
+ */
+static void checkRealFft(unsigned int size, simdsp::FftAlgorithm algorithm) {
+  const double pi = 3.14159265358979323846;
+  simdsp::RealFft fft(size, algorithm);
+  unsigned int bins = fft.getBinCount();
+
+  std::vector<float> input = makeNoise(size, size);
+  std::vector<float> out_re(bins), out_im(bins), back(size), workspace(fft.getWorkspaceSize());
+
+  fft.forward(&input[0], &out_re[0], &out_im[0], &workspace[0]);
+
+  double max_err = 0.0;
+  for (unsigned int k = 0; k < bins; k++) {
+    double re = 0.0, im = 0.0;
+    for (unsigned int j = 0; j < size; j++) {
+      double angle = -2.0 * pi * (double)((unsigned long long)j * k % size) / (double)size;
+      re += input[j] * cos(angle);
+      im += input[j] * sin(angle);
+    }
+    max_err = fmax(max_err, fabs(re - out_re[k]));
+    max_err = fmax(max_err, fabs(im - out_im[k]));
+  }
+  // Noise in [-1, 1] gives bins of magnitude around sqrt(size).
+  REQUIRE(max_err < 1e-5 * size);
+
+  fft.inverse(&out_re[0], &out_im[0], &back[0], &workspace[0]);
+  for (unsigned int j = 0; j < size; j++) {
+    REQUIRE(back[j] / (float)size == Approx(input[j]).margin(1e-5));
+  }
+}
+
+TEST_CASE("real FFT sizes", "[fft]") {
+  REQUIRE(simdsp::isRealFftSizeSupported(2));
+  REQUIRE(simdsp::isRealFftSizeSupported(1024));
+  REQUIRE(simdsp::isRealFftSizeSupported(2 * 3 * 5 * 25));
+  REQUIRE_FALSE(simdsp::isRealFftSizeSupported(0));
+  REQUIRE_FALSE(simdsp::isRealFftSizeSupported(15));
+  REQUIRE_FALSE(simdsp::isRealFftSizeSupported(2 * 7));
+
+  REQUIRE(simdsp::getNextRealFftSize(0) == 2);
+  REQUIRE(simdsp::getNextRealFftSize(13) == 16);
+  REQUIRE(simdsp::getNextRealFftSize(1000) == 1000);
+  REQUIRE(simdsp::getNextRealFftSize(1001) == 1024);
+}
+
+TEST_CASE("real FFT matches a DFT", "[fft]") {
+  for (unsigned int size : {2u, 4u, 6u, 8u, 10u, 16u, 30u, 64u, 90u, 128u, 250u, 256u, 1024u, 2048u, 2400u}) {
+    DYNAMIC_SECTION("in cache, size " << size) { checkRealFft(size, simdsp::FftAlgorithm::IN_CACHE); }
+  }
+}
+
+TEST_CASE("six-step real FFT matches a DFT", "[fft]") {
+  for (unsigned int size : {2u, 10u, 64u, 96u, 512u, 1250u, 4096u}) {
+    DYNAMIC_SECTION("six step, size " << size) { checkRealFft(size, simdsp::FftAlgorithm::SIX_STEP); }
+  }
+}
+
+TEST_CASE("getRealFft shares plans", "[fft]") {
+  auto a = simdsp::getRealFft(512), b = simdsp::getRealFft(512), c = simdsp::getRealFft(1024);
+
+  REQUIRE(a == b);
+  REQUIRE(a != c);
+  REQUIRE(a->getSize() == 512);
+  REQUIRE(a->getAlgorithm() != simdsp::FftAlgorithm::AUTOMATIC);
+}
@@ -0,0 +1,72 @@
+#include "test_common.hpp"
+
+#include "simdsp/convolution/generic_block_convolution.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <math.h>
+#include <string>
+#include <vector>
+
+/*
+ * genericBlockConvolver picks a kernel by shape, so go over every specialized channel count and impulse length, and
+ * shapes either side of them which must fall back.
+ */
+static void checkShape(unsigned int channels, unsigned int impulse_len, unsigned int input_len,
+                       const simdsp::OutputMode &mode = simdsp::OutputMode()) {
+  unsigned int seed = channels * 31 + impulse_len * 7 + input_len;
+  std::vector<float> input = makeNoise((impulse_len - 1 + input_len) * channels, seed);
+  std::vector<float> impulse = makeNoise(impulse_len * channels, seed + 1);
+  std::vector<float> output(input_len * channels, 0.25f);
+
+  float *cur = &input[(impulse_len - 1) * channels];
+  simdsp::genericBlockConvolver(cur, input_len, channels, &impulse[0], impulse_len, &output[0], mode);
+
+  double max_err = 0.0;
+  for (unsigned int frame = 0; frame < input_len; frame++) {
+    double gain = mode.gain_start + ((double)mode.gain_end - mode.gain_start) * (frame + 1) / input_len;
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      // impulse is reversed: tap j of the natural impulse multiplies the frame j back.
+      double sum = 0.0;
+      for (unsigned int j = 0; j < impulse_len; j++) {
+        sum += (double)cur[((int)frame - (int)j) * (int)channels + (int)ch] *
+               (double)impulse[(impulse_len - 1 - j) * channels + ch];
+      }
+      double expected = (mode.add ? 0.25 : 0.0) + sum * gain;
+      max_err = fmax(max_err, fabs(expected - (double)output[frame * channels + ch]));
+    }
+  }
+
+  REQUIRE(max_err < 1e-5 * sqrt((double)impulse_len) + 1e-6);
+}
+
+TEST_CASE("genericBlockConvolver is correct for specialized and fallback shapes", "[convolution]") {
+  for (unsigned int channels : {1u, 2u, 3u, 4u, 8u}) {
+    for (unsigned int impulse_len : {1u, 7u, 32u, 64u, 100u, 128u, 256u, 257u}) {
+      SECTION("channels " + std::to_string(channels) + ", impulse_len " + std::to_string(impulse_len)) {
+        checkShape(channels, impulse_len, 1);
+        checkShape(channels, impulse_len, 67);
+      }
+    }
+  }
+}
+
+TEST_CASE("genericBlockConvolver output modes", "[convolution]") {
+  const simdsp::OutputMode modes[] = {
+      {false, 1.0f, 1.0f},
+      {true, 0.5f, 0.5f},
+      {false, -2.0f, -2.0f},
+      {true, 0.0f, 1.0f},
+      {false, 1.5f, 0.25f},
+  };
+
+  for (const auto &mode : modes) {
+    for (unsigned int channels : {1u, 2u, 3u, 8u}) {
+      // Specialized, runtime with a tail, and too short for a whole group of taps.
+      for (unsigned int impulse_len : {3u, 64u, 100u}) {
+        checkShape(channels, impulse_len, 1, mode);
+        checkShape(channels, impulse_len, 67, mode);
+      }
+    }
+  }
+}
@@ -0,0 +1,146 @@
+#include "test_common.hpp"
+
+#include "simdsp/aligned_memory.hpp"
+#include "simdsp/convolution/impulse_spectra.hpp"
+#include "simdsp/convolution/uniform_partitioned_convolution.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static std::string getSpectraTestPath(const char *name) {
+  return std::string(P_tmpdir) + "/simdsp_impulse_spectra_test_" + name;
+}
+
+TEST_CASE("impulse spectra files drive the uniform convolver without copies", "[convolution][fft]") {
+  const unsigned int block_size = 32, channels = 2, blocks = 30;
+  std::string path = getSpectraTestPath("roundtrip");
+
+  std::vector<unsigned int> lens = {1, 32, 100, 700};
+  std::vector<std::vector<float>> impulses;
+  std::vector<const float *> impulse_ptrs;
+  for (unsigned int i = 0; i < lens.size(); i++) {
+    impulses.push_back(makeNoise((size_t)lens[i] * channels, i));
+    impulse_ptrs.push_back(&impulses[i][0]);
+  }
+  REQUIRE(simdsp::saveImpulseSpectra(path.c_str(), block_size, channels, (unsigned int)lens.size(), &impulse_ptrs[0],
+                                     &lens[0]));
+
+  auto file = simdsp::ImpulseSpectraFile::open(path.c_str());
+  REQUIRE(file != nullptr);
+  REQUIRE(file->getCount() == lens.size());
+  REQUIRE(file->getBlockSize() == block_size);
+  REQUIRE(file->getChannels() == channels);
+
+  std::vector<float> input = makeNoise((size_t)block_size * channels * blocks, 100);
+  for (unsigned int i = 0; i < lens.size(); i++) {
+    auto spectra = file->getSpectra(i);
+    REQUIRE(spectra.impulse_len == lens[i]);
+    REQUIRE(spectra.partition_count == (lens[i] + block_size - 1) / block_size);
+    REQUIRE((uintptr_t)spectra.re % simdsp::MAX_SIMD_ALIGNMENT == 0);
+    REQUIRE((uintptr_t)spectra.im % simdsp::MAX_SIMD_ALIGNMENT == 0);
+
+    simdsp::UniformPartitionedConvolver from_file(spectra);
+    simdsp::UniformPartitionedConvolver from_impulse(block_size, channels, impulse_ptrs[i], lens[i]);
+    std::vector<float> out_file(input.size(), 0.0f), out_impulse(input.size(), 0.0f);
+    for (unsigned int b = 0; b < blocks; b++) {
+      size_t offset = (size_t)b * block_size * channels;
+      from_file.process(&input[offset], &out_file[offset]);
+      from_impulse.process(&input[offset], &out_impulse[offset]);
+    }
+
+    // Same transform, same kernels.
+    REQUIRE(out_file == out_impulse);
+  }
+
+  file.reset();
+  remove(path.c_str());
+}
+
+TEST_CASE("uniform convolver crossfades to shorter precomputed spectra", "[convolution][fft]") {
+  const unsigned int block_size = 16, blocks = 20, long_len = 200, short_len = 40;
+  std::string path = getSpectraTestPath("crossfade");
+
+  std::vector<float> long_impulse = makeNoise(long_len, 1);
+  std::vector<float> short_impulse = makeNoise(short_len, 2);
+  const float *ptr = &short_impulse[0];
+  REQUIRE(simdsp::saveImpulseSpectra(path.c_str(), block_size, 1, 1, &ptr, &short_len));
+  auto file = simdsp::ImpulseSpectraFile::open(path.c_str());
+  REQUIRE(file != nullptr);
+
+  simdsp::UniformPartitionedConvolver precomputed(block_size, 1, &long_impulse[0], long_len);
+  simdsp::UniformPartitionedConvolver transformed(block_size, 1, &long_impulse[0], long_len);
+  std::vector<float> input = makeNoise(block_size * blocks, 3);
+  std::vector<float> out_precomputed(input.size(), 0.0f), out_transformed(input.size(), 0.0f);
+
+  for (unsigned int b = 0; b < blocks; b++) {
+    if (b == 5) {
+      precomputed.setImpulse(file->getSpectra(0));
+      transformed.setImpulse(&short_impulse[0], short_len);
+    }
+    precomputed.process(&input[b * block_size], &out_precomputed[b * block_size]);
+    transformed.process(&input[b * block_size], &out_transformed[b * block_size]);
+  }
+
+  for (size_t i = 0; i < input.size(); i++) {
+    REQUIRE(fabs(out_precomputed[i] - out_transformed[i]) < 1e-5);
+  }
+
+  file.reset();
+  remove(path.c_str());
+}
+
+TEST_CASE("invalid impulse spectra files are refused", "[convolution][fft]") {
+  std::string path = getSpectraTestPath("invalid");
+  std::vector<float> impulse = makeNoise(64, 1);
+  const float *ptr = &impulse[0];
+  unsigned int len = 64;
+
+  REQUIRE(simdsp::ImpulseSpectraFile::open(path.c_str()) == nullptr);
+
+  REQUIRE(simdsp::saveImpulseSpectra(path.c_str(), 32, 1, 1, &ptr, &len));
+  std::vector<unsigned char> contents;
+  {
+    FILE *f = fopen(path.c_str(), "rb");
+    REQUIRE(f != nullptr);
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+      contents.push_back((unsigned char)c);
+    }
+    fclose(f);
+  }
+
+  auto rewrite = [&](const std::vector<unsigned char> &bytes) {
+    FILE *f = fopen(path.c_str(), "wb");
+    REQUIRE(f != nullptr);
+    fwrite(&bytes[0], 1, bytes.size(), f);
+    fclose(f);
+  };
+
+  SECTION("truncated") { rewrite(std::vector<unsigned char>(contents.begin(), contents.end() - 4)); }
+  SECTION("bad magic") {
+    auto bytes = contents;
+    bytes[0] ^= 0xff;
+    rewrite(bytes);
+  }
+  SECTION("another version") {
+    auto bytes = contents;
+    bytes[8] += 1;
+    rewrite(bytes);
+  }
+  SECTION("absurd channel count") {
+    // Past the file's size; with a large enough partition count, the array size would wrap.
+    auto bytes = contents;
+    uint32_t channels = UINT32_MAX;
+    memcpy(&bytes[20], &channels, sizeof(channels));
+    rewrite(bytes);
+  }
+
+  REQUIRE(simdsp::ImpulseSpectraFile::open(path.c_str()) == nullptr);
+  remove(path.c_str());
+}
@@ -0,0 +1,106 @@
+#include "test_common.hpp"
+
+#include "simdsp/mixing/mixing.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <math.h>
+#include <vector>
+
+// Odd frame counts, so that the vectorized loops have tails.
+static const unsigned int FRAMES = 203;
+
+TEST_CASE("gain ramps", "[mixing]") {
+  for (unsigned int channels : {1u, 2u, 3u, 4u, 8u, 11u}) {
+    for (bool add : {false, true}) {
+      for (bool ramp : {false, true}) {
+        auto input = makeNoise(FRAMES * channels, channels);
+        auto output = makeNoise(FRAMES * channels, channels + 100);
+        float start = 0.5f, end = ramp ? -1.5f : 0.5f;
+
+        std::vector<double> expected(output.size());
+        for (unsigned int i = 0; i < FRAMES; i++) {
+          double gain = start + ((double)end - start) * (i + 1) / FRAMES;
+          for (unsigned int ch = 0; ch < channels; ch++) {
+            size_t k = (size_t)i * channels + ch;
+            expected[k] = (add ? output[k] : 0.0) + input[k] * gain;
+          }
+        }
+
+        simdsp::mixGainRamp(input.data(), output.data(), FRAMES, channels, start, end, add);
+        REQUIRE(getMaxError(expected, output) < 1e-5);
+      }
+    }
+  }
+}
+
+TEST_CASE("gains work in place", "[mixing]") {
+  auto buffer = makeNoise(FRAMES * 2, 5), original = buffer;
+  simdsp::mixGain(buffer.data(), buffer.data(), FRAMES, 2, 0.25f, false);
+  for (size_t i = 0; i < buffer.size(); i++) {
+    REQUIRE(buffer[i] == original[i] * 0.25f);
+  }
+}
+
+TEST_CASE("matrix mixes", "[mixing]") {
+  // Every fixed shape, and some which take the runtime path on one side or both.
+  const unsigned int counts[] = {1, 2, 3, 4, 6, 8};
+  for (unsigned int in : counts) {
+    for (unsigned int out : counts) {
+      for (bool add : {false, true}) {
+        for (bool ramp : {false, true}) {
+          auto input = makeNoise(FRAMES * in, in * 10 + out);
+          auto output = makeNoise(FRAMES * out, in * 10 + out + 1);
+          auto from = makeNoise(in * out, in * 10 + out + 2), to = makeNoise(in * out, in * 10 + out + 3);
+
+          std::vector<double> expected(output.size());
+          for (unsigned int i = 0; i < FRAMES; i++) {
+            double t = ramp ? (double)(i + 1) / FRAMES : 0.0;
+            for (unsigned int o = 0; o < out; o++) {
+              double sum = add ? output[(size_t)i * out + o] : 0.0;
+              for (unsigned int c = 0; c < in; c++) {
+                unsigned int k = o * in + c;
+                sum += input[(size_t)i * in + c] * (from[k] + ((double)to[k] - from[k]) * t);
+              }
+              expected[(size_t)i * out + o] = sum;
+            }
+          }
+
+          if (ramp) {
+            simdsp::mixMatrixRamp(input.data(), in, output.data(), out, FRAMES, from.data(), to.data(), add);
+          } else {
+            simdsp::mixMatrix(input.data(), in, output.data(), out, FRAMES, from.data(), add);
+          }
+          REQUIRE(getMaxError(expected, output) < 1e-5);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("interleaving and deinterleaving", "[mixing]") {
+  for (unsigned int channels : {1u, 2u, 3u, 4u, 8u, 11u}) {
+    std::vector<std::vector<float>> planar;
+    std::vector<const float *> sources;
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      planar.push_back(makeNoise(FRAMES, ch));
+      sources.push_back(planar.back().data());
+    }
+
+    std::vector<float> interleaved(FRAMES * channels);
+    simdsp::interleaveChannels(sources.data(), channels, FRAMES, interleaved.data());
+    for (unsigned int i = 0; i < FRAMES; i++) {
+      for (unsigned int ch = 0; ch < channels; ch++) {
+        REQUIRE(interleaved[(size_t)i * channels + ch] == planar[ch][i]);
+      }
+    }
+
+    std::vector<std::vector<float>> back(channels, std::vector<float>(FRAMES));
+    std::vector<float *> destinations;
+    for (auto &b : back) {
+      destinations.push_back(b.data());
+    }
+    simdsp::deinterleaveChannels(interleaved.data(), channels, FRAMES, destinations.data());
+    REQUIRE(back == planar);
+  }
+}
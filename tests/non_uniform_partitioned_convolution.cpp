@@ -0,0 +1,106 @@
+#include "test_common.hpp"
+
+#include "simdsp/convolution/convolution_worker.hpp"
+#include "simdsp/convolution/non_uniform_partitioned_convolution.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+/*
+ * As the uniform convolver's test, with the layout and worker the non-uniform one adds.
+ */
+static void checkAgainstDirect(unsigned int block_size, unsigned int channels, unsigned int impulse_len,
+                               unsigned int blocks, unsigned int max_partition_size = 0,
+                               simdsp::ConvolutionWorker *worker = nullptr) {
+  unsigned int seed = block_size * 13 + channels * 5 + impulse_len;
+  std::vector<float> impulse = makeNoise((size_t)impulse_len * channels, seed);
+  std::vector<float> input = makeNoise((size_t)block_size * blocks * channels, seed + 1);
+
+  simdsp::NonUniformPartitionedConvolver conv(block_size, channels, &impulse[0], impulse_len, max_partition_size,
+                                              worker);
+  std::vector<float> output(input.size(), 0.0f);
+  for (unsigned int b = 0; b < blocks; b++) {
+    conv.process(&input[b * block_size * channels], &output[b * block_size * channels]);
+  }
+
+  auto expected = convolveDirect(input, impulse, impulse_len, channels, block_size * blocks);
+  REQUIRE(getMaxError(expected, output) < getConvolutionTolerance(impulse_len));
+  if (worker != nullptr && conv.getLayout().size() > 1) {
+    REQUIRE(conv.getBackgroundResultCount() > 0);
+  }
+  REQUIRE(conv.getLateResultCount() <= conv.getBackgroundResultCount());
+}
+
+TEST_CASE("non-uniform partition layouts are zero-latency and cover the impulse", "[convolution][fft]") {
+  for (unsigned int block_size : {16u, 64u, 256u}) {
+    for (unsigned int impulse_len : {1u, 16u, 100u, 4096u, 48000u, 192000u}) {
+      auto layout = simdsp::computeNonUniformPartitionLayout(block_size, impulse_len);
+      unsigned int covered = block_size;
+
+      for (auto &seg : layout) {
+        REQUIRE(seg.offset == covered);
+        REQUIRE(seg.offset >= seg.partition_size);
+        REQUIRE(seg.partition_size >= block_size);
+        REQUIRE(seg.partition_count > 0);
+        covered += seg.partition_size * seg.partition_count;
+      }
+
+      REQUIRE(covered >= impulse_len);
+    }
+  }
+}
+
+TEST_CASE("non-uniform partitioned convolver matches direct convolution", "[convolution][fft]") {
+  SECTION("head only") { checkAgainstDirect(32, 1, 20, 5); }
+  SECTION("head and one segment") { checkAgainstDirect(16, 2, 40, 12); }
+  SECTION("several doublings") { checkAgainstDirect(8, 1, 2000, 400, 128); }
+  SECTION("automatic layout, stereo") { checkAgainstDirect(32, 2, 5000, 200); }
+}
+
+TEST_CASE("non-uniform partitioned convolver matches direct convolution with a worker", "[convolution][fft]") {
+  simdsp::ConvolutionWorker worker;
+
+  SECTION("head and one segment") { checkAgainstDirect(16, 2, 40, 12, 0, &worker); }
+  SECTION("several doublings") { checkAgainstDirect(8, 1, 2000, 400, 128, &worker); }
+  SECTION("automatic layout, stereo") { checkAgainstDirect(32, 2, 5000, 200, 0, &worker); }
+  SECTION("two convolvers sharing the worker") {
+    simdsp::NonUniformPartitionedConvolver other(16, 1, std::vector<float>(3000, 0.5f).data(), 3000, 0, &worker);
+    std::vector<float> block(16, 1.0f), out(16);
+    for (unsigned int i = 0; i < 50; i++) {
+      other.process(&block[0], &out[0]);
+    }
+    checkAgainstDirect(16, 1, 3000, 300, 256, &worker);
+    other.reset();
+  }
+}
+
+TEST_CASE("non-uniform partitioned convolver output modes", "[convolution][fft]") {
+  // Long enough to have a tail of FFT segments as well as the direct head.
+  const unsigned int block_size = 64, channels = 2, impulse_len = 3000, blocks = 80;
+  std::vector<float> impulse = makeNoise(impulse_len * channels, 8);
+  std::vector<float> input = makeNoise(block_size * blocks * channels, 9);
+
+  simdsp::NonUniformPartitionedConvolver reference(block_size, channels, &impulse[0], impulse_len);
+  simdsp::NonUniformPartitionedConvolver conv(block_size, channels, &impulse[0], impulse_len);
+  REQUIRE(conv.getLayout().size() > 0);
+
+  for (unsigned int b = 0; b < blocks; b++) {
+    bool add = b % 2 == 0;
+    float gain_start = 1.0f - 0.01f * b, gain_end = 0.5f + 0.01f * b;
+    const float *in = &input[b * block_size * channels];
+    std::vector<float> plain(block_size * channels, 0.0f), output(block_size * channels, 0.75f);
+    reference.process(in, &plain[0]);
+    conv.process(in, &output[0], simdsp::OutputMode{add, gain_start, gain_end});
+
+    for (unsigned int i = 0; i < block_size; i++) {
+      double gain = gain_start + ((double)gain_end - gain_start) * (i + 1) / block_size;
+      for (unsigned int ch = 0; ch < channels; ch++) {
+        double expected = (add ? 0.75 : 0.0) + plain[i * channels + ch] * gain;
+        REQUIRE(output[i * channels + ch] == Approx(expected).margin(1e-3));
+      }
+    }
+  }
+}
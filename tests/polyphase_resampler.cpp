@@ -0,0 +1,161 @@
+#include "simdsp/resampling/polyphase_resampler.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+static const double PI = 3.14159265358979323846;
+
+/*
+ * A sine per channel, each at its own frequency, so that channels getting mixed up shows.
+ */
+static double getSine(unsigned int channel, double time, double sample_rate) {
+  return sin(2.0 * PI * (500.0 + 700.0 * channel) * time / sample_rate + channel);
+}
+
+/*
+ * Feed input in blocks of chunk frames, collecting everything written.
+ */
+static std::vector<float> runResampler(simdsp::PolyphaseResampler &resampler, const std::vector<float> &input,
+                                       unsigned int chunk) {
+  unsigned int channels = resampler.getChannels(), frames = (unsigned int)(input.size() / channels);
+  std::vector<float> output, block;
+
+  for (unsigned int start = 0; start < frames; start += chunk) {
+    unsigned int count = std::min(chunk, frames - start);
+    unsigned int max_frames = resampler.getMaxOutputFrames(count);
+    block.resize((size_t)max_frames * channels);
+    unsigned int produced = resampler.process(&input[(size_t)start * channels], count, block.data());
+    REQUIRE(produced <= max_frames);
+    output.insert(output.end(), block.begin(), block.begin() + (size_t)produced * channels);
+  }
+
+  return output;
+}
+
+static std::vector<float> makeSines(unsigned int channels, unsigned int frames, double sample_rate) {
+  std::vector<float> input((size_t)frames * channels);
+  for (unsigned int i = 0; i < frames; i++) {
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      input[(size_t)i * channels + ch] = (float)getSine(ch, i, sample_rate);
+    }
+  }
+  return input;
+}
+
+/*
+ * Output frame n should be the input at time n * input_rate / output_rate.  The first few frames are skipped, since the
+ * filter sees the silence before the input there.
+ */
+static void checkSines(unsigned int channels, unsigned int input_rate, unsigned int output_rate,
+                       simdsp::ResamplerQuality quality, double tolerance) {
+  const unsigned int frames = 8192;
+  simdsp::PolyphaseResampler resampler(channels, input_rate, output_rate, quality);
+  auto output = runResampler(resampler, makeSines(channels, frames, input_rate), 517);
+
+  unsigned int output_frames = (unsigned int)(output.size() / channels);
+  double expected_frames = (double)(frames - resampler.getLatency()) * output_rate / input_rate;
+  REQUIRE(fabs(output_frames - expected_frames) <= 2.0);
+
+  double max_err = 0.0;
+  for (unsigned int n = 64; n < output_frames; n++) {
+    double time = (double)n * input_rate / output_rate;
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      max_err = fmax(max_err, fabs(getSine(ch, time, input_rate) - output[(size_t)n * channels + ch]));
+    }
+  }
+  REQUIRE(max_err < tolerance);
+}
+
+TEST_CASE("polyphase resamplers reconstruct sines", "[resampling]") {
+  using simdsp::ResamplerQuality;
+
+  SECTION("44.1 to 48 kHz, mono") { checkSines(1, 44100, 48000, ResamplerQuality::MEDIUM, 2e-3); }
+  SECTION("44.1 to 48 kHz, stereo, high quality") { checkSines(2, 44100, 48000, ResamplerQuality::HIGH, 5e-4); }
+  SECTION("48 to 44.1 kHz, 3 channels") { checkSines(3, 48000, 44100, ResamplerQuality::MEDIUM, 2e-3); }
+  SECTION("48 to 96 kHz, 4 channels") { checkSines(4, 48000, 96000, ResamplerQuality::MEDIUM, 2e-3); }
+  SECTION("96 to 48 kHz, 8 channels, low quality") { checkSines(8, 96000, 48000, ResamplerQuality::LOW, 2e-2); }
+  // 48000 / 44111 doesn't reduce below MAX_RATIONAL_PHASES, so this takes the interpolated path.
+  SECTION("awkward ratio") { checkSines(2, 44111, 48000, ResamplerQuality::MEDIUM, 2e-3); }
+}
+
+TEST_CASE("polyphase resampler output doesn't depend on how input is split", "[resampling]") {
+  for (bool variable : {false, true}) {
+    auto input = makeSines(2, 5000, 44100);
+    simdsp::PolyphaseResampler whole(2, 44100, 48000, simdsp::ResamplerQuality::MEDIUM, variable);
+    simdsp::PolyphaseResampler split(2, 44100, 48000, simdsp::ResamplerQuality::MEDIUM, variable);
+
+    auto expected = runResampler(whole, input, 5000);
+    // Sizes around and beyond the internal history, and a single frame.
+    std::vector<float> got;
+    unsigned int sizes[] = {1, 7, 1023, 1024, 1025, 3000}, start = 0, i = 0;
+    while (start < 5000) {
+      unsigned int count = std::min(sizes[i++ % 6], 5000 - start);
+      std::vector<float> block((size_t)split.getMaxOutputFrames(count) * 2);
+      unsigned int produced = split.process(&input[(size_t)start * 2], count, block.data());
+      got.insert(got.end(), block.begin(), block.begin() + (size_t)produced * 2);
+      start += count;
+    }
+
+    REQUIRE(got == expected);
+
+    whole.reset();
+    REQUIRE(runResampler(whole, input, 5000) == expected);
+  }
+}
+
+TEST_CASE("variable polyphase resamplers follow ratio changes", "[resampling]") {
+  const unsigned int input_rate = 48000;
+  simdsp::PolyphaseResampler resampler(1, input_rate, 44100, simdsp::ResamplerQuality::MEDIUM, true);
+  REQUIRE(resampler.isVariable());
+
+  // Change the ratio every block and track where the output should be in time.
+  auto input = makeSines(1, 20000, input_rate);
+  std::vector<float> output;
+  std::vector<double> times;
+  double time = 0.0;
+  unsigned int start = 0, block = 0;
+  while (start < 20000) {
+    double ratio = 0.9 + 0.02 * (block % 7);
+    resampler.setRatio(ratio);
+    unsigned int count = std::min(256u, 20000 - start);
+    std::vector<float> out(resampler.getMaxOutputFrames(count));
+    unsigned int produced = resampler.process(&input[start], count, out.data());
+    for (unsigned int i = 0; i < produced; i++) {
+      output.push_back(out[i]);
+      times.push_back(time);
+      time += 1.0 / ratio;
+    }
+    start += count;
+    block++;
+  }
+
+  // The gap after each output frame is set by the ratio in effect when it was written.
+  REQUIRE(output.size() > 18000);
+  double max_err = 0.0;
+  for (size_t n = 64; n < output.size(); n++) {
+    max_err = fmax(max_err, fabs(getSine(0, times[n], input_rate) - output[n]));
+  }
+  REQUIRE(max_err < 2e-3);
+}
+
+TEST_CASE("polyphase resamplers filter out what can't be represented", "[resampling]") {
+  // 10 kHz is above the Nyquist frequency of 16 kHz, so it should all but vanish.
+  const unsigned int frames = 9600;
+  std::vector<float> input(frames);
+  for (unsigned int i = 0; i < frames; i++) {
+    input[i] = (float)sin(2.0 * PI * 10000.0 * i / 48000.0);
+  }
+
+  simdsp::PolyphaseResampler resampler(1, 48000, 16000, simdsp::ResamplerQuality::HIGH);
+  auto output = runResampler(resampler, input, 960);
+  REQUIRE(output.size() > 3000);
+
+  double peak = 0.0;
+  for (size_t i = 64; i < output.size(); i++) {
+    peak = fmax(peak, fabs(output[i]));
+  }
+  REQUIRE(peak < 1e-3);
+}
@@ -0,0 +1,185 @@
+#include "test_common.hpp"
+
+#include "simdsp/mixing/sample_format.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+static const simdsp::SampleFormat FORMATS[] = {simdsp::SampleFormat::INT16, simdsp::SampleFormat::INT24_PACKED,
+                                               simdsp::SampleFormat::INT32};
+
+static unsigned int getBits(simdsp::SampleFormat format) { return simdsp::getSampleFormatBytes(format) * 8; }
+
+// Past full scale, so that clamping is exercised.
+static const float NOISE_AMPLITUDE = 1.25f;
+
+/*
+ * The reference conversion, in double precision and one sample at a time.
+ */
+static int64_t quantizeReference(float value, unsigned int bits) {
+  double scale = ldexp(1.0, bits - 1);
+  double scaled = (double)value * scale;
+  double rounded = scaled < 0.0 ? ceil(scaled - 0.5) : floor(scaled + 0.5);
+  return (int64_t)fmin(fmax(rounded, -scale), scale - 1.0);
+}
+
+static int64_t readSample(const std::vector<unsigned char> &bytes, simdsp::SampleFormat format, size_t index) {
+  switch (format) {
+  case simdsp::SampleFormat::INT16: {
+    int16_t ret;
+    memcpy(&ret, &bytes[index * 2], 2);
+    return ret;
+  }
+  case simdsp::SampleFormat::INT24_PACKED: {
+    int32_t ret = bytes[index * 3] | (bytes[index * 3 + 1] << 8) | (bytes[index * 3 + 2] << 16);
+    return ret >= (1 << 23) ? ret - (1 << 24) : ret;
+  }
+  case simdsp::SampleFormat::INT32: {
+    int32_t ret;
+    memcpy(&ret, &bytes[index * 4], 4);
+    return ret;
+  }
+  }
+  return 0;
+}
+
+// Odd, and longer than a conversion chunk, so that every loop has a tail.
+static const unsigned int FRAMES = 523;
+
+TEST_CASE("float to sample conversion", "[sample_format]") {
+  for (auto format : FORMATS) {
+    unsigned int bits = getBits(format);
+    auto input = makeNoise(FRAMES, bits, NOISE_AMPLITUDE);
+    // Exact values at the edges.
+    input[0] = 1.0f;
+    input[1] = -1.0f;
+    input[2] = 0.0f;
+    input[3] = 0.5f / 32768.0f;
+
+    std::vector<unsigned char> output(FRAMES * simdsp::getSampleFormatBytes(format));
+    simdsp::convertFloatToSamples(input.data(), FRAMES, format, output.data());
+
+    for (unsigned int i = 0; i < FRAMES; i++) {
+      int64_t expected = quantizeReference(input[i], bits), got = readSample(output, format, i);
+      if (format == simdsp::SampleFormat::INT32) {
+        // float only has 24 bits of mantissa.
+        REQUIRE(llabs(expected - got) <= 128);
+      } else {
+        REQUIRE(expected == got);
+      }
+    }
+    // Full scale clamps to the largest value, and for INT32 to the largest float below 2^31 on both sides.
+    int64_t full_scale = (int64_t)1 << (bits - 1);
+    if (format == simdsp::SampleFormat::INT32) {
+      REQUIRE(readSample(output, format, 0) == full_scale - 128);
+      REQUIRE(readSample(output, format, 1) == -full_scale + 128);
+    } else {
+      REQUIRE(readSample(output, format, 0) == full_scale - 1);
+      REQUIRE(readSample(output, format, 1) == -full_scale);
+    }
+  }
+}
+
+TEST_CASE("sample round trips", "[sample_format]") {
+  for (auto format : FORMATS) {
+    for (unsigned int channels : {1u, 2u, 3u, 4u, 8u, 11u}) {
+      std::vector<std::vector<float>> planar;
+      std::vector<const float *> sources;
+      for (unsigned int ch = 0; ch < channels; ch++) {
+        planar.push_back(makeNoise(FRAMES, ch + 10 * channels, NOISE_AMPLITUDE));
+        sources.push_back(planar.back().data());
+      }
+
+      std::vector<unsigned char> interleaved((size_t)FRAMES * channels * simdsp::getSampleFormatBytes(format));
+      simdsp::interleaveFloatToSamples(sources.data(), channels, FRAMES, format, interleaved.data());
+
+      std::vector<std::vector<float>> decoded(channels, std::vector<float>(FRAMES));
+      std::vector<float *> destinations;
+      for (auto &d : decoded) {
+        destinations.push_back(d.data());
+      }
+      simdsp::deinterleaveSamplesToFloat(interleaved.data(), channels, FRAMES, format, destinations.data());
+
+      double lsb = ldexp(1.0, 1 - (int)getBits(format));
+      for (unsigned int ch = 0; ch < channels; ch++) {
+        for (unsigned int i = 0; i < FRAMES; i++) {
+          size_t k = (size_t)i * channels + ch;
+          int64_t expected = quantizeReference(planar[ch][i], getBits(format));
+          if (format != simdsp::SampleFormat::INT32) {
+            REQUIRE(readSample(interleaved, format, k) == expected);
+          }
+          double clamped = fmin(fmax(planar[ch][i], -1.0), 1.0 - lsb);
+          REQUIRE(fabs(decoded[ch][i] - clamped) <= fmax(lsb, 1e-7));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("decoding the integer extremes", "[sample_format]") {
+  const int16_t int16_samples[] = {-32768, 32767, 0, 1};
+  const unsigned char int24_samples[] = {0x00, 0x00, 0x80, 0xff, 0xff, 0x7f, 0, 0, 0, 0x01, 0, 0};
+  const int32_t int32_samples[] = {INT32_MIN, INT32_MAX, 0, 1 << 8};
+  float out[4];
+
+  simdsp::convertSamplesToFloat(int16_samples, 4, simdsp::SampleFormat::INT16, out);
+  REQUIRE(out[0] == -1.0f);
+  REQUIRE(out[1] == 32767.0f / 32768.0f);
+  REQUIRE(out[2] == 0.0f);
+  REQUIRE(out[3] == 1.0f / 32768.0f);
+
+  simdsp::convertSamplesToFloat(int24_samples, 4, simdsp::SampleFormat::INT24_PACKED, out);
+  REQUIRE(out[0] == -1.0f);
+  REQUIRE(out[1] == 8388607.0f / 8388608.0f);
+  REQUIRE(out[2] == 0.0f);
+  REQUIRE(out[3] == 1.0f / 8388608.0f);
+
+  simdsp::convertSamplesToFloat(int32_samples, 4, simdsp::SampleFormat::INT32, out);
+  REQUIRE(out[0] == -1.0f);
+  REQUIRE(out[1] == 1.0f);
+  REQUIRE(out[2] == 0.0f);
+  REQUIRE(out[3] == 1.0f / 8388608.0f);
+}
+
+TEST_CASE("TPDF dither", "[sample_format]") {
+  const unsigned int len = 1 << 16;
+  for (auto format : {simdsp::SampleFormat::INT16, simdsp::SampleFormat::INT24_PACKED}) {
+    // A constant a quarter of an LSB above zero: undithered, that rounds to 0 every time.
+    float value = 0.25f / (float)ldexp(1.0, getBits(format) - 1);
+    std::vector<float> input(len, value);
+    std::vector<unsigned char> output(len * simdsp::getSampleFormatBytes(format));
+
+    simdsp::SampleDither dither(3);
+    simdsp::convertFloatToSamples(input.data(), len, format, output.data(), &dither);
+
+    double sum = 0.0;
+    int64_t counts[3] = {};
+    for (unsigned int i = 0; i < len; i++) {
+      int64_t s = readSample(output, format, i);
+      // 1 LSB peak TPDF plus a quarter and rounding stays within an LSB.
+      REQUIRE(s >= -1);
+      REQUIRE(s <= 1);
+      counts[s + 1]++;
+      sum += s;
+    }
+
+    // Dithered, the mean is the input.
+    REQUIRE(fabs(sum / len - 0.25) < 0.01);
+    // And the triangular distribution puts 0.25^2 / 2 below -0.5 and (0.75)^2 / 2 above 0.5.
+    REQUIRE(fabs((double)counts[0] / len - 0.03125) < 0.005);
+    REQUIRE(fabs((double)counts[2] / len - 0.28125) < 0.01);
+
+    // The state advances: converting again gives different noise.
+    std::vector<unsigned char> again(output.size());
+    simdsp::convertFloatToSamples(input.data(), len, format, again.data(), &dither);
+    REQUIRE(again != output);
+
+    // And the same seed gives the same noise.
+    simdsp::SampleDither reseeded(3);
+    simdsp::convertFloatToSamples(input.data(), len, format, again.data(), &reseeded);
+    REQUIRE(again == output);
+  }
+}
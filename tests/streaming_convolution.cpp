@@ -0,0 +1,67 @@
+#include "test_common.hpp"
+
+#include "simdsp/convolution/streaming_convolution.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <math.h>
+#include <random>
+#include <vector>
+
+/*
+ * Feed the convolver ragged calls, some larger than max_block_size, and compare against direct convolution over the
+ * whole signal.
+ */
+static void checkRaggedCalls(unsigned int channels, unsigned int impulse_len, unsigned int max_block_size) {
+  unsigned int seed = channels * 101 + impulse_len * 3 + max_block_size;
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned int> call_len(0, max_block_size * 3);
+
+  unsigned int total = 2000;
+  std::vector<float> impulse = makeNoise(impulse_len * channels, seed + 1);
+  std::vector<float> input = makeNoise(total * channels, seed + 2);
+  std::vector<float> output(total * channels, 0.0f);
+
+  simdsp::StreamingConvolver conv(channels, &impulse[0], impulse_len, max_block_size);
+  unsigned int done = 0;
+  while (done < total) {
+    unsigned int frames = std::min(call_len(rng), total - done);
+    conv.process(&input[done * channels], frames, &output[done * channels]);
+    done += frames;
+  }
+
+  auto expected = convolveDirect(input, impulse, impulse_len, channels, total);
+  REQUIRE(getMaxError(expected, output) < getConvolutionTolerance(impulse_len));
+}
+
+TEST_CASE("streaming convolver handles arbitrary call sizes", "[convolution]") {
+  SECTION("mono") { checkRaggedCalls(1, 33, 16); }
+  SECTION("stereo, impulse shorter than a block") { checkRaggedCalls(2, 5, 64); }
+  SECTION("one tap") { checkRaggedCalls(3, 1, 7); }
+  SECTION("long impulse, small blocks") { checkRaggedCalls(2, 300, 4); }
+  SECTION("impulse too big for L1, so tiled") { checkRaggedCalls(2, 20000, 100); }
+}
+
+TEST_CASE("streaming convolver output modes span the whole call", "[convolution]") {
+  const unsigned int channels = 2, impulse_len = 40, frames = 300;
+  std::vector<float> impulse = makeNoise(impulse_len * channels, 9), input = makeNoise(frames * channels, 10);
+
+  // A small max_block_size, so that the call is split and the ramp has to carry across the pieces.
+  for (bool add : {false, true}) {
+    simdsp::StreamingConvolver reference(channels, &impulse[0], impulse_len, 64);
+    simdsp::StreamingConvolver conv(channels, &impulse[0], impulse_len, 64);
+    std::vector<float> plain(frames * channels, 0.0f), output(frames * channels, 0.3f);
+
+    reference.process(&input[0], frames, &plain[0]);
+    conv.process(&input[0], frames, &output[0], simdsp::OutputMode{add, 2.0f, -1.0f});
+
+    for (unsigned int i = 0; i < frames; i++) {
+      double gain = 2.0 - 3.0 * (i + 1) / frames;
+      for (unsigned int ch = 0; ch < channels; ch++) {
+        double expected = (add ? 0.3 : 0.0) + plain[i * channels + ch] * gain;
+        REQUIRE(output[i * channels + ch] == Approx(expected).margin(1e-4));
+      }
+    }
+  }
+}
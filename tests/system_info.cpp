@@ -0,0 +1,139 @@
+#include "simdsp/system_info.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+TEST_CASE("cpu topology is self-consistent", "[system_info]") {
+  simdsp::SystemInfo info = simdsp::getSystemInfo();
+  const simdsp::CpuTopology &topology = info.topology;
+
+  REQUIRE(topology.logical_cores > 0);
+  REQUIRE(topology.logical_cores <= simdsp::CPU_TOPOLOGY_MAX_CPUS);
+  unsigned int online = std::thread::hardware_concurrency();
+  if (online != 0 && online <= simdsp::CPU_TOPOLOGY_MAX_CPUS) {
+    REQUIRE(topology.logical_cores == online);
+  }
+  REQUIRE(topology.physical_cores > 0);
+  REQUIRE(topology.physical_cores <= topology.logical_cores);
+  REQUIRE(topology.packages > 0);
+  REQUIRE(topology.packages <= topology.physical_cores);
+  REQUIRE(topology.numa_nodes > 0);
+
+  // Dense indices: every index below the count is used, and nothing above it.
+  bool core_seen[simdsp::CPU_TOPOLOGY_MAX_CPUS] = {}, l3_seen[simdsp::CPU_TOPOLOGY_MAX_CPUS] = {};
+  for (unsigned int i = 0; i < topology.logical_cores; i++) {
+    const simdsp::LogicalCpu &cpu = topology.cpus[i];
+    if (i > 0) {
+      REQUIRE(cpu.os_index > topology.cpus[i - 1].os_index);
+    }
+    REQUIRE(cpu.core < topology.physical_cores);
+    REQUIRE(cpu.package < topology.packages);
+    REQUIRE(cpu.numa_node < topology.numa_nodes);
+    core_seen[cpu.core] = true;
+    if (topology.l3_domains != 0) {
+      REQUIRE(cpu.l3_domain < topology.l3_domains);
+      l3_seen[cpu.l3_domain] = true;
+    }
+  }
+  for (unsigned int i = 0; i < topology.physical_cores; i++) {
+    REQUIRE(core_seen[i]);
+  }
+  for (unsigned int i = 0; i < topology.l3_domains; i++) {
+    REQUIRE(l3_seen[i]);
+  }
+
+  // SMT siblings are in one package, and share whatever caches they have.
+  for (unsigned int i = 0; i < topology.logical_cores; i++) {
+    for (unsigned int j = 0; j < topology.logical_cores; j++) {
+      const simdsp::LogicalCpu &a = topology.cpus[i], &b = topology.cpus[j];
+      if (a.core == b.core) {
+        REQUIRE(a.package == b.package);
+        REQUIRE(a.l2_domain == b.l2_domain);
+      }
+    }
+  }
+}
+
+TEST_CASE("cache sharing masks contain the cpus of the domain", "[system_info]") {
+  simdsp::SystemInfo info = simdsp::getSystemInfo();
+  const simdsp::CpuTopology &topology = info.topology;
+  uint64_t mask[simdsp::CPU_TOPOLOGY_MAX_CPUS / 64];
+
+  for (unsigned int level = 2; level <= 3; level++) {
+    for (unsigned int i = 0; i < topology.logical_cores; i++) {
+      bool known = simdsp::getCacheSharingMask(&topology, i, level, mask);
+      uint16_t domain = level == 2 ? topology.cpus[i].l2_domain : topology.cpus[i].l3_domain;
+      REQUIRE(known == (domain != simdsp::CPU_TOPOLOGY_UNKNOWN));
+      if (known == false) {
+        continue;
+      }
+
+      for (unsigned int j = 0; j < topology.logical_cores; j++) {
+        const simdsp::LogicalCpu &other = topology.cpus[j];
+        bool in_mask = (mask[other.os_index / 64] >> (other.os_index % 64)) & 1;
+        uint16_t other_domain = level == 2 ? other.l2_domain : other.l3_domain;
+        REQUIRE(in_mask == (other_domain == domain));
+      }
+    }
+  }
+}
+
+TEST_CASE("vector capabilities match the architecture", "[system_info]") {
+  simdsp::SystemInfo info = simdsp::getSystemInfo();
+  auto has = [&](const simdsp::CpuBit &bit) { return (info.cpu_capabilities.bits & bit.bit) != 0; };
+  bool sve = has(simdsp::CpuCapabilities::AARCH64_SVE);
+
+  if (info.cpu_architecture == simdsp::CpuArchitecture::AARCH64) {
+    REQUIRE(has(simdsp::CpuCapabilities::AARCH64_NEON));
+    REQUIRE(has(simdsp::CpuCapabilities::X86_SSE2) == false);
+  } else {
+    REQUIRE(has(simdsp::CpuCapabilities::AARCH64_NEON) == false);
+  }
+
+  // The architecture allows 128 to 2048 bits, in multiples of 128.
+  REQUIRE((info.sve_vector_bytes != 0) == sve);
+  REQUIRE(info.sve_vector_bytes % 16 == 0);
+  REQUIRE(info.sve_vector_bytes <= 256);
+  if (has(simdsp::CpuCapabilities::AARCH64_SVE2)) {
+    REQUIRE(sve);
+  }
+}
+
+TEST_CASE("x86 features are only reported with the state they need", "[system_info]") {
+  simdsp::SystemInfo info = simdsp::getSystemInfo();
+  auto has = [&](const simdsp::CpuBit &bit) { return (info.cpu_capabilities.bits & bit.bit) != 0; };
+
+  // Everything using ymm registers needs the OS to save them, which is what X86_AVX reports.
+  for (auto bit : {simdsp::CpuCapabilities::X86_AVX2, simdsp::CpuCapabilities::X86_FMA3,
+                   simdsp::CpuCapabilities::X86_F16C, simdsp::CpuCapabilities::X86_AVX_VNNI,
+                   simdsp::CpuCapabilities::X86_AVX512F}) {
+    if (has(bit)) {
+      REQUIRE(has(simdsp::CpuCapabilities::X86_AVX));
+    }
+  }
+
+  // And everything using zmm or opmask registers needs the zmm state, which is what X86_AVX512F reports.
+  for (auto bit : {simdsp::CpuCapabilities::X86_AVX512BW, simdsp::CpuCapabilities::X86_AVX512DQ,
+                   simdsp::CpuCapabilities::X86_AVX512VL, simdsp::CpuCapabilities::X86_AVX512VNNI,
+                   simdsp::CpuCapabilities::X86_AVX512BF16, simdsp::CpuCapabilities::X86_AVX512FP16}) {
+    if (has(bit)) {
+      REQUIRE(has(simdsp::CpuCapabilities::X86_AVX512F));
+    }
+  }
+
+  if (info.avx512_downclocks) {
+    REQUIRE(info.cpu_manufacturer == simdsp::CpuManufacturer::INTEL);
+  }
+}
+
+TEST_CASE("system info json includes the topology", "[system_info]") {
+  simdsp::SystemInfo info = simdsp::getSystemInfo();
+  char *json = simdsp::convertSystemInfoToJson(&info);
+
+  REQUIRE(strstr(json, "\"cpu_topology\":{\"logical_cores\":") != nullptr);
+  REQUIRE(strstr(json, "\"cpus\":[{") != nullptr);
+  free(json);
+}
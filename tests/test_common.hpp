@@ -0,0 +1,60 @@
+#pragma once
+
+/*
+ * Signals and references shared between the tests.
+ */
+
+#include <catch2/catch.hpp>
+
+#include <math.h>
+#include <random>
+#include <stddef.h>
+#include <vector>
+
+/*
+ * len samples of noise, uniform in [-amplitude, amplitude] and the same every run for a given seed.
+ */
+inline std::vector<float> makeNoise(size_t len, unsigned int seed, float amplitude = 1.0f) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-amplitude, amplitude);
+  std::vector<float> ret(len);
+  for (auto &x : ret) {
+    x = dist(rng);
+  }
+  return ret;
+}
+
+/*
+ * The first frames frames of the convolution of interleaved input with an interleaved impulse in natural order, in
+ * double precision one sample at a time.  Everything before input is silence, as it is for a freshly constructed
+ * convolver.
+ */
+inline std::vector<double> convolveDirect(const std::vector<float> &input, const std::vector<float> &impulse,
+                                          unsigned int impulse_len, unsigned int channels, unsigned int frames) {
+  std::vector<double> ret((size_t)frames * channels);
+  for (unsigned int frame = 0; frame < frames; frame++) {
+    for (unsigned int ch = 0; ch < channels; ch++) {
+      double sum = 0.0;
+      for (unsigned int j = 0; j < impulse_len && j <= frame; j++) {
+        sum += (double)input[(size_t)(frame - j) * channels + ch] * (double)impulse[(size_t)j * channels + ch];
+      }
+      ret[(size_t)frame * channels + ch] = sum;
+    }
+  }
+  return ret;
+}
+
+/*
+ * What a convolution of noise in [-1, 1] may be off from convolveDirect by.  The output can be as large as
+ * impulse_len, but for noise grows like sqrt(impulse_len), and so does the error.
+ */
+inline double getConvolutionTolerance(unsigned int impulse_len) { return 1e-4 * sqrt((double)impulse_len) + 1e-5; }
+
+inline double getMaxError(const std::vector<double> &expected, const std::vector<float> &got) {
+  REQUIRE(expected.size() == got.size());
+  double max_err = 0.0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    max_err = fmax(max_err, fabs(expected[i] - (double)got[i]));
+  }
+  return max_err;
+}
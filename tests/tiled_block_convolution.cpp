@@ -0,0 +1,76 @@
+#include "test_common.hpp"
+
+#include "simdsp/convolution/generic_block_convolution.hpp"
+#include "simdsp/convolution/tiled_block_convolution.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <math.h>
+#include <vector>
+
+/*
+ * Compare against genericBlockConvolver, which is the definition of correct here.  Odd lengths make sure every tile
+ * loop has a remainder.
+ */
+static void checkAgainstGeneric(unsigned int channels, unsigned int impulse_len, unsigned int input_len,
+                                const simdsp::DirectConvolutionTiling *tiling,
+                                const simdsp::OutputMode &mode = simdsp::OutputMode()) {
+  unsigned int seed = channels * 7 + impulse_len * 3 + input_len;
+  std::vector<float> input = makeNoise((impulse_len - 1 + input_len) * channels, seed);
+  std::vector<float> impulse = makeNoise(impulse_len * channels, seed + 1);
+  // Outputs are added to, so start from something other than zero.
+  std::vector<float> expected(input_len * channels, 0.5f), output(input_len * channels, 0.5f);
+
+  float *cur = &input[(impulse_len - 1) * channels];
+  simdsp::genericBlockConvolver(cur, input_len, channels, &impulse[0], impulse_len, &expected[0], mode);
+  simdsp::tiledBlockConvolver(cur, input_len, channels, &impulse[0], impulse_len, &output[0], tiling, mode);
+
+  double max_err = 0.0;
+  for (size_t i = 0; i < output.size(); i++) {
+    max_err = fmax(max_err, fabs((double)expected[i] - (double)output[i]));
+  }
+  REQUIRE(max_err < 1e-5 * sqrt((double)impulse_len) + 1e-6);
+}
+
+TEST_CASE("default direct convolution tiles are sane", "[convolution]") {
+  for (unsigned int channels : {1u, 2u, 8u, 64u}) {
+    auto tiling = simdsp::getDefaultDirectConvolutionTiling(channels);
+    REQUIRE(tiling.tile_taps >= 16);
+    REQUIRE(tiling.tile_frames >= 16);
+  }
+}
+
+TEST_CASE("tiledBlockConvolver matches genericBlockConvolver", "[convolution]") {
+  simdsp::DirectConvolutionTiling small{37, 45};
+
+  for (unsigned int channels : {1u, 2u, 3u, 8u}) {
+    SECTION("default tiles, channels " + std::to_string(channels)) {
+      checkAgainstGeneric(channels, 1, 33, nullptr);
+      checkAgainstGeneric(channels, 1500, 257, nullptr);
+    }
+    SECTION("small tiles, channels " + std::to_string(channels)) {
+      checkAgainstGeneric(channels, 5, 3, &small);
+      checkAgainstGeneric(channels, 300, 129, &small);
+    }
+  }
+}
+
+TEST_CASE("tiledBlockConvolver output modes match genericBlockConvolver", "[convolution]") {
+  // Tap tiles smaller than a group of taps, which have to replace differently.
+  simdsp::DirectConvolutionTiling small{37, 45}, tiny{5, 16};
+  const simdsp::OutputMode modes[] = {
+      {false, 1.0f, 1.0f},
+      {true, 0.5f, 0.5f},
+      {false, 0.0f, 2.0f},
+      {true, 1.0f, 0.0f},
+  };
+
+  for (const auto &mode : modes) {
+    for (unsigned int channels : {1u, 2u, 3u, 8u}) {
+      checkAgainstGeneric(channels, 1500, 257, nullptr, mode);
+      checkAgainstGeneric(channels, 300, 129, &small, mode);
+      checkAgainstGeneric(channels, 300, 129, &tiny, mode);
+      checkAgainstGeneric(channels, 3, 33, &small, mode);
+    }
+  }
+}
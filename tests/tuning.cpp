@@ -0,0 +1,176 @@
+#include "test_common.hpp"
+
+#include "simdsp/convolution/non_uniform_partitioned_convolution.hpp"
+#include "simdsp/convolution/streaming_convolution.hpp"
+#include "simdsp/convolution/tuning.hpp"
+#include "simdsp/dispatch.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+static std::string getTuningTestPath(const char *name) {
+  return std::string(P_tmpdir) + "/simdsp_tuning_test_" + name;
+}
+
+static bool tuningsEqual(const simdsp::ConvolutionTuning &a, const simdsp::ConvolutionTuning &b) {
+  if (a.max_partition_size != b.max_partition_size) {
+    return false;
+  }
+  for (unsigned int i = 0; i < simdsp::CONVOLUTION_TUNING_CHANNEL_COUNTS; i++) {
+    if (a.tiled_min_impulse_len[i] != b.tiled_min_impulse_len[i]) {
+      return false;
+    }
+  }
+  for (unsigned int i = 0; i < simdsp::CONVOLUTION_TUNING_BLOCK_SIZES; i++) {
+    if (a.fft_min_impulse_len[i] != b.fft_min_impulse_len[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST_CASE("default convolution tuning is sane", "[convolution][tuning]") {
+  auto tuning = simdsp::getDefaultConvolutionTuning();
+
+  for (unsigned int i = 0; i < simdsp::CONVOLUTION_TUNING_CHANNEL_COUNTS; i++) {
+    REQUIRE(tuning.tiled_min_impulse_len[i] > 0);
+  }
+  REQUIRE(tuning.max_partition_size > 0);
+  REQUIRE((tuning.max_partition_size & (tuning.max_partition_size - 1)) == 0);
+
+  // Until something is set, the defaults are in effect.
+  REQUIRE(tuningsEqual(simdsp::getConvolutionTuning(), tuning));
+}
+
+TEST_CASE("FFT crossovers are looked up by block size", "[convolution][tuning]") {
+  simdsp::ConvolutionTuning tuning = simdsp::getDefaultConvolutionTuning();
+  for (unsigned int i = 0; i < simdsp::CONVOLUTION_TUNING_BLOCK_SIZES; i++) {
+    tuning.fft_min_impulse_len[i] = 1000 + i;
+  }
+
+  REQUIRE(simdsp::getFftCrossover(tuning, 1) == 1000);
+  REQUIRE(simdsp::getFftCrossover(tuning, 32) == 1000);
+  REQUIRE(simdsp::getFftCrossover(tuning, 48) == 1000);
+  REQUIRE(simdsp::getFftCrossover(tuning, 64) == 1001);
+  REQUIRE(simdsp::getFftCrossover(tuning, 2048) == 1006);
+  REQUIRE(simdsp::getFftCrossover(tuning, 65536) == 1006);
+}
+
+TEST_CASE("tiled crossovers are looked up by channel count", "[convolution][tuning]") {
+  simdsp::ConvolutionTuning tuning = simdsp::getDefaultConvolutionTuning();
+  for (unsigned int i = 0; i < simdsp::CONVOLUTION_TUNING_CHANNEL_COUNTS; i++) {
+    tuning.tiled_min_impulse_len[i] = 1000 + i;
+  }
+
+  REQUIRE(simdsp::getTiledCrossover(tuning, 1) == 1000);
+  REQUIRE(simdsp::getTiledCrossover(tuning, 2) == 1001);
+  REQUIRE(simdsp::getTiledCrossover(tuning, 3) == 1001);
+  REQUIRE(simdsp::getTiledCrossover(tuning, 4) == 1002);
+  REQUIRE(simdsp::getTiledCrossover(tuning, 8) == 1003);
+  REQUIRE(simdsp::getTiledCrossover(tuning, 32) == 1003);
+}
+
+TEST_CASE("convolution tuning survives a save and load", "[convolution][tuning]") {
+  std::string path = getTuningTestPath("roundtrip");
+
+  simdsp::ConvolutionTuning tuning = simdsp::getDefaultConvolutionTuning(), loaded{};
+  for (unsigned int i = 0; i < simdsp::CONVOLUTION_TUNING_CHANNEL_COUNTS; i++) {
+    tuning.tiled_min_impulse_len[i] = 1234 + i;
+  }
+  tuning.max_partition_size = 4096;
+  for (unsigned int i = 0; i < simdsp::CONVOLUTION_TUNING_BLOCK_SIZES; i++) {
+    tuning.fft_min_impulse_len[i] = 100 * i;
+  }
+
+  REQUIRE(simdsp::saveConvolutionTuning(path.c_str(), tuning));
+  REQUIRE(simdsp::loadConvolutionTuning(path.c_str(), &loaded));
+  REQUIRE(tuningsEqual(tuning, loaded));
+
+  remove(path.c_str());
+}
+
+TEST_CASE("convolution tuning from another machine or version is rejected", "[convolution][tuning]") {
+  std::string path = getTuningTestPath("rejected");
+  simdsp::ConvolutionTuning tuning = simdsp::getDefaultConvolutionTuning(), loaded = tuning;
+  loaded.max_partition_size = 1;
+
+  REQUIRE(simdsp::loadConvolutionTuning(path.c_str(), &loaded) == false);
+
+  REQUIRE(simdsp::saveConvolutionTuning(path.c_str(), tuning));
+  std::string contents;
+  {
+    FILE *f = fopen(path.c_str(), "r");
+    REQUIRE(f != nullptr);
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+      contents.push_back((char)c);
+    }
+    fclose(f);
+  }
+
+  auto rewrite = [&](const std::string &text) {
+    FILE *f = fopen(path.c_str(), "w");
+    REQUIRE(f != nullptr);
+    fputs(text.c_str(), f);
+    fclose(f);
+  };
+
+  SECTION("fingerprint") {
+    size_t pos = contents.find("fingerprint ") + sizeof("fingerprint ") - 1;
+    rewrite(contents.substr(0, pos) + "{}" + contents.substr(contents.find('\n', pos)));
+  }
+  SECTION("version") { rewrite("simdsp-convolution-tuning 999" + contents.substr(contents.find('\n'))); }
+  SECTION("truncated") { rewrite(contents.substr(0, contents.rfind("fft_min_impulse_len"))); }
+  SECTION("dispatch cap") {
+    // Timings taken under one cap are of different kernels than those another would run.
+    simdsp::DispatchVariant cap;
+    bool generic = simdsp::getMaxDispatchVariant(&cap) && cap == simdsp::DispatchVariant::GENERIC;
+    simdsp::setMaxDispatchVariant(generic ? simdsp::DispatchVariant::X86_AVX512F : simdsp::DispatchVariant::GENERIC);
+  }
+
+  bool ok = simdsp::loadConvolutionTuning(path.c_str(), &loaded);
+  simdsp::resetMaxDispatchVariant();
+  REQUIRE(ok == false);
+  REQUIRE(loaded.max_partition_size == 1);
+
+  remove(path.c_str());
+}
+
+TEST_CASE("the FFT crossover moves whole impulses into the direct head", "[convolution][tuning]") {
+  const unsigned int block_size = 32, impulse_len = 500, blocks = 40;
+  simdsp::ConvolutionTuning tuning = simdsp::getDefaultConvolutionTuning();
+
+  std::vector<float> impulse = makeNoise(impulse_len, 7), input = makeNoise(block_size * blocks, 8);
+
+  std::vector<float> with_tail(input.size(), 0.0f), direct(input.size(), 0.0f);
+  {
+    simdsp::NonUniformPartitionedConvolver conv(block_size, 1, &impulse[0], impulse_len);
+    REQUIRE(conv.getLayout().empty() == false);
+    for (unsigned int b = 0; b < blocks; b++) {
+      conv.process(&input[b * block_size], &with_tail[b * block_size]);
+    }
+  }
+
+  simdsp::ConvolutionTuning direct_tuning = tuning;
+  for (auto &x : direct_tuning.fft_min_impulse_len) {
+    x = UINT_MAX;
+  }
+  simdsp::setConvolutionTuning(direct_tuning);
+  {
+    simdsp::NonUniformPartitionedConvolver conv(block_size, 1, &impulse[0], impulse_len);
+    REQUIRE(conv.getLayout().empty());
+    for (unsigned int b = 0; b < blocks; b++) {
+      conv.process(&input[b * block_size], &direct[b * block_size]);
+    }
+  }
+  simdsp::setConvolutionTuning(tuning);
+
+  for (size_t i = 0; i < input.size(); i++) {
+    REQUIRE(fabs(with_tail[i] - direct[i]) < 1e-3);
+  }
+}
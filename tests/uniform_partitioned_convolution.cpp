@@ -0,0 +1,125 @@
+#include "test_common.hpp"
+
+#include "simdsp/convolution/uniform_partitioned_convolution.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <math.h>
+#include <random>
+#include <vector>
+
+/*
+ * Feed blocks of noise through the convolver and compare against a double precision direct convolution.
+ */
+static void checkAgainstDirect(unsigned int block_size, unsigned int channels, unsigned int impulse_len,
+                               unsigned int blocks) {
+  unsigned int seed = block_size * 31 + channels * 7 + impulse_len;
+  std::vector<float> impulse = makeNoise((size_t)impulse_len * channels, seed);
+  std::vector<float> input = makeNoise((size_t)block_size * blocks * channels, seed + 1);
+
+  simdsp::UniformPartitionedConvolver conv(block_size, channels, &impulse[0], impulse_len);
+  std::vector<float> output(input.size(), 0.0f);
+  for (unsigned int b = 0; b < blocks; b++) {
+    conv.process(&input[b * block_size * channels], &output[b * block_size * channels]);
+  }
+
+  auto expected = convolveDirect(input, impulse, impulse_len, channels, block_size * blocks);
+  REQUIRE(getMaxError(expected, output) < getConvolutionTolerance(impulse_len));
+}
+
+TEST_CASE("uniform partitioned convolver matches direct convolution", "[convolution][fft]") {
+  SECTION("impulse shorter than a block") { checkAgainstDirect(64, 1, 17, 6); }
+  SECTION("impulse an exact multiple of the block size") { checkAgainstDirect(32, 2, 128, 10); }
+  SECTION("many partitions, ragged end") { checkAgainstDirect(16, 1, 1000, 80); }
+  SECTION("stereo, larger blocks") { checkAgainstDirect(256, 2, 3000, 16); }
+  SECTION("smallest block size") { checkAgainstDirect(2, 3, 9, 20); }
+}
+
+TEST_CASE("uniform partitioned convolver reset clears history", "[convolution][fft]") {
+  std::vector<float> impulse(100, 0.5f), input(32, 1.0f), out1(32, 0.0f), out2(32, 0.0f);
+  simdsp::UniformPartitionedConvolver conv(32, 1, &impulse[0], 100);
+
+  conv.process(&input[0], &out1[0]);
+  conv.process(&input[0], &out2[0]);
+  conv.reset();
+  std::fill(out2.begin(), out2.end(), 0.0f);
+  conv.process(&input[0], &out2[0]);
+
+  for (unsigned int i = 0; i < 32; i++) {
+    REQUIRE(out2[i] == Approx(out1[i]).margin(1e-5));
+  }
+}
+
+TEST_CASE("uniform partitioned convolver crossfades impulse updates", "[convolution][fft]") {
+  const unsigned int block_size = 32, channels = 2, impulse_len = 70, blocks = 6, swap_block = 3;
+  std::vector<float> old_impulse = makeNoise(impulse_len * channels, 5), new_impulse = makeNoise(50 * channels, 6);
+  std::vector<float> input = makeNoise(block_size * blocks * channels, 7);
+
+  // References: one convolver which never changes, and one which always had the new impulse.
+  simdsp::UniformPartitionedConvolver swapping(block_size, channels, &old_impulse[0], impulse_len);
+  simdsp::UniformPartitionedConvolver old_ref(block_size, channels, &old_impulse[0], impulse_len);
+  simdsp::UniformPartitionedConvolver new_ref(block_size, channels, &new_impulse[0], 50);
+
+  std::vector<float> out(block_size * channels), out_old(block_size * channels), out_new(block_size * channels);
+  for (unsigned int b = 0; b < blocks; b++) {
+    std::fill(out.begin(), out.end(), 0.0f);
+    std::fill(out_old.begin(), out_old.end(), 0.0f);
+    std::fill(out_new.begin(), out_new.end(), 0.0f);
+
+    if (b == swap_block) {
+      swapping.setImpulse(&new_impulse[0], 50);
+    }
+
+    const float *in = &input[b * block_size * channels];
+    swapping.process(in, &out[0]);
+    old_ref.process(in, &out_old[0]);
+    new_ref.process(in, &out_new[0]);
+
+    for (unsigned int i = 0; i < block_size; i++) {
+      for (unsigned int ch = 0; ch < channels; ch++) {
+        float expected;
+        if (b < swap_block) {
+          expected = out_old[i * channels + ch];
+        } else if (b == swap_block) {
+          float gain = (float)(i + 1) / (float)block_size;
+          expected = out_old[i * channels + ch] * (1.0f - gain) + out_new[i * channels + ch] * gain;
+        } else {
+          expected = out_new[i * channels + ch];
+        }
+        REQUIRE(out[i * channels + ch] == Approx(expected).margin(1e-4));
+      }
+    }
+  }
+}
+
+TEST_CASE("uniform partitioned convolver output modes", "[convolution][fft]") {
+  const unsigned int block_size = 32, channels = 2, impulse_len = 70, blocks = 4;
+  std::vector<float> impulse = makeNoise(impulse_len * channels, 8), new_impulse = makeNoise(impulse_len * channels, 9);
+  std::vector<float> input = makeNoise(block_size * blocks * channels, 10);
+
+  // The last block also crossfades to a new impulse, which shares the output pass with the mode.
+  for (bool add : {false, true}) {
+    simdsp::UniformPartitionedConvolver reference(block_size, channels, &impulse[0], impulse_len);
+    simdsp::UniformPartitionedConvolver conv(block_size, channels, &impulse[0], impulse_len);
+    for (unsigned int b = 0; b < blocks; b++) {
+      if (b == blocks - 1) {
+        reference.setImpulse(&new_impulse[0], impulse_len);
+        conv.setImpulse(&new_impulse[0], impulse_len);
+      }
+
+      const float *in = &input[b * block_size * channels];
+      std::vector<float> plain(block_size * channels, 0.0f), output(block_size * channels, -0.5f);
+      float gain_start = 0.25f * b, gain_end = 1.0f - 0.1f * b;
+      reference.process(in, &plain[0]);
+      conv.process(in, &output[0], simdsp::OutputMode{add, gain_start, gain_end});
+
+      for (unsigned int i = 0; i < block_size; i++) {
+        double gain = gain_start + ((double)gain_end - gain_start) * (i + 1) / block_size;
+        for (unsigned int ch = 0; ch < channels; ch++) {
+          double expected = (add ? -0.5 : 0.0) + plain[i * channels + ch] * gain;
+          REQUIRE(output[i * channels + ch] == Approx(expected).margin(1e-4));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,32 @@
+#include <simdsp/convolution/tuning.hpp>
+
+#include <iostream>
+
+using std::cerr, std::cout, std::endl;
+
+/*
+ * Tune the convolution engines for this machine and save the result, for deployments which would rather not pay for
+ * tuning at startup.  Point initializeConvolutionTuning at the same path.
+ */
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    cerr << "Usage: " << argv[0] << " <output path>" << endl;
+    return 1;
+  }
+
+  auto tuning = simdsp::runConvolutionTuning();
+  if (!simdsp::saveConvolutionTuning(argv[1], tuning)) {
+    cerr << "Unable to write " << argv[1] << endl;
+    return 1;
+  }
+
+  for (unsigned int i = 0; i < simdsp::CONVOLUTION_TUNING_CHANNEL_COUNTS; i++) {
+    cout << "tiled_min_impulse_len " << (1u << i) << " " << tuning.tiled_min_impulse_len[i] << endl;
+  }
+  cout << "max_partition_size " << tuning.max_partition_size << endl;
+  for (unsigned int i = 0; i < simdsp::CONVOLUTION_TUNING_BLOCK_SIZES; i++) {
+    cout << "fft_min_impulse_len " << (simdsp::CONVOLUTION_TUNING_MIN_BLOCK_SIZE << i) << " "
+         << tuning.fft_min_impulse_len[i] << endl;
+  }
+  return 0;
+}